@@ -5,6 +5,8 @@
 #  FFTW3_INCLUDE_DIRS - the FFTW3 include directory
 #  FFTW3_LIBRARIES - Link these to use FFTW3
 #  FFTW3_DEFINITIONS - Compiler switches required for using FFTW3
+#  FFTW3F_FOUND - system has the single precision FFTW3 library
+#  FFTW3F_LIBRARIES - Link these to use the single precision FFTW3
 #
 #  Copyright (c) 2008 Nico Schlömer <nico.schloemer@gmx.net>
 #                     William Spinelli <wylliam@tiscali.it>
@@ -37,6 +39,16 @@ else (FFTW3_LIBRARIES AND FFTW3_INCLUDE_DIRS)
 			/sw/lib
 	)
 
+	find_library(FFTW3F_LIBRARY
+		NAMES
+			fftw3f
+		PATHS
+			/usr/lib
+			/usr/local/lib
+			/opt/local/lib
+			/sw/lib
+	)
+
 	set(FFTW3_INCLUDE_DIRS
 		${FFTW3_INCLUDE_DIR}
 	)
@@ -48,6 +60,14 @@ else (FFTW3_LIBRARIES AND FFTW3_INCLUDE_DIRS)
 		set(FFTW3_FOUND TRUE)
 	endif (FFTW3_INCLUDE_DIRS AND FFTW3_LIBRARIES)
 
+	# the single precision library is optional
+	if (FFTW3_INCLUDE_DIRS AND FFTW3F_LIBRARY)
+		set(FFTW3F_LIBRARIES
+			${FFTW3F_LIBRARY}
+		)
+		set(FFTW3F_FOUND TRUE)
+	endif (FFTW3_INCLUDE_DIRS AND FFTW3F_LIBRARY)
+
 	if (FFTW3_FOUND)
 		if (NOT Portaudio_FIND_QUIETLY)
 			message(STATUS "Found FFTW3: ${FFTW3_LIBRARIES}")
@@ -59,6 +79,6 @@ else (FFTW3_LIBRARIES AND FFTW3_INCLUDE_DIRS)
 	endif (FFTW3_FOUND)
 
 	# show the FFTW3_INCLUDE_DIRS and FFTW3_LIBRARIES variables only in the advanced view
-	mark_as_advanced(FFTW3_INCLUDE_DIRS FFTW3_LIBRARIES)
+	mark_as_advanced(FFTW3_INCLUDE_DIRS FFTW3_LIBRARIES FFTW3F_LIBRARIES)
 
 endif (FFTW3_LIBRARIES AND FFTW3_INCLUDE_DIRS)
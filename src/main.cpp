@@ -78,19 +78,39 @@ $ make</pre>
 */
 
 #include <QApplication>
+#include <QCommandLineParser>
+
+#include <iostream>
 
 #include "qpitch.h"
+#include "qsoundinputfactory.h"
 
 int main( int argc, char *argv[] )
 {
 	// ** CREATE QT APPLICATION ** //
 	QApplication app( argc, argv );
 
+	// ** PARSE THE COMMAND LINE ** //
+	// the sound input can be replaced to use the application without a sound card
+	QCommandLineParser parser;
+	parser.setApplicationDescription( "QPitch - Simple chromatic tuner" );
+	parser.addHelpOption( );
+	QSoundInputFactory::addOptions( parser );
+	parser.process( app );
+
+	// ** CREATE THE SOUND INPUT (NULL TO USE PORTAUDIO) ** //
+	QSoundInput* soundInput = NULL;
+	try {
+		soundInput = QSoundInputFactory::create( parser );
+	} catch ( QSoundInputException& e ) {
+		std::cerr << e.what( ) << "\n";
+		return 1;
+	}
+
 	// ** OPEN MAIN WINDOW ** //
-	QPitch* qpitch = new QPitch( );
+	QPitch* qpitch = new QPitch( soundInput );
 	qpitch->show( );
 
 	// ** GIVE CONTROL TO QT ** //
 	return app.exec( );
 }
-
@@ -0,0 +1,133 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+
+#include <iostream>
+
+#include "qpasoundinput.h"
+#include "qpitchbatch.h"
+#include "qpitchcli.h"
+#include "qpitchcore.h"
+#include "qsoundinputfactory.h"
+#include "qstreamsoundinput.h"
+
+int main( int argc, char *argv[] )
+{
+	// ** CREATE QT APPLICATION (NO GUI) ** //
+	QCoreApplication app( argc, argv );
+
+	// ** PARSE THE COMMAND LINE ** //
+	QCommandLineParser parser;
+	parser.setApplicationDescription( "QPitch - Simple chromatic tuner (command line version)\n"
+		"Write the estimated pitch to the standard output until the end of the audio stream." );
+	parser.addHelpOption( );
+	QCommandLineOption formatOption( "format", "Output <format>: json (JSON lines) or csv (default json).", "format", "json" );
+	QCommandLineOption sampleFrequencyOption( "sample-frequency", "Sample rate of the sound card (default 44100 Hz).", "Hz", "44100" );
+	QCommandLineOption frameSizeOption( "frame-size", "Size of the largest frame used to estimate the pitch (default 4096 samples).", "samples", "4096" );
+	QCommandLineOption fixedFrameOption( "fixed-frame", "Estimate every frame with the largest size, instead of choosing the size from the last pitch." );
+	QCommandLineOption hopSizeOption( "hop-size", "Number of new samples between two estimates (default 1024 samples).", "samples", "1024" );
+	QCommandLineOption peakEstimationOption( "peak-estimation", "Location of the autocorrelation peak: interpolation or zero-padding (default interpolation).",
+		"method", "interpolation" );
+	QCommandLineOption estimatorOption( "estimator", "Pitch detection algorithm: autocorrelation, yin or nsdf (default autocorrelation).",
+		"algorithm", "autocorrelation" );
+	QCommandLineOption channelsOption( "channels", "Number of input channels analysed independently (default 1).", "count", "1" );
+	QCommandLineOption lowestFrequencyOption( "lowest-frequency", "Lowest note frequency in the range [20, 40] Hz, lower notes are analysed at a decimated rate (default 40 Hz).",
+		"Hz", "40" );
+	QCommandLineOption fundamentalOption( "fundamental", "Frequency of the note A4 in the range [400, 480] Hz (default 440 Hz).", "Hz", "440" );
+	QCommandLineOption notationOption( "notation", "Tuning <notation>: us, french or german (default us).", "notation", "us" );
+	QCommandLineOption batchOption( "batch", "Analyse the WAV files (or the WAV files in the directories) given as arguments and write a report for each one." );
+	QCommandLineOption jobsOption( "jobs", "Number of files analysed concurrently in batch mode (default 0, one for each core).", "count", "0" );
+	parser.addOption( formatOption );
+	parser.addOption( sampleFrequencyOption );
+	parser.addOption( frameSizeOption );
+	parser.addOption( fixedFrameOption );
+	parser.addOption( hopSizeOption );
+	parser.addOption( peakEstimationOption );
+	parser.addOption( estimatorOption );
+	parser.addOption( channelsOption );
+	parser.addOption( lowestFrequencyOption );
+	parser.addOption( fundamentalOption );
+	parser.addOption( notationOption );
+	parser.addOption( batchOption );
+	parser.addOption( jobsOption );
+	parser.addPositionalArgument( "files", "Files or directories analysed in batch mode.", "[files...]" );
+	QSoundInputFactory::addOptions( parser );
+	parser.process( app );
+
+	// ** VALIDATE THE OPTIONS ** //
+	const int outputFormat = ( QStringList( ) << "json" << "csv" ).indexOf( parser.value( formatOption ) );
+	const int peakEstimation = ( QStringList( ) << "zero-padding" << "interpolation" ).indexOf( parser.value( peakEstimationOption ) );
+	const int pitchEstimator = ( QStringList( ) << "autocorrelation" << "yin" << "nsdf" ).indexOf( parser.value( estimatorOption ) );
+	const int tuningNotation = ( QStringList( ) << "us" << "french" << "german" ).indexOf( parser.value( notationOption ) );
+	const unsigned int sampleFrequency = parser.value( sampleFrequencyOption ).toUInt( );
+	const unsigned int fftFrameSize = parser.value( frameSizeOption ).toUInt( );
+	const unsigned int hopSize = parser.value( hopSizeOption ).toUInt( );
+	const unsigned int channelCount = parser.value( channelsOption ).toUInt( );
+	const double lowestFrequency = parser.value( lowestFrequencyOption ).toDouble( );
+	const double fundamentalFrequency = parser.value( fundamentalOption ).toDouble( );
+	if ( (outputFormat < 0) || (peakEstimation < 0) || (pitchEstimator < 0) || (tuningNotation < 0) || (sampleFrequency == 0) ||
+		(fftFrameSize < 1024) || (hopSize > fftFrameSize) || (channelCount == 0) || (lowestFrequency < QTuningScale::LOWEST_FREQUENCY) ||
+		(lowestFrequency > QTuningScale::MIN_FREQUENCY) || (fundamentalFrequency <= 400.0) || (fundamentalFrequency > 480.0) ) {
+		parser.showHelp( 1 );
+	}
+
+	// ** ANALYSE A BATCH OF FILES ON A THREAD POOL ** //
+	if ( parser.isSet( batchOption ) ) {
+		QPitchBatch batch( parser.positionalArguments( ), fftFrameSize, ! parser.isSet( fixedFrameOption ), hopSize, (QPitchCore::PeakEstimation) peakEstimation,
+			(QPitchCore::PitchEstimator) pitchEstimator, QTuningScale( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation, lowestFrequency ), (QPitchCli::OutputFormat) outputFormat );
+		return ( batch.run( parser.value( jobsOption ).toInt( ) ) == 0 ) ? 0 : 1;
+	}
+
+	// ** START THE ANALYSIS ** //
+	QPitchCore* hQPitchCore = NULL;
+	try {
+		QSoundInput* soundInput = QSoundInputFactory::create( parser );
+		if ( soundInput == NULL ) {
+			soundInput = new QPaSoundInput( );
+		}
+		hQPitchCore = new QPitchCore( soundInput );
+		hQPitchCore->setAdaptiveFrame( ! parser.isSet( fixedFrameOption ) );
+
+		// the application quits at the end of a file or of the standard input
+		QStreamSoundInput* streamInput = dynamic_cast<QStreamSoundInput*>( soundInput );
+		QPitchCli* qpitchCli = new QPitchCli( hQPitchCore, QTuningScale( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation, lowestFrequency ),
+			(QPitchCli::OutputFormat) outputFormat, channelCount, hQPitchCore );
+		if ( streamInput != NULL ) {
+			QObject::connect( streamInput, SIGNAL( finished() ),
+				qpitchCli, SLOT( stopStream() ) );
+		}
+
+		hQPitchCore->startStream( sampleFrequency, fftFrameSize, hopSize, (QPitchCore::PeakEstimation) peakEstimation,
+			(QPitchCore::PitchEstimator) pitchEstimator, channelCount, lowestFrequency );
+	} catch ( QSoundInputException& e ) {
+		std::cerr << e.what( ) << "\n";
+		return 1;
+	}
+
+	// ** GIVE CONTROL TO QT ** //
+	const int exitCode = app.exec( );
+	delete hQPitchCore;
+	return exitCode;
+}
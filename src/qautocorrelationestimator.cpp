@@ -0,0 +1,247 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qautocorrelationestimator.h"
+#include "qfftwplancache.h"
+
+#include <cmath>
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const int QAutoCorrelationEstimator::ZERO_PADDING_FACTOR		= 8;
+const int QAutoCorrelationEstimator::PEAK_REFINEMENT_STEPS		= 3;
+const int QAutoCorrelationEstimator::PEAK_REFINEMENT_CANDIDATES	= 4;
+const double QAutoCorrelationEstimator::PEAK_REFINEMENT_THRESHOLD	= 0.99;
+
+
+QAutoCorrelationEstimator::QAutoCorrelationEstimator( const unsigned int frameSize, const QPitchCore::PeakEstimation peakEstimation,
+	const double sampleFrequency ) :
+	QPitchEstimator( frameSize, (peakEstimation == QPitchCore::PEAK_ZERO_PADDING) ? ZERO_PADDING_FACTOR : 1, sampleFrequency )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_peakEstimation	= peakEstimation;
+	_powerSpectrum	= new qfftw_real[_fftw_in_time_size / 2 + 1];
+}
+
+
+QAutoCorrelationEstimator::~QAutoCorrelationEstimator( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[] _powerSpectrum;
+}
+
+
+double QAutoCorrelationEstimator::estimate( const qfftw_real* frame )
+{
+	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
+	Q_ASSERT( _fftw_plans		!= NULL );
+	Q_ASSERT( _fftw_in_time		!= NULL );
+	Q_ASSERT( _fftw_out_freq	!= NULL );
+
+	QPITCH_STAGE_BEGIN( );
+
+	// ** COMPUTE THE AUTOCORRELATION ** //
+	// compute the FFT of the input signal
+	fftw_frame( frame, _fftw_out_freq );
+	QPITCH_STAGE_END( STAGE_FFT );
+
+	/*
+	 * compute the transform of the autocorrelation given in time domain by
+	 *
+	 *        k=-N
+	 * r[t] = sum( x[k] * x[t-k] )
+	 *         N
+	 *
+	 * or in the frequency domain (for a real signal) by
+	 *
+	 * R[f] = X[f] * X[f]' = |X[f]|^2 = Re(X[f])^2 + Im(X[f])^2
+	 *
+	 * when computing the FFT with fftw_plan_dft_r2c_1d there are only N/2
+	 * significant samples so we only need to compute the |.|^2 for
+	 * _fftw_in_time_Size/2 samples
+	 */
+
+	// compute |.|^2 of the signal
+	for( unsigned int k = 0 ; k < (_fftw_in_time_size / 2 + 1) ; ++k ) {
+		_fftw_out_freq[k][0] = (_fftw_out_freq[k][0] * _fftw_out_freq[k][0]) + (_fftw_out_freq[k][1] * _fftw_out_freq[k][1]);
+		_fftw_out_freq[k][1] = 0.0;
+	}
+	QPITCH_STAGE_END( STAGE_POWER_SPECTRUM );
+
+	// pad the FFT with zeros to increase resolution
+	if ( _peakEstimation == QPitchCore::PEAK_ZERO_PADDING ) {
+		memset( &(_fftw_out_freq[_fftw_in_time_size/ 2 + 1][0]), 0, ( (_zeroPaddingFactor - 1) * _fftw_in_time_size + _fftw_in_time_size/ 2 - 1) * sizeof(qfftw_complex) );
+	} else {
+		// keep a copy of the power spectrum for the band-limited interpolation
+		for( unsigned int k = 0 ; k < (_fftw_in_time_size / 2 + 1) ; ++k ) {
+			_powerSpectrum[k] = _fftw_out_freq[k][0];
+		}
+	}
+	QPITCH_STAGE_END( STAGE_PADDING );
+
+	// compute the IFFT to obtain the autocorrelation in time domain
+	QFFTW( execute_dft_c2r )( _fftw_plans->ifft( ), _fftw_out_freq, _fftw_in_time );
+	QPITCH_STAGE_END( STAGE_IFFT );
+
+	// find the maximum of the autocorrelation (rejecting the first peak)
+	/*
+	 * the main problem with autocorrelation techniques is that a peak may also
+	 * occur at sub-harmonics or harmonics, but right now I can't come up with
+	 * anything better =(
+	 */
+	const unsigned int searchRange = (_zeroPaddingFactor * _fftw_in_time_size) / 2 + 1;
+
+	// search for a minimum in the autocorrelation to reject the peak centered around 0
+	unsigned int l;
+	for ( l = 0 ; (l < searchRange) && ( (_fftw_in_time[l+1] < _fftw_in_time[l]) || (_fftw_in_time[l+1] > 0.0) ) ; ++l ) {};
+	QPITCH_STAGE_END( STAGE_MINIMUM_SEARCH );
+
+	if ( _peakEstimation == QPitchCore::PEAK_ZERO_PADDING ) {
+		// search for the maximum
+		double 			maxAutoCorrelation			= 0.0;
+		unsigned int	maxAutoCorrelation_index	= 0;
+		for (  ; l < searchRange ; ++l ) {
+			if ( _fftw_in_time[l] > maxAutoCorrelation ) {
+				maxAutoCorrelation			= _fftw_in_time[l];
+				maxAutoCorrelation_index	= l;
+			}
+		}
+
+		QPITCH_STAGE_END( STAGE_MAXIMUM_SEARCH );
+
+		// no positive peak after the one centered around 0 means no periodicity
+		if ( maxAutoCorrelation_index == 0 ) {
+			return 0.0;
+		}
+
+		// compute the frequency of the maximum considering the padding factor
+		return ( _zeroPaddingFactor * _sampleFrequency / (double) maxAutoCorrelation_index );
+	}
+
+	/*
+	 * at native size the peaks are sampled too coarsely to compare their
+	 * heights, so the height of each local maximum is estimated with a
+	 * parabola through the three samples around it, then the highest peaks
+	 * are refined on the band-limited interpolation of the autocorrelation
+	 */
+	const unsigned int firstPeak = (l > 0) ? l : 1;
+
+	// search for the maximum of the interpolated peaks
+	double maxAutoCorrelation = 0.0;
+	for ( l = firstPeak ; l < searchRange ; ++l ) {
+		if ( (_fftw_in_time[l] > 0.0) && (_fftw_in_time[l] >= _fftw_in_time[l-1]) && (_fftw_in_time[l] > _fftw_in_time[l+1]) ) {
+			double curvature	= _fftw_in_time[l-1] - 2.0 * _fftw_in_time[l] + _fftw_in_time[l+1];
+			double offset		= 0.5 * (_fftw_in_time[l-1] - _fftw_in_time[l+1]) / curvature;
+			double height		= _fftw_in_time[l] - 0.25 * (_fftw_in_time[l-1] - _fftw_in_time[l+1]) * offset;
+			if ( height > maxAutoCorrelation ) {
+				maxAutoCorrelation = height;
+			}
+		}
+	}
+
+	// refine the peaks close to the maximum and select the highest one
+	double			maxRefinedAutoCorrelation	= 0.0;
+	double			maxRefinedAutoCorrelation_lag	= 0.0;
+	unsigned int	refinedPeaks				= 0;
+	for ( l = firstPeak ; (l < searchRange) && (refinedPeaks < (unsigned int) PEAK_REFINEMENT_CANDIDATES) ; ++l ) {
+		if ( (_fftw_in_time[l] > 0.0) && (_fftw_in_time[l] >= _fftw_in_time[l-1]) && (_fftw_in_time[l] > _fftw_in_time[l+1]) ) {
+			double curvature	= _fftw_in_time[l-1] - 2.0 * _fftw_in_time[l] + _fftw_in_time[l+1];
+			double offset		= 0.5 * (_fftw_in_time[l-1] - _fftw_in_time[l+1]) / curvature;
+			double height		= _fftw_in_time[l] - 0.25 * (_fftw_in_time[l-1] - _fftw_in_time[l+1]) * offset;
+			if ( height > PEAK_REFINEMENT_THRESHOLD * maxAutoCorrelation ) {
+				double refinedHeight;
+				double refinedLag = refineAutoCorrelationPeak( l + offset, refinedHeight );
+				if ( refinedHeight > maxRefinedAutoCorrelation ) {
+					maxRefinedAutoCorrelation		= refinedHeight;
+					maxRefinedAutoCorrelation_lag	= refinedLag;
+				}
+				++refinedPeaks;
+			}
+		}
+	}
+
+	QPITCH_STAGE_END( STAGE_MAXIMUM_SEARCH );
+
+	// no peak has been refined, so the frame does not show any periodicity
+	if ( maxRefinedAutoCorrelation_lag <= 0.0 ) {
+		return 0.0;
+	}
+
+	// compute the frequency of the maximum
+	return ( _sampleFrequency / maxRefinedAutoCorrelation_lag );
+}
+
+
+double QAutoCorrelationEstimator::refineAutoCorrelationPeak( double lag, double& height ) const
+{
+	// ** ENSURE THAT THE POWER SPECTRUM IS VALID ** //
+	Q_ASSERT( _powerSpectrum != NULL );
+
+	/*
+	 * the autocorrelation is the IFFT of the power spectrum, so its
+	 * band-limited interpolation at a fractional lag t is given by
+	 *
+	 *                  N/2
+	 * r(t) = P[0] + sum( w[k] * P[k] * cos(2*pi*k*t/N) )
+	 *                  k=1
+	 *
+	 * with w[k] = 2 (w[N/2] = 1); the first and second derivatives have
+	 * the same form and are used to find the maximum with Newton steps,
+	 * while cos(.) and sin(.) are computed with a rotation recurrence
+	 */
+	const unsigned int	halfSize	= _fftw_in_time_size / 2;
+	const double		omega		= 2.0 * M_PI / _fftw_in_time_size;
+
+	for ( int step = 0 ; step <= PEAK_REFINEMENT_STEPS ; ++step ) {
+		double cosStep = cos( omega * lag );
+		double sinStep = sin( omega * lag );
+		double cosK = 1.0;
+		double sinK = 0.0;
+
+		double value		= _powerSpectrum[0];
+		double derivative1	= 0.0;
+		double derivative2	= 0.0;
+		for ( unsigned int k = 1 ; k <= halfSize ; ++k ) {
+			// rotate to get cos(k * omega * lag) and sin(k * omega * lag)
+			double cosNext	= cosK * cosStep - sinK * sinStep;
+			sinK			= sinK * cosStep + cosK * sinStep;
+			cosK			= cosNext;
+
+			double weight	= ( (k == halfSize) ? 1.0 : 2.0 ) * _powerSpectrum[k];
+			value			+= weight * cosK;
+			derivative1		-= weight * k * sinK;
+			derivative2		-= weight * k * k * cosK;
+		}
+
+		// the last iteration only evaluates the height of the peak
+		height = value;
+		if ( (step == PEAK_REFINEMENT_STEPS) || (derivative2 >= 0.0) ) {
+			break;
+		}
+
+		// Newton step toward the zero of the first derivative (omega cancels out)
+		lag -= derivative1 / (omega * derivative2);
+	}
+
+	return lag;
+}
@@ -0,0 +1,89 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QAUTOCORRELATIONESTIMATOR_H_
+#define __QAUTOCORRELATIONESTIMATOR_H_
+
+#include "qpitchestimator.h"
+
+
+//! Pitch detection based on the first peak of the autocorrelation.
+/*!
+ * The autocorrelation of the frame is computed as the inverse FFT of
+ * the power spectral density of the signal (the squared module of the
+ * signal FFT) and the pitch is given by its first peak after the one
+ * centered around 0.
+ * Prior to the inverse transform the power spectrum is zero-padded to
+ * increase the resolution of the autocorrelation in order to have a
+ * better frequency identification.
+ * As an alternative the IFFT is computed at the native size of the
+ * frame and the peak is located with sub-sample accuracy by means of a
+ * parabolic interpolation refined on the band-limited (trigonometric)
+ * interpolation of the autocorrelation, which is the limit of an
+ * infinite zero-padding at a fraction of its cost.
+ */
+
+class QAutoCorrelationEstimator : public QPitchEstimator {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] frameSize the size of the frame used to compute the FFT
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 */
+	QAutoCorrelationEstimator( const unsigned int frameSize, const QPitchCore::PeakEstimation peakEstimation, const double sampleFrequency );
+
+	//! Default destructor.
+	virtual ~QAutoCorrelationEstimator( );
+
+	//! Estimate the pitch of the frame finding the first peak of the autocorrelation.
+	/*!
+	 * \param[in] frame the frameSize samples to analyse (read in place)
+	 * \return the frequency value corresponding to the maximum of the autocorrelation
+	 */
+	virtual double estimate( const qfftw_real* frame );
+
+
+private: /* static constants */
+	static const int	ZERO_PADDING_FACTOR;					//!< Number of times that the FFT is zero-padded to increase frequency resolution
+	static const int	PEAK_REFINEMENT_STEPS;					//!< Number of Newton steps used to refine an interpolated peak
+	static const int	PEAK_REFINEMENT_CANDIDATES;				//!< Maximum number of peaks refined to select the highest one
+	static const double	PEAK_REFINEMENT_THRESHOLD;				//!< Relative height above which a peak is a candidate for the refinement
+
+
+private: /* members */
+	QPitchCore::PeakEstimation	_peakEstimation;				//!< Method used to locate the peak of the autocorrelation
+	qfftw_real*			_powerSpectrum;							//!< Copy of the power spectrum used for the band-limited interpolation (the IFFT destroys its input)
+
+
+private: /* methods */
+	//! Refine the position of a peak of the autocorrelation using its band-limited interpolation.
+	/*!
+	 * \param[in] lag the initial estimate of the lag of the peak (in samples)
+	 * \param[out] height the value of the autocorrelation at the refined lag
+	 * \return the refined lag of the peak (in samples)
+	 */
+	double refineAutoCorrelationPeak( double lag, double& height ) const;
+};
+
+#endif /* __QAUTOCORRELATIONESTIMATOR_H_ */
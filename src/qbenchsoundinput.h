@@ -0,0 +1,71 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QBENCHSOUNDINPUT_H_
+#define __QBENCHSOUNDINPUT_H_
+
+#include "qsynthsoundinput.h"
+
+
+//! Synthesizer that terminates the stream after a given duration.
+/*!
+ * This class is used by the benchmark and by the regression suite to
+ * analyse a synthetic signal of a known length with QPitchCore::analyseStream.
+ */
+
+class QBenchSoundInput : public QSynthSoundInput {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] waveform the waveform to generate
+	 * \param[in] frequency the frequency of the waveform in Hz
+	 * \param[in] duration the duration of the stream (in seconds)
+	 */
+	QBenchSoundInput( const Waveform waveform, const double frequency, const double duration ) :
+		QSynthSoundInput( waveform, frequency ) {
+		_duration = duration;
+		_remainingSamples = 0;
+	};
+
+
+protected: /* methods */
+	//! Reset the phase of the waveform and the number of samples to generate.
+	virtual unsigned int openSource( const unsigned int sampleFrequency ) {
+		_remainingSamples = (unsigned int)( _duration * sampleFrequency );
+		return QSynthSoundInput::openSource( sampleFrequency );
+	};
+
+	//! Generate the next samples till the end of the stream.
+	virtual unsigned int readSource( short int* buffer, const unsigned int frameCount ) {
+		const unsigned int sampleCount = qMin( frameCount, _remainingSamples );
+		_remainingSamples -= sampleCount;
+		return (sampleCount > 0) ? QSynthSoundInput::readSource( buffer, sampleCount ) : 0;
+	};
+
+
+private: /* members */
+	double				_duration;							//!< Duration of the stream (in seconds)
+	unsigned int		_remainingSamples;					//!< Number of samples still to generate
+};
+
+#endif /* __QBENCHSOUNDINPUT_H_ */
@@ -0,0 +1,128 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qdecimator.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const unsigned int QDecimator::TAPS_PER_PHASE	= 24;
+const double QDecimator::CUTOFF_RATIO			= 0.8;
+const double QDecimator::KAISER_BETA			= 8.0;
+
+
+QDecimator::QDecimator( const unsigned int factor )
+{
+	// ** ENSURE THAT THE PARAMETERS ARE VALID ** //
+	Q_ASSERT( factor > 0 );
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_factor			= factor;
+	_length			= _factor * TAPS_PER_PHASE;
+	_taps			= new double[_length];
+	_delayLine		= new double[2 * _length];
+	reset( );
+
+	// ** DESIGN THE LOWPASS FILTER ** //
+	// windowed sinc with the cutoff expressed in cycles per input sample
+	const double cutoff = CUTOFF_RATIO * 0.5 / _factor;
+	const double center = 0.5 * (_length - 1);
+	double gain = 0.0;
+	for ( unsigned int n = 0 ; n < _length ; ++n ) {
+		const double t		= n - center;
+		const double sinc	= ( t == 0.0 ) ? 1.0 : sin( 2.0 * M_PI * cutoff * t ) / (2.0 * M_PI * cutoff * t);
+		const double r		= t / center;
+		_taps[n]			= 2.0 * cutoff * sinc * besselI0( KAISER_BETA * sqrt( qMax( 1.0 - r * r, 0.0 ) ) ) / besselI0( KAISER_BETA );
+		gain				+= _taps[n];
+	}
+
+	// normalize the gain at DC so that the level of the signal is not changed
+	for ( unsigned int n = 0 ; n < _length ; ++n ) {
+		_taps[n] /= gain;
+	}
+}
+
+
+QDecimator::~QDecimator( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[] _taps;
+	delete[] _delayLine;
+}
+
+
+void QDecimator::reset( )
+{
+	memset( _delayLine, 0, 2 * _length * sizeof( double ) );
+	_delayIndex	= 0;
+	_phase		= 0;
+}
+
+
+unsigned int QDecimator::process( const short int* input, const unsigned int sampleCount, short int* output )
+{
+	unsigned int outputCount = 0;
+
+	for ( unsigned int k = 0 ; k < sampleCount ; ++k ) {
+		// ** PUSH THE SAMPLE IN BOTH COPIES OF THE DELAY LINE ** //
+		_delayLine[_delayIndex]				= input[k];
+		_delayLine[_delayIndex + _length]	= input[k];
+		if ( ++_delayIndex == _length ) {
+			_delayIndex = 0;
+		}
+
+		// ** FILTER ONLY THE SAMPLES THAT ARE KEPT ** //
+		if ( ++_phase == _factor ) {
+			_phase = 0;
+
+			// the last L samples start at the oldest one and are contiguous in the second copy
+			const double* window = _delayLine + _delayIndex;
+			double y = 0.0;
+			for ( unsigned int n = 0 ; n < _length ; ++n ) {
+				y += _taps[n] * window[n];
+			}
+
+			// the ripple of the filter may exceed the range of a full scale input
+			output[outputCount++] = (short int) qBound( -32768.0, floor( y + 0.5 ), 32767.0 );
+		}
+	}
+
+	return outputCount;
+}
+
+
+double QDecimator::besselI0( const double x )
+{
+	// ** POWER SERIES, FAST CONVERGING FOR THE ARGUMENTS OF THE WINDOW ** //
+	double sum	= 1.0;
+	double term	= 1.0;
+	for ( unsigned int k = 1 ; term > 1e-12 * sum ; ++k ) {
+		term	*= (0.5 * x / k) * (0.5 * x / k);
+		sum		+= term;
+	}
+
+	return sum;
+}
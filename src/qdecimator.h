@@ -0,0 +1,106 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QDECIMATOR_H_
+#define __QDECIMATOR_H_
+
+
+//! Anti-aliased decimation of the audio stream.
+/*!
+ * The lowest notes (the low B of a 5-string bass, the low B flat of a
+ * contrabassoon) need a frame spanning a few periods of about 30
+ * milliseconds, which at the full rate of the sound card means long
+ * FFTs of mostly useless bandwidth. The decimator lowpass filters the
+ * stream and keeps one sample every D, so that the same frame size
+ * spans D times longer at D times less cost per second of audio.
+ * The lowpass filter is a linear-phase FIR (a sinc windowed by a
+ * Kaiser window) with TAPS_PER_PHASE taps for each of its D polyphase
+ * components, cut at CUTOFF_RATIO of the decimated bandwidth: the
+ * filter is evaluated only at the samples that are kept, thus its cost
+ * is TAPS_PER_PHASE multiply-accumulates for each input sample,
+ * whatever the decimation factor.
+ * The delay line is stored twice, so that the last L samples are
+ * always contiguous and the filter is a single dot product.
+ */
+
+class QDecimator {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] factor the decimation factor (D)
+	 */
+	QDecimator( const unsigned int factor );
+
+	//! Default destructor.
+	~QDecimator( );
+
+	//! Retrieve the decimation factor.
+	unsigned int factor( ) const { return _factor; };
+
+	//! Clear the delay line (e.g. after a discontinuity in the audio stream).
+	void reset( );
+
+	//! Filter and decimate a block of input samples.
+	/*!
+	 * The phase of the decimation is kept between two calls, thus the
+	 * output sample follows the last D input samples, wherever the
+	 * blocks are split.
+	 * \param[in] input the array with the input samples
+	 * \param[in] sampleCount the number of input samples
+	 * \param[out] output the array receiving the decimated samples (at least sampleCount / D + 1)
+	 * \return the number of decimated samples written to the output
+	 */
+	unsigned int process( const short int* input, const unsigned int sampleCount, short int* output );
+
+
+private: /* static constants */
+	static const unsigned int	TAPS_PER_PHASE;					//!< Number of taps of each polyphase component of the lowpass filter
+	static const double			CUTOFF_RATIO;					//!< Cutoff frequency of the lowpass filter relative to the decimated Nyquist frequency
+	static const double			KAISER_BETA;					//!< Shape parameter of the Kaiser window (about 80 dB of stopband attenuation)
+
+
+private: /* members */
+	unsigned int		_factor;								//!< Decimation factor (D)
+	unsigned int		_length;								//!< Number of taps of the lowpass filter (L = D * TAPS_PER_PHASE)
+	double*				_taps;									//!< Impulse response of the lowpass filter (linear phase, thus symmetric)
+	double*				_delayLine;								//!< Last L input samples, stored twice (2 * L samples)
+	unsigned int		_delayIndex;							//!< Index of the oldest sample in the delay line
+	unsigned int		_phase;									//!< Number of input samples received since the last output sample
+
+
+private: /* methods */
+	//! Compute the modified Bessel function of the first kind of order 0 used by the Kaiser window.
+	/*!
+	 * \param[in] x the argument of the function
+	 * \return the value of I0(x)
+	 */
+	static double besselI0( const double x );
+
+	//! Disabled copy constructor.
+	QDecimator( const QDecimator& );
+
+	//! Disabled assignment operator.
+	QDecimator& operator=( const QDecimator& );
+};
+
+#endif /* __QDECIMATOR_H_ */
@@ -0,0 +1,109 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qdifferenceestimator.h"
+#include "qfftwplancache.h"
+
+#include <cstring>
+
+
+QDifferenceEstimator::QDifferenceEstimator( const unsigned int frameSize, const double sampleFrequency ) :
+	QPitchEstimator( frameSize, 1, sampleFrequency )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_window_size		= _fftw_in_time_size / 2;
+	_fftw_window_freq	= (qfftw_complex*) QFFTW( malloc )( sizeof(qfftw_complex) * (_fftw_in_time_size / 2 + 1) );
+	_energy				= new double[_window_size];
+}
+
+
+QDifferenceEstimator::~QDifferenceEstimator( )
+{
+	// ** RELEASE RESOURCES ** //
+	QFFTW( free )( _fftw_window_freq );
+	delete[] _energy;
+}
+
+
+void QDifferenceEstimator::fftw_differenceTerms( const qfftw_real* frame )
+{
+	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
+	Q_ASSERT( _fftw_plans		!= NULL );
+	Q_ASSERT( _fftw_in_time		!= NULL );
+	Q_ASSERT( _fftw_out_freq	!= NULL );
+	Q_ASSERT( _fftw_window_freq	!= NULL );
+
+	QPITCH_STAGE_BEGIN( );
+
+	// ** COMPUTE THE FFT OF THE FRAME ** //
+	fftw_frame( frame, _fftw_out_freq );
+	QPITCH_STAGE_END( STAGE_FFT );
+
+	// ** COMPUTE THE ENERGY TERMS AND ZERO-PAD THE WINDOW ** //
+	// the samples are integers, so the running sum is exact in double precision
+	double windowEnergy = 0.0;
+	for ( unsigned int k = 0 ; k < _window_size ; ++k ) {
+		windowEnergy += (double) frame[k] * frame[k];
+	}
+
+	const double firstWindowEnergy = windowEnergy;
+	for ( unsigned int t = 0 ; t < _window_size ; ++t ) {
+		_energy[t] = firstWindowEnergy + windowEnergy;
+		windowEnergy += (double) frame[t + _window_size] * frame[t + _window_size] - (double) frame[t] * frame[t];
+	}
+
+	// the frame belongs to the caller, so the window is zero-padded in the time domain buffer
+	memcpy( _fftw_in_time, frame, _window_size * sizeof( qfftw_real ) );
+	memset( _fftw_in_time + _window_size, 0, (_fftw_in_time_size - _window_size) * sizeof( qfftw_real ) );
+	QPITCH_STAGE_END( STAGE_PADDING );
+
+	QFFTW( execute_dft_r2c )( _fftw_plans->fft( ), _fftw_in_time, _fftw_window_freq );
+	QPITCH_STAGE_END( STAGE_FFT );
+
+	// ** COMPUTE THE CORRELATION OF THE WINDOW WITH THE FRAME ** //
+	// the transform of the correlation is the cross spectrum W[f]' * X[f]
+	for ( unsigned int k = 0 ; k < (_fftw_in_time_size / 2 + 1) ; ++k ) {
+		const qfftw_real re = _fftw_window_freq[k][0] * _fftw_out_freq[k][0] + _fftw_window_freq[k][1] * _fftw_out_freq[k][1];
+		const qfftw_real im = _fftw_window_freq[k][0] * _fftw_out_freq[k][1] - _fftw_window_freq[k][1] * _fftw_out_freq[k][0];
+		_fftw_out_freq[k][0] = re;
+		_fftw_out_freq[k][1] = im;
+	}
+	QPITCH_STAGE_END( STAGE_POWER_SPECTRUM );
+
+	QFFTW( execute_dft_c2r )( _fftw_plans->ifft( ), _fftw_out_freq, _fftw_in_time );
+	QPITCH_STAGE_END( STAGE_IFFT );
+}
+
+
+double QDifferenceEstimator::parabolicPeak( const qfftw_real* function, const unsigned int index, double& height )
+{
+	const double curvature	= function[index-1] - 2.0 * function[index] + function[index+1];
+	if ( curvature >= 0.0 ) {
+		// flat (or not a maximum): keep the sample
+		height = function[index];
+		return index;
+	}
+
+	const double offset		= 0.5 * (function[index-1] - function[index+1]) / curvature;
+	height					= function[index] - 0.25 * (function[index-1] - function[index+1]) * offset;
+	return index + offset;
+}
@@ -0,0 +1,86 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QDIFFERENCEESTIMATOR_H_
+#define __QDIFFERENCEESTIMATOR_H_
+
+#include "qpitchestimator.h"
+
+
+//! Base class of the pitch detection algorithms based on the difference function.
+/*!
+ * The difference function of a frame of N samples is computed on a
+ * window of W = N/2 samples for all the lags in the range [0, W)
+ *
+ *          W-1                      W-1                W-1
+ * d[t] = sum( (x[j] - x[j+t])^2 ) = sum( x[j]^2 ) + sum( x[j+t]^2 ) - 2 * r[t] = m[t] - 2 * r[t]
+ *          j=0                      j=0                j=0
+ *
+ * where the energy term m[t] is updated with a running sum, while the
+ * correlation r[t] of the window with the whole frame is computed as the
+ * IFFT of the cross spectrum of the frame and of the window zero-padded
+ * to N samples (the circular correlation does not wrap for t < W).
+ * Thus the YIN and the McLeod (NSDF) estimators cost two forward FFTs
+ * and one IFFT at the native size of the frame, using the same plans of
+ * the autocorrelation.
+ */
+
+class QDifferenceEstimator : public QPitchEstimator {
+
+public: /* methods */
+	//! Default destructor.
+	virtual ~QDifferenceEstimator( );
+
+
+protected: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] frameSize the size of the frame used to compute the FFT
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 */
+	QDifferenceEstimator( const unsigned int frameSize, const double sampleFrequency );
+
+	//! Compute the terms of the difference function of a frame.
+	/*!
+	 * On return the time domain buffer holds the correlation r[t] (not yet
+	 * divided by the frame size) and _energy holds m[t], for t in [0, W).
+	 * \param[in] frame the frameSize samples of the frame (read in place)
+	 */
+	void fftw_differenceTerms( const qfftw_real* frame );
+
+	//! Locate a peak of a sampled function with a parabola through the three samples around it.
+	/*!
+	 * \param[in] function the sampled function
+	 * \param[in] index the index of the local maximum (function[index-1] and function[index+1] must exist)
+	 * \param[out] height the value of the parabola at its vertex
+	 * \return the position of the vertex (in samples)
+	 */
+	static double parabolicPeak( const qfftw_real* function, const unsigned int index, double& height );
+
+
+protected: /* members */
+	unsigned int		_window_size;							//!< Size of the window used by the difference function (and number of lags)
+	qfftw_complex*		_fftw_window_freq;						//!< Buffer used to store the FFT of the zero-padded window
+	double*				_energy;								//!< Energy term m[t] of the difference function
+};
+
+#endif /* __QDIFFERENCEESTIMATOR_H_ */
@@ -0,0 +1,58 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QFFTW_H_
+#define __QFFTW_H_
+
+#include <fftw3.h>
+
+/*
+ * Precision of the FFTW interface used by the pitch detection.
+ * The input samples are 16 bit integers, so the single precision of
+ * fftwf is more than enough for the analysis and it halves the memory
+ * traffic while doubling the width of the SIMD kernels of FFTW.
+ * The precision is selected at build time defining QPITCH_FFTW_FLOAT
+ * (the QPITCH_FFTW_FLOAT option of cmake), which links against fftw3f
+ * instead of fftw3; all the code uses the definitions below, so that
+ * both the buffers and the plans always share the same precision.
+ */
+
+#ifdef QPITCH_FFTW_FLOAT
+//! Mangle an FFTW identifier to the selected precision.
+#define QFFTW( name )			fftwf_ ## name
+//! Name of the file used to store the accumulated wisdom.
+#define QFFTW_WISDOM_FILENAME	"qpitchf.wisdom"
+
+typedef float					qfftw_real;				//!< Real type of the samples in the time domain
+#else
+//! Mangle an FFTW identifier to the selected precision.
+#define QFFTW( name )			fftw_ ## name
+//! Name of the file used to store the accumulated wisdom.
+#define QFFTW_WISDOM_FILENAME	"qpitch.wisdom"
+
+typedef double					qfftw_real;				//!< Real type of the samples in the time domain
+#endif
+
+typedef QFFTW( complex )		qfftw_complex;			//!< Complex type of the samples in the frequency domain
+typedef QFFTW( plan )			qfftw_plan;				//!< Plan of a transform
+
+#endif /* __QFFTW_H_ */
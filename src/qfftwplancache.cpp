@@ -0,0 +1,242 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qfftwplancache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSettings>
+#include <QtDebug>
+#include <QWaitCondition>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const unsigned int QFftwPlanCache::MEASURE_FLAGS = FFTW_MEASURE;
+
+
+QFftwPlanCache* QFftwPlanCache::instance( )
+{
+	// ** CREATE THE CACHE THE FIRST TIME IT IS USED ** //
+	static QFftwPlanCache cache;
+	return &cache;
+}
+
+
+QFftwPlanCache::QFftwPlanCache( ) : QThread( )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_mutex			= new QMutex( );
+	_plannerMutex	= new QMutex( );
+	_waitCond		= new QWaitCondition( );
+	_measuredCond	= new QWaitCondition( );
+	_createdCond	= new QWaitCondition( );
+	_measuring		= false;
+
+	// ** LOAD THE WISDOM STORED ALONG WITH THE APPLICATION SETTINGS ** //
+	QSettings settings( "QPitch", "QPitch" );
+	_wisdomFileName = QFileInfo( settings.fileName( ) ).absolutePath( ) + "/" QFFTW_WISDOM_FILENAME;
+	if ( QFFTW( import_wisdom_from_filename )( QFile::encodeName( _wisdomFileName ).constData( ) ) ) {
+		qDebug( ) << "QFftwPlanCache: wisdom loaded from" << _wisdomFileName;
+	}
+
+	// ** START THE MEASUREMENT THREAD ** //
+	_running = true;
+	this->start( QThread::LowPriority );
+}
+
+
+QFftwPlanCache::~QFftwPlanCache( )
+{
+	// ** STOP THE THREAD ** //
+	_mutex->lock( );
+	_running = false;
+	_waitCond->wakeOne( );
+	_mutex->unlock( );
+	this->wait( );
+
+	// ** DESTROY ALL THE PLANS ** //
+	for ( QHash<quint64, QFftwPlans*>::const_iterator it = _plans.constBegin( ) ; it != _plans.constEnd( ) ; ++it ) {
+		QFFTW( destroy_plan )( it.value( )->fft( ) );
+		QFFTW( destroy_plan )( it.value( )->fftUnaligned( ) );
+		QFFTW( destroy_plan )( it.value( )->ifft( ) );
+		delete it.value( );
+	}
+	for ( int k = 0 ; k < _retiredPlans.size( ) ; ++k ) {
+		QFFTW( destroy_plan )( _retiredPlans[k] );
+	}
+
+	// ** RELEASE RESOURCES ** //
+	delete _mutex;
+	delete _plannerMutex;
+	delete _waitCond;
+	delete _measuredCond;
+	delete _createdCond;
+}
+
+
+const QFftwPlans* QFftwPlanCache::plans( const unsigned int frameSize, const unsigned int zeroPaddingFactor )
+{
+	QMutexLocker locker( _mutex );
+
+	// ** LOOK FOR PLANS ALREADY AVAILABLE ** //
+	// the plans of a size requested by another thread are used as soon as that thread has created them
+	const quint64 key = ( (quint64) frameSize << 32 ) | zeroPaddingFactor;
+	QFftwPlans* plans = _plans.value( key, NULL );
+	if ( plans != NULL ) {
+		while ( plans->fft( ) == NULL ) {
+			_createdCond->wait( _mutex );
+		}
+		return plans;
+	}
+
+	// ** CREATE NEW PLANS ** //
+	// the entry is inserted before the planning, which is done without holding the mutex:
+	// the planner may be busy with a measurement for a long time, and the other sizes must
+	// still be retrieved from the cache meanwhile
+	plans						= new QFftwPlans( );
+	plans->_frameSize			= frameSize;
+	plans->_zeroPaddingFactor	= zeroPaddingFactor;
+	_plans.insert( key, plans );
+	locker.unlock( );
+
+	// use the stored wisdom if it is available, otherwise estimate and request a measurement
+	qfftw_plan fft;
+	qfftw_plan fftUnaligned;
+	qfftw_plan ifft;
+	createPlans( frameSize, zeroPaddingFactor, MEASURE_FLAGS | FFTW_WISDOM_ONLY, fft, fftUnaligned, ifft );
+	const bool measure = (fft == NULL) || (fftUnaligned == NULL) || (ifft == NULL);
+	qfftw_plan wisdomFft = fft;
+	qfftw_plan wisdomFftUnaligned = fftUnaligned;
+	qfftw_plan wisdomIfft = ifft;
+	if ( measure ) {
+		createPlans( frameSize, zeroPaddingFactor, FFTW_ESTIMATE, fft, fftUnaligned, ifft );
+	}
+
+	// ** PUBLISH THE PLANS ** //
+	locker.relock( );
+	if ( measure ) {
+		if ( wisdomFft != NULL ) {
+			_retiredPlans.append( wisdomFft );
+		}
+		if ( wisdomFftUnaligned != NULL ) {
+			_retiredPlans.append( wisdomFftUnaligned );
+		}
+		if ( wisdomIfft != NULL ) {
+			_retiredPlans.append( wisdomIfft );
+		}
+		_pendingPlans.append( plans );
+		_waitCond->wakeOne( );
+	}
+	plans->_ifft.storeRelease( ifft );
+	plans->_fftUnaligned.storeRelease( fftUnaligned );
+	plans->_fft.storeRelease( fft );
+	_createdCond->wakeAll( );
+
+	return plans;
+}
+
+
+void QFftwPlanCache::waitForMeasuredPlans( )
+{
+	QMutexLocker locker( _mutex );
+
+	// ** WAIT TILL THE QUEUE IS EMPTY AND THE LAST PLAN HAS BEEN REPLACED ** //
+	while ( _measuring || ! _pendingPlans.isEmpty( ) ) {
+		_measuredCond->wait( _mutex );
+	}
+}
+
+
+void QFftwPlanCache::run( )
+{
+	forever {
+		// ** WAIT FOR A PLAN TO MEASURE ** //
+		_mutex->lock( );
+		while ( (_running == true) && _pendingPlans.isEmpty( ) ) {
+			_waitCond->wait( _mutex );
+		}
+		if ( _running == false ) {
+			_mutex->unlock( );
+			return;
+		}
+		QFftwPlans* plans = _pendingPlans.takeFirst( );
+		_measuring = true;
+		_mutex->unlock( );
+
+		// ** MEASURE THE PLANS ** //
+		// this may take a while, but the planner is locked only for one plan at a time
+		qfftw_plan fft;
+		qfftw_plan fftUnaligned;
+		qfftw_plan ifft;
+		createPlans( plans->frameSize( ), plans->zeroPaddingFactor( ), MEASURE_FLAGS, fft, fftUnaligned, ifft );
+
+		// ** REPLACE THE ESTIMATED PLANS ** //
+		// the old plans may be in use by another thread, so they are destroyed only at exit
+		_mutex->lock( );
+		_retiredPlans.append( plans->_fft.fetchAndStoreOrdered( fft ) );
+		_retiredPlans.append( plans->_fftUnaligned.fetchAndStoreOrdered( fftUnaligned ) );
+		_retiredPlans.append( plans->_ifft.fetchAndStoreOrdered( ifft ) );
+		_measuring = false;
+		_measuredCond->wakeAll( );
+		_mutex->unlock( );
+
+		// ** STORE THE WISDOM FOR THE NEXT RUN ** //
+		_plannerMutex->lock( );
+		QDir( ).mkpath( QFileInfo( _wisdomFileName ).absolutePath( ) );
+		if ( ! QFFTW( export_wisdom_to_filename )( QFile::encodeName( _wisdomFileName ).constData( ) ) ) {
+			qWarning( ) << "QFftwPlanCache: cannot store the wisdom in" << _wisdomFileName;
+		}
+		_plannerMutex->unlock( );
+
+		qDebug( ) << "QFftwPlanCache: measured plans for frameSize =" << plans->frameSize( )
+			<< "zeroPaddingFactor =" << plans->zeroPaddingFactor( );
+	}
+}
+
+
+void QFftwPlanCache::createPlans( const unsigned int frameSize, const unsigned int zeroPaddingFactor, const unsigned int flags,
+	qfftw_plan& fft, qfftw_plan& fftUnaligned, qfftw_plan& ifft )
+{
+	// ** ALLOCATE SCRATCH ARRAYS ** //
+	// the planner may overwrite the arrays, so the buffers of the working threads cannot be used
+	qfftw_real*		in_time		= (qfftw_real*) QFFTW( malloc )( zeroPaddingFactor * sizeof(qfftw_real) * frameSize );
+	qfftw_complex*	out_freq	= (qfftw_complex*) QFFTW( malloc )( zeroPaddingFactor * sizeof(qfftw_complex) * frameSize );
+
+	// ** CREATE THE PLANS ** //
+	_plannerMutex->lock( );
+	fft = QFFTW( plan_dft_r2c_1d )( frameSize, in_time, out_freq, flags );									// FFT
+	_plannerMutex->unlock( );
+
+	_plannerMutex->lock( );
+	fftUnaligned = QFFTW( plan_dft_r2c_1d )( frameSize, in_time, out_freq, flags | FFTW_UNALIGNED );			// FFT of a frame read in place
+	_plannerMutex->unlock( );
+
+	_plannerMutex->lock( );
+	ifft = QFFTW( plan_dft_c2r_1d )( zeroPaddingFactor * frameSize, out_freq, in_time, flags );				// IFFT (zero-padded if required)
+	_plannerMutex->unlock( );
+
+	// ** RELEASE SCRATCH ARRAYS ** //
+	QFFTW( free )( in_time );
+	QFFTW( free )( out_freq );
+}
@@ -0,0 +1,159 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QFFTWPLANCACHE_H_
+#define __QFFTWPLANCACHE_H_
+
+#include "qfftw.h"
+
+#include <QAtomicPointer>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QThread>
+
+class QMutex;
+class QWaitCondition;
+
+
+//! Plans used to compute the autocorrelation of a frame of a given size.
+/*!
+ * The plans are created on scratch arrays and must be executed with the
+ * new-array execute functions (fftw_execute_dft_r2c and
+ * fftw_execute_dft_c2r, or their fftwf counterparts in single precision)
+ * on arrays allocated with fftw_malloc.
+ * The FFT is also planned with FFTW_UNALIGNED, so that it can read a
+ * frame in place at any offset of a larger buffer (e.g. the sliding
+ * window of the analysis): such a frame does not have the alignment of
+ * fftw_malloc, which the SIMD kernels of the other plan rely on.
+ * The pointers may be replaced at any time by better (measured) plans,
+ * so they have to be read each time before the execution; the old plans
+ * are kept alive till the end of the process.
+ */
+class QFftwPlans {
+	friend class QFftwPlanCache;
+
+public: /* methods */
+	//! Plan of the real-to-complex FFT of frameSize samples.
+	qfftw_plan fft( ) const { return _fft.loadAcquire( ); };
+
+	//! Plan of the real-to-complex FFT of frameSize samples, for an input without the alignment of fftw_malloc.
+	qfftw_plan fftUnaligned( ) const { return _fftUnaligned.loadAcquire( ); };
+
+	//! Plan of the complex-to-real IFFT of zeroPaddingFactor * frameSize samples.
+	qfftw_plan ifft( ) const { return _ifft.loadAcquire( ); };
+
+	//! Size of the frame.
+	unsigned int frameSize( ) const { return _frameSize; };
+
+	//! Number of times that the IFFT is zero-padded.
+	unsigned int zeroPaddingFactor( ) const { return _zeroPaddingFactor; };
+
+
+private: /* members */
+	unsigned int						_frameSize;				//!< Size of the frame (size of the FFT)
+	unsigned int						_zeroPaddingFactor;		//!< Zero-padding factor of the IFFT
+	QAtomicPointer<QFFTW( plan_s )>		_fft;					//!< Current plan of the FFT
+	QAtomicPointer<QFFTW( plan_s )>		_fftUnaligned;			//!< Current plan of the FFT of an unaligned input
+	QAtomicPointer<QFFTW( plan_s )>		_ifft;					//!< Current plan of the IFFT
+};
+
+
+//! Process-wide cache of the FFTW plans.
+/*!
+ * This class keeps the plans used by the pitch detection for the whole
+ * lifetime of the process, indexed by frame size and zero-padding factor,
+ * so that a restart of the audio stream does not require a new planning.
+ * When a new size is requested a plan is immediately obtained from the
+ * stored wisdom or, if none is available, with FFTW_ESTIMATE; in the
+ * latter case a better plan is computed with FFTW_MEASURE by a low
+ * priority thread and replaces the first one as soon as it is ready.
+ * The accumulated wisdom is saved in the directory of the application
+ * settings and loaded at startup, so the measurement is paid only once.
+ * The FFTW planner is not thread-safe, thus all the calls to the planner
+ * are serialized by this class.
+ */
+
+class QFftwPlanCache : public QThread {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Retrieve the unique instance of the cache.
+	static QFftwPlanCache* instance( );
+
+	//! Default destructor.
+	~QFftwPlanCache( );
+
+	//! Retrieve the plans for a given frame.
+	/*!
+	 * \param[in] frameSize the size of the frame (size of the FFT)
+	 * \param[in] zeroPaddingFactor the number of times that the IFFT is zero-padded
+	 * \return the plans (owned by the cache)
+	 */
+	const QFftwPlans* plans( const unsigned int frameSize, const unsigned int zeroPaddingFactor );
+
+	//! Wait till all the requested plans have been measured (used to benchmark the measured plans).
+	void waitForMeasuredPlans( );
+
+
+protected:
+	//! Main loop of the thread used to measure the plans.
+	virtual void run( );
+
+
+private: /* static constants */
+	static const unsigned int	MEASURE_FLAGS;						//!< Planner flags used in the background (FFTW_PATIENT may be used for an even better plan)
+
+
+private: /* members */
+	QHash<quint64, QFftwPlans*>	_plans;								//!< Plans indexed by frame size and zero-padding factor
+	QList<QFftwPlans*>			_pendingPlans;						//!< Plans waiting for the measurement
+	QList<qfftw_plan>			_retiredPlans;						//!< Plans replaced by measured ones (still in use by other threads)
+	QString						_wisdomFileName;					//!< File used to store the accumulated wisdom
+	bool						_running;							//!< True when the thread is running
+	bool						_measuring;							//!< True while a plan is being measured
+	QMutex*						_mutex;								//!< Mutex protecting the cache and the queue
+	QMutex*						_plannerMutex;						//!< Mutex serializing the calls to the FFTW planner
+	QWaitCondition*				_waitCond;							//!< Wait condition used to wake up the thread when a plan must be measured
+	QWaitCondition*				_measuredCond;						//!< Wait condition used to signal that the pending plans have been measured
+	QWaitCondition*				_createdCond;						//!< Wait condition used to signal that the plans of a new size have been created
+
+
+private: /* methods */
+	//! Default constructor (use instance to retrieve the cache).
+	QFftwPlanCache( );
+
+	//! Create the plans of a frame using scratch arrays.
+	/*!
+	 * \param[in] frameSize the size of the frame (size of the FFT)
+	 * \param[in] zeroPaddingFactor the number of times that the IFFT is zero-padded
+	 * \param[in] flags the planner flags
+	 * \param[out] fft the plan of the FFT (NULL if it cannot be created with the given flags)
+	 * \param[out] fftUnaligned the plan of the FFT of an unaligned input (NULL if it cannot be created with the given flags)
+	 * \param[out] ifft the plan of the IFFT (NULL if it cannot be created with the given flags)
+	 */
+	void createPlans( const unsigned int frameSize, const unsigned int zeroPaddingFactor, const unsigned int flags,
+		qfftw_plan& fft, qfftw_plan& fftUnaligned, qfftw_plan& ifft );
+};
+
+#endif /* __QFFTWPLANCACHE_H_ */
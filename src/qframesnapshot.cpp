@@ -0,0 +1,123 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qframesnapshot.h"
+
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const int QFrameSnapshotPool::POOL_SIZE = 8;
+
+
+QFrameSnapshot::QFrameSnapshot( const unsigned int plotData_size ) : QSharedData( )
+{
+	// ** ENSURE THAT THE SIZE IS VALID ** //
+	Q_ASSERT( plotData_size > 0 );
+
+	// ** INITIALIZE BUFFERS ** //
+	_plotData_size			= plotData_size;
+	_columnCount			= plotData_size;
+	_autoCorrColumnCount	= plotData_size;
+	_plotSampleMinimum		= new qfftw_real[_plotData_size];
+	_plotSampleMaximum		= new qfftw_real[_plotData_size];
+	_plotAutoCorrMinimum	= new qfftw_real[_plotData_size];
+	_plotAutoCorrMaximum	= new qfftw_real[_plotData_size];
+	memset( _plotSampleMinimum, 0, sizeof( qfftw_real ) * _plotData_size );
+	memset( _plotSampleMaximum, 0, sizeof( qfftw_real ) * _plotData_size );
+	memset( _plotAutoCorrMinimum, 0, sizeof( qfftw_real ) * _plotData_size );
+	memset( _plotAutoCorrMaximum, 0, sizeof( qfftw_real ) * _plotData_size );
+
+	_hasAutoCorr		= false;
+	_timeRange			= 1.0;							// dummy value to avoid division by 0
+	_streamTime			= 0.0;
+	_estimatedFrequency	= 0.0;
+}
+
+
+QFrameSnapshot::~QFrameSnapshot( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[]	_plotSampleMinimum;
+	delete[]	_plotSampleMaximum;
+	delete[]	_plotAutoCorrMinimum;
+	delete[]	_plotAutoCorrMaximum;
+}
+
+
+void QFrameSnapshot::setSize( const unsigned int columnCount )
+{
+	// ** ENSURE THAT THE SIZE IS VALID ** //
+	Q_ASSERT( (columnCount > 0) && (columnCount <= _plotData_size) );
+
+	_columnCount			= columnCount;
+	_autoCorrColumnCount	= columnCount;
+}
+
+
+void QFrameSnapshot::setAutoCorrSize( const unsigned int columnCount )
+{
+	// ** ENSURE THAT THE SIZE IS VALID ** //
+	Q_ASSERT( (columnCount > 0) && (columnCount <= _columnCount) );
+
+	_autoCorrColumnCount = columnCount;
+}
+
+
+void QFrameSnapshot::setEstimate( const double streamTime, const double estimatedFrequency, const bool hasAutoCorr )
+{
+	_streamTime			= streamTime;
+	_estimatedFrequency	= estimatedFrequency;
+	_hasAutoCorr		= hasAutoCorr;
+}
+
+
+QFrameSnapshotPool::QFrameSnapshotPool( const unsigned int plotData_size )
+{
+	// ** PREALLOCATE THE SNAPSHOTS ** //
+	for ( int s = 0 ; s < POOL_SIZE ; ++s ) {
+		_snapshots.append( QExplicitlySharedDataPointer<QFrameSnapshot>( new QFrameSnapshot( plotData_size ) ) );
+	}
+	_nextSnapshot = 0;
+}
+
+
+QFrameSnapshotPool::~QFrameSnapshotPool( )
+{
+	// the references of the pool are released with the vector, so the snapshots still held outlive it
+}
+
+
+QFrameSnapshot* QFrameSnapshotPool::acquire( )
+{
+	// ** LOOK FOR A SNAPSHOT HELD ONLY BY THE POOL ** //
+	// (the acquire load orders the last reads of the reader that released it before the new writes)
+	for ( int s = 0 ; s < POOL_SIZE ; ++s ) {
+		QFrameSnapshot* snapshot = _snapshots[(_nextSnapshot + s) % POOL_SIZE].data( );
+		if ( snapshot->ref.loadAcquire( ) == 1 ) {
+			_nextSnapshot = (_nextSnapshot + s + 1) % POOL_SIZE;
+			return snapshot;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,206 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QFRAMESNAPSHOT_H_
+#define __QFRAMESNAPSHOT_H_
+
+#include <QExplicitlySharedDataPointer>
+#include <QMetaType>
+#include <QSharedData>
+#include <QVector>
+
+#include "qfftw.h"
+
+
+//! Immutable picture of an analysed frame handed to the views.
+/*!
+ * A snapshot holds the envelopes of the input signal and of the lag
+ * function displayed by the oscilloscope view (the smallest and the
+ * largest sample of each pixel column, see QPlotEnvelope), together
+ * with the estimate of the frame and its position in the stream.
+ * The snapshots are filled by the analysis, then published through a
+ * QFrameSnapshotPointer, which only gives read access: the views keep
+ * the pointer until the next snapshot replaces it, so that the data are
+ * never copied nor overwritten while they are displayed. Each snapshot
+ * is reference counted and recycled by its QFrameSnapshotPool once all
+ * the views have released it.
+ */
+
+class QFrameSnapshot : public QSharedData {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] plotData_size the largest number of columns of the envelopes
+	 */
+	QFrameSnapshot( const unsigned int plotData_size );
+
+	//! Default destructor.
+	~QFrameSnapshot( );
+
+	//! Retrieve the largest number of columns of the envelopes.
+	unsigned int capacity( ) const { return _plotData_size; };
+
+	//! Retrieve the number of columns of the envelopes of the signal and of the lag function.
+	unsigned int size( ) const { return _columnCount; };
+
+	//! Retrieve the number of columns filled by the envelope of the lag function (fewer than size when the frame is shorter than the displayed range).
+	unsigned int autoCorrSize( ) const { return _autoCorrColumnCount; };
+
+	//! Retrieve the smallest sample of the input signal in each column.
+	const qfftw_real* sampleMinimum( ) const { return _plotSampleMinimum; };
+
+	//! Retrieve the largest sample of the input signal in each column.
+	const qfftw_real* sampleMaximum( ) const { return _plotSampleMaximum; };
+
+	//! Retrieve the smallest sample of the input signal in each column to fill (before publishing the snapshot).
+	qfftw_real* sampleMinimum( ) { return _plotSampleMinimum; };
+
+	//! Retrieve the largest sample of the input signal in each column to fill (before publishing the snapshot).
+	qfftw_real* sampleMaximum( ) { return _plotSampleMaximum; };
+
+	//! Retrieve the smallest sample of the lag function in each column.
+	const qfftw_real* autoCorrMinimum( ) const { return _plotAutoCorrMinimum; };
+
+	//! Retrieve the largest sample of the lag function in each column.
+	const qfftw_real* autoCorrMaximum( ) const { return _plotAutoCorrMaximum; };
+
+	//! Retrieve the smallest sample of the lag function in each column to fill (before publishing the snapshot).
+	qfftw_real* autoCorrMinimum( ) { return _plotAutoCorrMinimum; };
+
+	//! Retrieve the largest sample of the lag function in each column to fill (before publishing the snapshot).
+	qfftw_real* autoCorrMaximum( ) { return _plotAutoCorrMaximum; };
+
+	//! Check whether the lag function has been filled (false when the frame was not analysed by an estimator).
+	bool hasAutoCorr( ) const { return _hasAutoCorr; };
+
+	//! Retrieve the duration of the samples of the input signal (in seconds).
+	double timeRange( ) const { return _timeRange; };
+
+	//! Retrieve the time of the last sample of the frame, measured from the start of the stream (in seconds).
+	double streamTime( ) const { return _streamTime; };
+
+	//! Retrieve the frequency estimated for the frame (0 if the frame does not show any periodicity).
+	double estimatedFrequency( ) const { return _estimatedFrequency; };
+
+	//! Store the number of columns of the envelopes (before filling them).
+	/*!
+	 * \param[in] columnCount the number of columns (at least 1 and at most the capacity of the snapshot)
+	 */
+	void setSize( const unsigned int columnCount );
+
+	//! Store the number of columns filled by the envelope of the lag function (before filling it).
+	/*!
+	 * \param[in] columnCount the number of columns (at least 1 and at most size)
+	 */
+	void setAutoCorrSize( const unsigned int columnCount );
+
+	//! Store the duration of the samples of the input signal (before publishing the snapshot).
+	/*!
+	 * \param[in] timeRange the duration of the samples (in seconds)
+	 */
+	void setTimeRange( const double timeRange ) { _timeRange = timeRange; };
+
+	//! Store the estimate of the frame (before publishing the snapshot).
+	/*!
+	 * \param[in] streamTime the time of the last sample of the frame (in seconds)
+	 * \param[in] estimatedFrequency the frequency estimated for the frame
+	 * \param[in] hasAutoCorr true if the lag function has been filled
+	 */
+	void setEstimate( const double streamTime, const double estimatedFrequency, const bool hasAutoCorr );
+
+
+private: /* members */
+	qfftw_real*			_plotSampleMinimum;						//!< Smallest sample of the input signal in each column
+	qfftw_real*			_plotSampleMaximum;						//!< Largest sample of the input signal in each column
+	qfftw_real*			_plotAutoCorrMinimum;					//!< Smallest sample of the lag function in each column
+	qfftw_real*			_plotAutoCorrMaximum;					//!< Largest sample of the lag function in each column
+	unsigned int		_plotData_size;							//!< Largest number of columns of the envelopes
+	unsigned int		_columnCount;							//!< Number of columns of the envelopes
+	unsigned int		_autoCorrColumnCount;					//!< Number of columns filled by the envelope of the lag function
+	bool				_hasAutoCorr;							//!< True when the lag function has been filled
+	double				_timeRange;								//!< Duration of the samples of the input signal
+	double				_streamTime;							//!< Time of the last sample of the frame
+	double				_estimatedFrequency;					//!< Frequency estimated for the frame
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QFrameSnapshot( const QFrameSnapshot& );
+
+	//! Disabled assignment operator.
+	QFrameSnapshot& operator=( const QFrameSnapshot& );
+};
+
+
+//! Shared read-only handle to a published snapshot.
+typedef QExplicitlySharedDataPointer<const QFrameSnapshot>	QFrameSnapshotPointer;
+
+Q_DECLARE_METATYPE( QFrameSnapshotPointer )
+
+
+//! Preallocated set of snapshots recycled by a single producer.
+/*!
+ * The pool keeps a reference to each of its snapshots, thus a snapshot
+ * is free when the pool holds the only reference: the producer fills it
+ * and publishes it, while its readers may release it from any thread.
+ * Acquiring a snapshot never allocates, and it fails when all of them
+ * are still held (e.g. when the views cannot keep up with the analysis),
+ * in which case the frame is simply not displayed. A snapshot released
+ * after the destruction of the pool is deleted by its last reader.
+ */
+
+class QFrameSnapshotPool {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] plotData_size the largest number of columns of the envelopes of each snapshot
+	 */
+	QFrameSnapshotPool( const unsigned int plotData_size );
+
+	//! Default destructor.
+	~QFrameSnapshotPool( );
+
+	//! Retrieve a free snapshot to fill (producer side).
+	/*!
+	 * \return the oldest free snapshot (NULL when all of them are held)
+	 */
+	QFrameSnapshot* acquire( );
+
+
+private: /* static constants */
+	static const int	POOL_SIZE;								//!< Number of snapshots of the pool
+
+
+private: /* members */
+	QVector<QExplicitlySharedDataPointer<QFrameSnapshot> >	_snapshots;	//!< Snapshots of the pool, each referenced by the pool itself
+	int					_nextSnapshot;							//!< Index of the snapshot checked first by the next acquire
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QFrameSnapshotPool( const QFrameSnapshotPool& );
+
+	//! Disabled assignment operator.
+	QFrameSnapshotPool& operator=( const QFrameSnapshotPool& );
+};
+
+#endif /* __QFRAMESNAPSHOT_H_ */
@@ -0,0 +1,120 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QLATESTVALUE_H_
+#define __QLATESTVALUE_H_
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+
+
+//! Wait-free single-producer/single-consumer mailbox holding the latest value only.
+/*!
+ * This class implements a triple buffer used to hand the state of the
+ * analysis to a reader running at its own pace (e.g. the repaint timer
+ * of the views): the producer overwrites the value as often as it wants
+ * and the consumer reads the most recent one, so the older values are
+ * simply dropped instead of being queued.
+ * The producer and the consumer each own a slot, while the third one is
+ * exchanged through a single atomic index, which also flags whether it
+ * holds a value not read yet. The exchange has acquire and release
+ * semantic, so a slot is always complete when it changes owner; the
+ * type of the value only needs to be copyable (a shared pointer is
+ * referenced by the mailbox until it is overwritten).
+ */
+
+template <typename T>
+class QLatestValue {
+
+public: /* methods */
+	//! Default constructor.
+	QLatestValue( );
+
+	//! Replace the value of the mailbox (producer side).
+	/*!
+	 * \param[in] value the new value
+	 */
+	void write( const T& value );
+
+	//! Retrieve the latest value of the mailbox (consumer side).
+	/*!
+	 * \param[out] value the latest value written (a default constructed value before the first write)
+	 * \return true if the value has been written after the previous read
+	 */
+	bool read( T& value );
+
+
+private: /* static constants */
+	static const int			INDEX_MASK		= 0x3;			//!< Mask of the index of the slot in the exchanged value
+	static const int			FRESH_FLAG		= 0x4;			//!< Flag set in the exchanged value while its slot has not been read
+
+
+private: /* members */
+	T							_slots[3];					//!< Storage of the values
+	int							_writeSlot;					//!< Index of the slot owned by the producer
+	int							_readSlot;					//!< Index of the slot owned by the consumer
+	QAtomicInteger<int>			_middleSlot;				//!< Index of the exchanged slot, with FRESH_FLAG when it holds a new value
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QLatestValue( const QLatestValue& );
+
+	//! Disabled assignment operator.
+	QLatestValue& operator=( const QLatestValue& );
+};
+
+
+template <typename T>
+QLatestValue<T>::QLatestValue( ) : _middleSlot( 1 )
+{
+	// ** ASSIGN A SLOT TO EACH SIDE ** //
+	_writeSlot	= 0;
+	_readSlot	= 2;
+}
+
+
+template <typename T>
+void QLatestValue<T>::write( const T& value )
+{
+	// ** FILL THE SLOT OF THE PRODUCER ** //
+	_slots[_writeSlot] = value;
+
+	// ** PUBLISH IT, TAKING BACK THE EXCHANGED SLOT (READ OR NOT) ** //
+	_writeSlot = _middleSlot.fetchAndStoreOrdered( _writeSlot | FRESH_FLAG ) & INDEX_MASK;
+}
+
+
+template <typename T>
+bool QLatestValue<T>::read( T& value )
+{
+	// ** TAKE THE EXCHANGED SLOT ONLY IF IT HOLDS A NEW VALUE ** //
+	// (only the consumer clears the flag, so it cannot be lost between the two operations)
+	const bool fresh = (_middleSlot.loadAcquire( ) & FRESH_FLAG) != 0;
+	if ( fresh ) {
+		_readSlot = _middleSlot.fetchAndStoreOrdered( _readSlot ) & INDEX_MASK;
+	}
+
+	value = _slots[_readSlot];
+	return fresh;
+}
+
+#endif /* __QLATESTVALUE_H_ */
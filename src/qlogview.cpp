@@ -25,23 +25,10 @@
 
 #include <cmath>
 
+#include <QPaintEvent>
 #include <QPainter>
 #include <QPainterPath>
 
-// ** MUSICAL NOTATIONS ** //
-const QString QLogView::NoteLabel[6][12] = {
-	{  "A",  QString("A%1").arg(QChar(0x266F)),  "B",  "C",  QString("C%1").arg(QChar(0x266F)),  "D",  QString("D%1").arg(QChar(0x266F)),  "E",  "F",   QString("F%1").arg(QChar(0x266F)),   "G",   QString("G%1").arg(QChar(0x266F)) },	/* US  */
-	{  "A",  QString("B%1").arg(QChar(0x266D)),  "B",  "C",  QString("D%1").arg(QChar(0x266D)),  "D",  QString("E%1").arg(QChar(0x266D)),  "E",  "F",   QString("G%1").arg(QChar(0x266D)),   "G",   QString("A%1").arg(QChar(0x266D)) },	/* US alternate */
-	{ "La", QString("La%1").arg(QChar(0x266F)), "Si", "Do", QString("Do%1").arg(QChar(0x266F)), "Re", QString("Re%1").arg(QChar(0x266F)), "Mi", "Fa",  QString("Fa%1").arg(QChar(0x266F)), "Sol", QString("Sol%1").arg(QChar(0x266F)) },	/* French */
-	{ "La", QString("Si%1").arg(QChar(0x266D)), "Si", "Do", QString("Re%1").arg(QChar(0x266D)), "Re", QString("Mi%1").arg(QChar(0x266D)), "Mi", "Fa", QString("Sol%1").arg(QChar(0x266D)), "Sol",  QString("La%1").arg(QChar(0x266D)) },	/* French alternate */
-	{  "A",                                "B",  "H",  "C",  QString("C%1").arg(QChar(0x266F)),  "D",  QString("D%1").arg(QChar(0x266F)),  "E",  "F",   QString("F%1").arg(QChar(0x266F)),   "G",   QString("G%1").arg(QChar(0x266F)) },	/* German */
-	{  "A",                                "B",  "H",  "C",  QString("D%1").arg(QChar(0x266D)),  "D",  QString("E%1").arg(QChar(0x266D)),  "E",  "F",   QString("G%1").arg(QChar(0x266D)),   "G",   QString("A%1").arg(QChar(0x266D)) }		/* German alternate */
-};
-
-// ** NOTE RATIOS ** //
-const double	QLogView::D_NOTE				= pow( 2.0, 1.0/12.0 );
-const double	QLogView::D_NOTE_LOG			= log10( pow( 2.0, 1.0/12.0 ) ) / log10( 2.0 );
-
 // ** WIDGET SIZES ** //
 const double	QLogView::SIDE_MARGIN			= 0.02;
 const int		QLogView::BAR_HEIGHT			= 8;
@@ -56,10 +43,6 @@ const double	QLogView::ACCEPTED_DEVIATION	= 0.025;
 
 QLogView::QLogView( QWidget* parent ) : QWidget( parent )
 {
-	// ** INITIALIZE PRIVATE VARIABLES ** //
-	_tuningNotation			= NOTATION_US;
-	_fundamentalFrequency	= 440.0;
-
 	// redraw everything the first time and disable cursor
 	_drawBackground			= true;
 	_drawForeground			= false;
@@ -70,22 +53,10 @@ QLogView::QLogView( QWidget* parent ) : QWidget( parent )
 }
 
 
-void QLogView::setTuningParameters( const double fundamentalFrequency, const TuningNotation tuningNotation )
+void QLogView::setTuningParameters( const double fundamentalFrequency, const QTuningScale::TuningNotation tuningNotation )
 {
-	// ** CHECK LIMITS AND UPDATE PARAMETERS ** //
-	if ( tuningNotation <= NOTATION_GERMAN ) {
-		_tuningNotation = (TuningNotation) tuningNotation;
-	}
-
-	if ( (_fundamentalFrequency >= 400.0) && (_fundamentalFrequency <= 480.0) ) {
-		_fundamentalFrequency = fundamentalFrequency;
-	}
-
-	// ** UPDATE PITCH DETECTION CONSTANTS ** //
-	for ( unsigned int k = 0 ; k < 12 ; ++k ) {
-		_noteFrequency[k]	= _fundamentalFrequency * pow( D_NOTE, (int) k );						// set frequencies for pitch detection
-		_noteScale[k]		= log10( _fundamentalFrequency ) / log10( 2.0 ) + (k * D_NOTE_LOG);		// set frequencies for visualization
-	}
+	// ** UPDATE PARAMETERS (THE LIMITS ARE CHECKED BY THE SCALE) ** //
+	_tuningScale.setTuningParameters( fundamentalFrequency, tuningNotation );
 
 	// ** UPDATE THE GUI ** //
 	_drawBackground = true;
@@ -93,63 +64,39 @@ void QLogView::setTuningParameters( const double fundamentalFrequency, const Tun
 }
 
 
-void QLogView::getTuningParameters( double& fundamentalFrequency, TuningNotation& tuningNotation ) const
+void QLogView::getTuningParameters( double& fundamentalFrequency, QTuningScale::TuningNotation& tuningNotation ) const
 {
-	fundamentalFrequency	= _fundamentalFrequency;
-	tuningNotation			= _tuningNotation;
+	_tuningScale.getTuningParameters( fundamentalFrequency, tuningNotation );
 }
 
 
-void QLogView::setEstimatedFrequency( double estimatedFrequency )
+void QLogView::setMinFrequency( const double minFrequency )
 {
-	// ** TRY TO ENSURE THAT THE ARRAY IS PROPERLY INITIALIZED ** //
-	Q_ASSERT( _noteFrequency[0] != 0 );
-	Q_ASSERT( _noteFrequency[11] != 0 );
-
-	// process only notes within the range [40, 2000] Hz
-	if ( (estimatedFrequency >= 40.0) && (estimatedFrequency <= 2000.0) ) {
-		// ** ESTIMATE THE NEW PITCH ** //
-		// compute the deviation of the estimated frequency with respect to the reference octave
-		int octaveDeviation = 0;
-
-		// rescale the estimatedFrequency to bring it inside the reference octave (4th octave)
-		while ( estimatedFrequency > (_noteFrequency[11] + _fundamentalFrequency * D_NOTE_LOG / 2.0 ) ) {
-			// higher frequency, higher octave
-			estimatedFrequency /= 2.0;
-			octaveDeviation++;
-		}
-
-		while ( estimatedFrequency < (_noteFrequency[0] - _fundamentalFrequency * D_NOTE_LOG / 2.0 ) ) {
-			// lower frequency, lower octave
-			estimatedFrequency *= 2.0;
-			octaveDeviation--;
-		}
-
-		/*
-		 * here estimatedFrequency is in the range ( _noteFrequency[0], _noteFrequency[11] )
-		 * so it is possible to find the pitch in the scale as the one with the minimum
-		 * distance in the LINEAR scale (logarithm of the frequencies)
-		 */
+	// ** UPDATE THE RANGE (THE LIMITS ARE CHECKED BY THE SCALE) ** //
+	_tuningScale.setMinFrequency( minFrequency );
+}
 
-		double			minPitchDeviation		= _fundamentalFrequency * D_NOTE_LOG / 2.0;
-		unsigned int	minPitchDeviation_index	= 0;
-		double			log_estimatedFrequency	= log10(estimatedFrequency) / log10( 2.0 );
 
-		for ( unsigned int k = 0 ; k < 12 ; ++k ) {
-			if ( fabs( log_estimatedFrequency - _noteScale[k] ) < minPitchDeviation ) {
-				minPitchDeviation		= fabs( log_estimatedFrequency - _noteScale[k] );
-				minPitchDeviation_index	= k;
-			}
+void QLogView::setEstimatedFrequency( double estimatedFrequency )
+{
+	// ** ESTIMATE THE NEW PITCH ** //
+	int		note;
+	int		octave;
+	double	deviation;
+	if ( _tuningScale.findNote( estimatedFrequency, note, octave, deviation ) ) {
+		// save the details of the pitch deviation for the visualization, repainting only if the cursor moves
+		if ( (note != _currentPitch) || (deviation != _currentPitchDeviation) ) {
+			const QRect previousRect = foregroundRect( );
+			_currentPitch 			= note;
+			_currentPitchDeviation	= deviation;
+			update( QRegion( previousRect ).united( foregroundRect( ) ) );
 		}
 
-		// save the details of the pitch deviation for the visualization
-		_currentPitch 			= minPitchDeviation_index;
-		_currentPitchDeviation	= ( log_estimatedFrequency - _noteScale[minPitchDeviation_index] ) / D_NOTE_LOG;
-
 		// ** BROADCAST PITCH ESTIMATION ** //
-		emit updateEstimatedNote( _noteFrequency[minPitchDeviation_index] * pow( 2.0, octaveDeviation ) );
-	} else {
+		emit updateEstimatedNote( _tuningScale.noteFrequency( note, octave ) );
+	} else if ( _currentPitch != -1 ) {
 		// disable current selection
+		update( foregroundRect( ) );
 		_currentPitch = -1;
 	}
 }
@@ -158,11 +105,15 @@ void QLogView::setEstimatedFrequency( double estimatedFrequency )
 void QLogView::setPlotEnabled( bool enabled )
 {
 	// ** SET THE ACTIVAITON STATUS ** //
-	_drawForeground = enabled;
+	if ( enabled != _drawForeground ) {
+		const QRect previousRect = foregroundRect( );
+		_drawForeground = enabled;
+		update( previousRect.united( foregroundRect( ) ) );
+	}
 }
 
 
-void QLogView::paintEvent( QPaintEvent* /* event */ )
+void QLogView::paintEvent( QPaintEvent* event )
 {
 	// ** ENSURE THAT THE PIXMAP IS VALID ** //
 	Q_ASSERT( _pixmap != NULL );
@@ -231,22 +182,23 @@ void QLogView::paintEvent( QPaintEvent* /* event */ )
 		for ( unsigned int k = 0 ; k < 12 ; ++k ) {
 			xTick = (int) ( scaleWidth / 24.0 + scaleWidth / 12.0 * k );
 			// label above the bar
-			painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation][k] ) / 2 + 1),
+			painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( k ) ) / 2 + 1),
 				- BAR_HEIGHT - painter.fontMetrics( ).descent( ) - LABEL_OFFSET,
-				NoteLabel[2 * _tuningNotation][k] );
+				_tuningScale.noteLabel( k ) );
 			// label below the bar
-			painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation + 1][k] ) / 2 + 1),
+			painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( k, true ) ) / 2 + 1),
 				BAR_HEIGHT + painter.fontMetrics( ).ascent( ) + LABEL_OFFSET,
-				NoteLabel[2 * _tuningNotation + 1][k] );
+				_tuningScale.noteLabel( k, true ) );
 		}
 		painter.end( );
 	}
 
 	// ** DISPLAY THE OFFSCREEN BUFFER ** //
+	// (only the exposed area is blitted, the painter is already clipped to the region of the event)
 	painter.begin( this );
-	painter.drawPixmap( 0, 0, *_pixmap );
+	painter.drawPixmap( event->rect( ), *_pixmap, event->rect( ) );
 
-	if ( (_drawForeground == true) && (_currentPitch >= 0) ) {
+	if ( (_drawForeground == true) && (_currentPitch >= 0) && event->region( ).intersects( foregroundRect( ) ) ) {
 		// ** DRAW THE CURSOR IF REQUIRED ** //
 		// draw labels
 		painter.translate( QPoint( (int)(width( ) * SIDE_MARGIN), height( ) / 2 ) );
@@ -262,9 +214,9 @@ void QLogView::paintEvent( QPaintEvent* /* event */ )
 			// draw a square around the note when the error pitch is less than 2.5 percent
 			painter.setRenderHint( QPainter::Antialiasing, true );
 			painter.setPen( QPen( Qt::red, 0, Qt::SolidLine ) );
-			painter.drawRoundedRect( QRectF ( xTick - painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation][_currentPitch] ) / 2.0 - CARET_BORDER,
+			painter.drawRoundedRect( QRectF ( xTick - painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( _currentPitch ) ) / 2.0 - CARET_BORDER,
 				-BAR_HEIGHT - painter.fontMetrics( ).ascent( ) - LABEL_OFFSET - CARET_BORDER,
-				painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation][_currentPitch] ) + 2 * CARET_BORDER,
+				painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( _currentPitch ) ) + 2 * CARET_BORDER,
 				2 * ( BAR_HEIGHT + painter.fontMetrics( ).ascent( ) + LABEL_OFFSET + CARET_BORDER) ), 15, 15, Qt::RelativeSize );
 			painter.setRenderHint( QPainter::Antialiasing, false );
 		}
@@ -273,13 +225,13 @@ void QLogView::paintEvent( QPaintEvent* /* event */ )
 		painter.setPen( QPen( Qt::red, 0, Qt::SolidLine ) );
 
 		// label above the bar
-		painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation][_currentPitch] ) / 2 + 1),
+		painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( _currentPitch ) ) / 2 + 1),
 			-BAR_HEIGHT - painter.fontMetrics( ).descent( ) - LABEL_OFFSET,
-			NoteLabel[2 * _tuningNotation][_currentPitch] );
+			_tuningScale.noteLabel( _currentPitch ) );
 		// label below the bar
-		painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( NoteLabel[2 * _tuningNotation + 1][_currentPitch] ) / 2 + 1),
+		painter.drawText( xTick - (painter.fontMetrics( ).horizontalAdvance( _tuningScale.noteLabel( _currentPitch, true ) ) / 2 + 1),
 			BAR_HEIGHT + painter.fontMetrics( ).ascent( ) + LABEL_OFFSET,
-			NoteLabel[2 * _tuningNotation + 1][_currentPitch] );
+			_tuningScale.noteLabel( _currentPitch, true ) );
 
 		// draw the cursor
 		painter.setPen( QPen( palette( ).text( ), 0, Qt::SolidLine ) );
@@ -330,8 +282,48 @@ void QLogView::paintEvent( QPaintEvent* /* event */ )
 }
 
 
+QRect QLogView::foregroundRect( ) const
+{
+	// ** NOTHING IS DRAWN WITHOUT A HIGHLIGHTED NOTE ** //
+	if ( (_drawForeground == false) || (_currentPitch < 0) ) {
+		return QRect( );
+	}
+
+	// ** USE THE SAME FONT AND POSITIONS OF THE PAINT EVENT ** //
+	QFont font = this->font( );
+	font.setPointSize( font.pointSize( ) + 2 );
+	QFontMetrics fontMetrics( font );
+
+	int scaleWidth	= (int)(width( ) * (1.0 - 2 * SIDE_MARGIN));
+	int xTick		= (int) ( scaleWidth / 24.0 + scaleWidth / 12.0 * _currentPitch );
+	int xCursor		= (int) ( scaleWidth / 24.0 + scaleWidth / 12.0 * ( _currentPitch + _currentPitchDeviation ) );
+
+	// the labels and the caret around them (one more pixel on each side for the antialiasing)
+	int labelWidth	= qMax( fontMetrics.horizontalAdvance( _tuningScale.noteLabel( _currentPitch ) ),
+		fontMetrics.horizontalAdvance( _tuningScale.noteLabel( _currentPitch, true ) ) ) + 2 * CARET_BORDER + 4;
+	int labelHeight	= BAR_HEIGHT + fontMetrics.ascent( ) + fontMetrics.descent( ) + LABEL_OFFSET + CARET_BORDER + 2;
+	QRect labelRect( xTick - labelWidth / 2, -labelHeight, labelWidth, 2 * labelHeight );
+
+	// the cursor in the tuning bar
+	QRect cursorRect( xCursor - CURSOR_WIDTH / 2 - 2, -BAR_HEIGHT, CURSOR_WIDTH + 4, 2 * BAR_HEIGHT + 1 );
+
+	return labelRect.united( cursorRect ).translated( (int)(width( ) * SIDE_MARGIN), height( ) / 2 );
+}
+
+
 void QLogView::resizeEvent( QResizeEvent* /* event */ )
 {
 	// ** REQUEST A BACKGROUND REPAINT ** //
 	_drawBackground = true;
 }
+
+
+void QLogView::changeEvent( QEvent* event )
+{
+	// ** THE BACKGROUND USES THE COLORS AND THE FONT OF THE WIDGET ** //
+	if ( (event->type( ) == QEvent::PaletteChange) || (event->type( ) == QEvent::FontChange) || (event->type( ) == QEvent::StyleChange) ) {
+		_drawBackground = true;
+		update( );
+	}
+	QWidget::changeEvent( event );
+}
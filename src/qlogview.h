@@ -37,19 +37,12 @@
 
 #include <QWidget>
 
+#include "qtuningscale.h"
+
 class QLogView : public QWidget {
 	Q_OBJECT
 
 
-public: /* enumerations */
-	//! Enumeration of the available tuning scales
-	enum TuningNotation {
-		NOTATION_US,
-		NOTATION_FRENCH,
-		NOTATION_GERMAN
-	};
-
-
 public: /* methods */
 	//! Default constructor.
 	/*!
@@ -62,14 +55,20 @@ public: /* methods */
 	 * \param[in] fundamentalFrequency fundamental frequency of the note A4
 	 * \param[in] tuningNotation tuning notation used to select the string to display
 	 */
-	void setTuningParameters( const double fundamentalFrequency, const TuningNotation tuningNotation );
+	void setTuningParameters( const double fundamentalFrequency, const QTuningScale::TuningNotation tuningNotation );
 
 	//! Get the parameters of the current pitch detection algorithm.
 	/*!
 	 * \param[out] fundamentalFrequency fundamental frequency of the note A4
 	 * \param[out] tuningNotation tuning notation used to select the string to display
 	 */
-	void getTuningParameters( double& fundamentalFrequency, TuningNotation& tuningNotation ) const;
+	void getTuningParameters( double& fundamentalFrequency, QTuningScale::TuningNotation& tuningNotation ) const;
+
+	//! Set the lowest frequency identified as a note.
+	/*!
+	 * \param[in] minFrequency lowest frequency identified as a note (ignored if outside the range allowed by the scale)
+	 */
+	void setMinFrequency( const double minFrequency );
 
 
 public slots:
@@ -107,6 +106,12 @@ protected: /* methods */
 	 */
 	virtual void resizeEvent( QResizeEvent* event );
 
+	//! Function called when the palette, the font or the style of the widget change.
+	/*!
+	 * \param[in] event the details of the change
+	 */
+	virtual void changeEvent( QEvent* event );
+
 
 private: /* static constants */
 	// ** WIDGETS SIZES ** //
@@ -122,16 +127,8 @@ private: /* static constants */
 
 
 private: /* members */
-	// ** TUNING NOTATIONS ** //
-	static const QString NoteLabel[6][12];				//!< Labels of the note in different tuning scales
-
 	// ** PITCH DETECTION PARAMETERS ** //
-	static const double	D_NOTE;							//!< Ratio of two consecutive notes for pitch detection
-	static const double	D_NOTE_LOG;						//!< Ratio of two consecutive notes for visualization
-	double				_noteFrequency[12];				//!< Frequencies of the notes in the reference octave used for pitch detection
-	double				_noteScale[12];					//!< Scale of the notes in the reference octave used for visualization
-	double				_fundamentalFrequency;			//!< Fundamental frequency used as a reference to build the pitch scale
-	TuningNotation		_tuningNotation;				//!< Musical notation used to select the string displayed
+	QTuningScale		_tuningScale;					//!< Note scale used for pitch detection and for the labels
 	int					_currentPitch;					//!< Frequency of the closest note in the scale
 	double				_currentPitchDeviation;			//!< percentuale da -0.5 a +0.5 che dice di quanto va disegnato spostato
 
@@ -139,6 +136,16 @@ private: /* members */
 	bool				_drawBackground;				//!< Redraw everything when true, otherwise redraw only the note scale
 	bool				_drawForeground;				//!< Draw the note cursor when true, otherwise draw nothing
 	QPixmap*			_pixmap;						//!< Pixmap used to store the background to reduce the load
+
+
+private: /* methods */
+	//! Compute the area covered by the highlighted note and by the cursor.
+	/*!
+	 * The area is used to repaint only the pixels changed by the
+	 * foreground, since the background is blitted from the pixmap.
+	 * \return the rectangle in widget coordinates (empty when nothing is highlighted)
+	 */
+	QRect foregroundRect( ) const;
 };
 
 #endif /* __QLOGVIEW_H_ */
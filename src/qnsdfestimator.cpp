@@ -0,0 +1,106 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qnsdfestimator.h"
+
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const double QNsdfEstimator::KEY_MAXIMUM_THRESHOLD	= 0.9;
+
+
+QNsdfEstimator::QNsdfEstimator( const unsigned int frameSize, const double sampleFrequency ) :
+	QDifferenceEstimator( frameSize, sampleFrequency )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	// there is at most one key maximum every two lags
+	_keyMaximum_lag		= new double[_window_size / 2 + 1];
+	_keyMaximum_height	= new double[_window_size / 2 + 1];
+}
+
+
+QNsdfEstimator::~QNsdfEstimator( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[] _keyMaximum_lag;
+	delete[] _keyMaximum_height;
+}
+
+
+double QNsdfEstimator::estimate( const qfftw_real* frame )
+{
+	// ** COMPUTE THE TERMS OF THE DIFFERENCE FUNCTION ** //
+	fftw_differenceTerms( frame );
+
+	QPITCH_STAGE_BEGIN( );
+
+	// ** COMPUTE THE NORMALIZED SQUARE DIFFERENCE FUNCTION ** //
+	// the IFFT is not normalized, so the correlation is scaled by the size of the frame
+	const double scale = 2.0 / _fftw_in_time_size;
+	for ( unsigned int t = 0 ; t < _window_size ; ++t ) {
+		_fftw_in_time[t] = (_energy[t] > 0.0) ? scale * _fftw_in_time[t] / _energy[t] : 0.0;
+	}
+	memset( _fftw_in_time + _window_size, 0, (_fftw_in_time_size - _window_size) * sizeof( qfftw_real ) );
+	QPITCH_STAGE_END( STAGE_MINIMUM_SEARCH );
+
+	// ** FIND THE KEY MAXIMA ** //
+	// skip the lobe around the lag 0
+	unsigned int t;
+	for ( t = 0 ; (t < _window_size) && (_fftw_in_time[t] > 0.0) ; ++t ) {};
+
+	unsigned int	keyMaximumCount		= 0;
+	double			maxHeight			= 0.0;
+	while ( t < _window_size ) {
+		// move to the next positive-going zero crossing
+		for (  ; (t < _window_size) && (_fftw_in_time[t] <= 0.0) ; ++t ) {};
+
+		// find the highest sample of the positive lobe
+		unsigned int maxIndex = t;
+		for (  ; (t < _window_size) && (_fftw_in_time[t] > 0.0) ; ++t ) {
+			if ( _fftw_in_time[t] > _fftw_in_time[maxIndex] ) {
+				maxIndex = t;
+			}
+		}
+
+		// refine it (a lobe cut by the end of the window is not a key maximum)
+		if ( t < _window_size ) {
+			double height;
+			_keyMaximum_lag[keyMaximumCount] = parabolicPeak( _fftw_in_time, maxIndex, height );
+			_keyMaximum_height[keyMaximumCount] = height;
+			maxHeight = qMax( maxHeight, height );
+			++keyMaximumCount;
+		}
+	}
+
+	// select the first key maximum close to the highest one
+	unsigned int k;
+	for ( k = 0 ; (k < keyMaximumCount) && (_keyMaximum_height[k] < KEY_MAXIMUM_THRESHOLD * maxHeight) ; ++k ) {};
+	QPITCH_STAGE_END( STAGE_MAXIMUM_SEARCH );
+
+	if ( k == keyMaximumCount ) {
+		return 0.0;
+	}
+
+	// compute the frequency of the period
+	return ( _sampleFrequency / _keyMaximum_lag[k] );
+}
@@ -0,0 +1,74 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QNSDFESTIMATOR_H_
+#define __QNSDFESTIMATOR_H_
+
+#include "qdifferenceestimator.h"
+
+
+//! Pitch detection based on the McLeod pitch method.
+/*!
+ * The normalized square difference function (NSDF)
+ *
+ * n[t] = 2 * r[t] / m[t] = 1 - d[t] / m[t]
+ *
+ * is in the range [-1, 1] regardless of the level of the signal and of
+ * the lag. After the lobe around the lag 0 the highest sample between
+ * each positive-going zero crossing and the following negative-going
+ * one is a key maximum, refined with a parabolic interpolation; the
+ * period is the first key maximum higher than a fraction of the highest
+ * one, which prefers the fundamental to the sub-harmonics and tolerates
+ * a weak fundamental.
+ */
+
+class QNsdfEstimator : public QDifferenceEstimator {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] frameSize the size of the frame used to compute the FFT
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 */
+	QNsdfEstimator( const unsigned int frameSize, const double sampleFrequency );
+
+	//! Default destructor.
+	virtual ~QNsdfEstimator( );
+
+	//! Estimate the pitch of the frame finding the first key maximum of the NSDF.
+	/*!
+	 * \param[in] frame the frameSize samples to analyse (read in place)
+	 * \return the frequency value corresponding to the period (0 if the NSDF has no key maximum)
+	 */
+	virtual double estimate( const qfftw_real* frame );
+
+
+private: /* static constants */
+	static const double	KEY_MAXIMUM_THRESHOLD;					//!< Height of the selected key maximum relative to the highest one
+
+
+private: /* members */
+	double*				_keyMaximum_lag;						//!< Interpolated lags of the key maxima
+	double*				_keyMaximum_height;						//!< Interpolated heights of the key maxima
+};
+
+#endif /* __QNSDFESTIMATOR_H_ */
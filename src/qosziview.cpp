@@ -21,10 +21,13 @@
  */
 
 #include "qosziview.h"
+#include "qtuningscale.h"
 
 #include <cmath>
 
+#include <QPaintEvent>
 #include <QPainter>
+#include <QPolygonF>
 #include <iostream>
 
 // ** CUSTOM CONSTANTS ** //
@@ -43,81 +46,68 @@ QOsziView::QOsziView( QWidget* parent ) : QWidget( parent )
 	// redraw everything the first time and disable signals
 	_drawBackground			= true;
 	_drawForeground			= false;
-	_timeRangeSample		= 1.0;					// dummy values to avoid division by 0
-
-	//** INITIALIZE BUFFERS ** //
-	_plotBuffer_size		= 0;					// empty buffers
-	_plotSample				= NULL;
-	_plotAutoCorr			= NULL;
+	_minFrequency			= QTuningScale::MIN_FREQUENCY;
 }
 
 
 QOsziView::~QOsziView()
 {
 	// ** RELEASE RESOURCES ** //
-	delete[] _plotSample;
-	delete[] _plotAutoCorr;
+	// the snapshots are released with their pointers
 }
 
 
-void QOsziView::setBufferSize( const unsigned int plotBuffer_size )
+void QOsziView::setMinFrequency( const double minFrequency )
 {
-	// ** DELETE OLD BUFFERS ** //
-	delete[] _plotSample;
-	delete[] _plotAutoCorr;
-
-	//** INITIALIZE BUFFERS ** //
-	_plotBuffer_size	= plotBuffer_size;
-	_plotSample			= new double[_plotBuffer_size];
-	_plotAutoCorr		= new double[_plotBuffer_size];
-	_estimatedFrequency	= 0.0;
-
-	// ** CLEAR BUFFERS ** //
-	memset( _plotSample, 0, sizeof( double ) * _plotBuffer_size );
-	memset( _plotAutoCorr, 0, sizeof( double ) * _plotBuffer_size );
+	// ** ENSURE THAT THE RANGE IS VALID ** //
+	Q_ASSERT( minFrequency > 0.0 );
+
+	// ** UPDATE THE RANGE AND REQUEST A BACKGROUND REPAINT ** //
+	_minFrequency	= minFrequency;
+	_drawBackground	= true;
+	update( );
 }
 
 
 void QOsziView::setPlotEnabled( bool enabled )
 {
 	// ** SET THE ACTIVAITON STATUS ** //
-	_drawForeground = enabled;
+	if ( enabled != _drawForeground ) {
+		_drawForeground = enabled;
+		update( QRegion( plotAreaRect( false ) ).united( plotAreaRect( true ) ) );
+	}
 }
 
 
-void QOsziView::setPlotSamples( const double* plotSample, double timeRangeSample )
+void QOsziView::setPlotFrame( const QFrameSnapshotPointer& frame )
 {
-	// ** ENSURE THAT THE BUFFERS ARE VALID ** //
-	Q_ASSERT( plotSample		!= NULL );
-	Q_ASSERT( _plotSample		!= NULL );
-	Q_ASSERT( _plotBuffer_size	!= 0 );
-
-	// ** STORE SIGNAL ** //
-	memcpy( _plotSample, plotSample, _plotBuffer_size * sizeof( double ) );
-	_timeRangeSample = timeRangeSample;
-}
-
+	// ** ENSURE THAT THE SNAPSHOT IS VALID ** //
+	Q_ASSERT( frame );
+	Q_ASSERT( frame->size( ) != 0 );
+
+	// ** HOLD THE SNAPSHOT, RELEASING THE PREVIOUS ONE TO ITS POOL ** //
+	// (the state of the analysis is published for each block, not only for each frame)
+	if ( frame == _sampleFrame ) {
+		return;
+	}
+	_sampleFrame = frame;
+	if ( frame->hasAutoCorr( ) ) {
+		_autoCorrFrame = frame;
+	}
 
-void QOsziView::setPlotAutoCorr( const double* plotAutoCorr, double estimatedFrequency )
-{
-	// ** ENSURE THAT THE BUFFERS ARE VALID ** //
-	Q_ASSERT( plotAutoCorr		!= NULL );
-	Q_ASSERT( _plotAutoCorr		!= NULL );
-	Q_ASSERT( _plotBuffer_size	!= 0 );
-
-	// ** STORE AUTOCORRELATION ** //
-	memcpy( _plotAutoCorr, plotAutoCorr, _plotBuffer_size * sizeof( double ) );
-	_estimatedFrequency	= estimatedFrequency;
+	// ** REPAINT THE CURVES (ONLY WHILE THEY ARE DISPLAYED) ** //
+	// the lower axis changes only with a new autocorrelation
+	if ( _drawForeground == true ) {
+		update( plotAreaRect( false ) );
+		if ( frame->hasAutoCorr( ) ) {
+			update( plotAreaRect( true ) );
+		}
+	}
 }
 
 
-void QOsziView::paintEvent( QPaintEvent* /* event */ )
+void QOsziView::paintEvent( QPaintEvent* event )
 {
-	// ** ENSURE THAT THE BUFFERS ARE VALID ** //
-	Q_ASSERT( _plotSample		!= NULL );
-	Q_ASSERT( _plotAutoCorr		!= NULL );
-	Q_ASSERT( _plotBuffer_size	!= 0 );
-
 	// ** INITIALIZE PAINTER ** //
 	QPainter painter;
 
@@ -170,35 +160,76 @@ void QOsziView::paintEvent( QPaintEvent* /* event */ )
 	}
 
 	// ** DISPLAY THE OFFSCREEN BUFFER ** //
+	// (only the exposed area is blitted, the painter is already clipped to the region of the event)
 	painter.begin( this );
-	painter.drawPixmap( 0, 0, _pixmap );
+	painter.drawPixmap( event->rect( ), _pixmap, event->rect( ) );
         painter.setRenderHint(QPainter::Antialiasing);
 
 	if ( _drawForeground == true ) {
 		// ** UPPER AXIS ** //
 		painter.translate( plotArea_sideMargin, plotArea_topMargin + plotArea_height );
-		drawCurve( painter, _plotSample, _plotBuffer_size, plotArea_width, plotArea_height, Qt::darkGreen, 2048.0 );
+		if ( _sampleFrame && event->region( ).intersects( plotAreaRect( false ) ) ) {
+			drawCurve( painter, _sampleFrame->sampleMinimum( ), _sampleFrame->sampleMaximum( ), _sampleFrame->size( ),
+				(double) plotArea_width / _sampleFrame->size( ), plotArea_height, Qt::darkGreen, 2048.0 );
+		}
 
 		// ** LOWER AXIS ** //
 		painter.translate( 0, 2 * (plotArea_topMargin + plotArea_height) );
-		drawCurve( painter, _plotAutoCorr, _plotBuffer_size, plotArea_width, plotArea_height, Qt::darkBlue, 0 );
+		if ( _autoCorrFrame && event->region( ).intersects( plotAreaRect( true ) ) ) {
+			drawCurve( painter, _autoCorrFrame->autoCorrMinimum( ), _autoCorrFrame->autoCorrMaximum( ), _autoCorrFrame->autoCorrSize( ),
+				(double) plotArea_width / _autoCorrFrame->size( ), plotArea_height, Qt::darkBlue, 0 );
+		}
 
 		// draw cursor
-		if ( (_estimatedFrequency >= 40.0) && (_estimatedFrequency <= 2000.0) ) {
+		const double estimatedFrequency = _autoCorrFrame ? _autoCorrFrame->estimatedFrequency( ) : 0.0;
+		if ( (estimatedFrequency >= _minFrequency) && (estimatedFrequency <= QTuningScale::MAX_FREQUENCY) && event->region( ).intersects( plotAreaRect( true ) ) ) {
 			painter.setPen( QPen( Qt::red, 0, Qt::SolidLine ) );
 			painter.setRenderHint( QPainter::Antialiasing, true );
-			painter.drawLine( QPointF( 40.0 / _estimatedFrequency * plotArea_width, -plotArea_height ),
-				QPointF( 40.0 / _estimatedFrequency * plotArea_width, plotArea_height - 1 ) );
+			painter.drawLine( QPointF( _minFrequency / estimatedFrequency * plotArea_width, -plotArea_height ),
+				QPointF( _minFrequency / estimatedFrequency * plotArea_width, plotArea_height - 1 ) );
 			painter.setRenderHint( QPainter::Antialiasing, false );
 		}
 	}
 }
 
 
+QRect QOsziView::plotAreaRect( bool lowerAxis ) const
+{
+	// ** COMPUTE AXIS SIZE (AS IN THE PAINT EVENT) ** //
+	int plotArea_width		= (int)(width( ) * (1.0 - 2 * SIDE_MARGIN));
+	int plotArea_sideMargin	= (int)(width( ) * SIDE_MARGIN);
+	int plotArea_height		= (int)(height( ) * AXIS_HALF_HEIGHT);
+	int plotArea_topMargin	= (int)(height( ) * TOP_MARGIN);
+
+	// the x-axis of the lower plot area is moved down by the size of the upper one
+	int xAxis = plotArea_topMargin + plotArea_height;
+	if ( lowerAxis == true ) {
+		xAxis += 2 * (plotArea_topMargin + plotArea_height);
+	}
+
+	// a couple of pixels more on each side for the border of the box and the antialiasing
+	return QRect( plotArea_sideMargin - 2, xAxis - plotArea_height - 2, plotArea_width + 4, 2 * plotArea_height + 4 );
+}
+
+
 void QOsziView::resizeEvent( QResizeEvent* /* event */ )
 {
 	// ** REQUEST A BACKGROUND REPAINT ** //
 	_drawBackground = true;
+
+	// ** REQUEST A COLUMN OF THE ENVELOPES FOR EACH PIXEL OF THE PLOT AREA ** //
+	emit updatePlotWidth( qMax( qRound( (int)(width( ) * (1.0 - 2 * SIDE_MARGIN)) * devicePixelRatioF( ) ), 1 ) );
+}
+
+
+void QOsziView::changeEvent( QEvent* event )
+{
+	// ** THE BACKGROUND USES THE COLORS AND THE FONT OF THE WIDGET ** //
+	if ( (event->type( ) == QEvent::PaletteChange) || (event->type( ) == QEvent::FontChange) || (event->type( ) == QEvent::StyleChange) ) {
+		_drawBackground = true;
+		update( );
+	}
+	QWidget::changeEvent( event );
 }
 
 
@@ -253,13 +284,14 @@ void QOsziView::drawReversedLogAxis( QPainter& painter, const int plotArea_width
 	int		xTick;
 	double	freq = 10.0;
 
-	for ( unsigned int k = 5 ; k <= 20 ; ++k ) {
+	// the first tick is the first multiple of 10 Hz above the lowest frequency
+	for ( unsigned int k = (unsigned int) floor( _minFrequency / 10.0 ) + 1 ; k <= 20 ; ++k ) {
 		if ( (k % 10) == 0 ) {
 			// move to next decade
 			freq *= 10;
-			xTick = (int)( 40.0 * (double) plotArea_width / freq );
+			xTick = (int)( _minFrequency * (double) plotArea_width / freq );
 		} else {
-			xTick = (int)( 40.0 * (double) plotArea_width / ((k % 10) * freq) );
+			xTick = (int)( _minFrequency * (double) plotArea_width / ((k % 10) * freq) );
 		}
 
 		if ( (k % 10) == 0 ) {
@@ -301,9 +333,9 @@ void QOsziView::drawReversedLogAxis( QPainter& painter, const int plotArea_width
 		if ( (k % 10) == 0 ) {
 			// move to next decade
 			freq *= 10;
-			xTick = (int)( 40.0 * (double) plotArea_width / freq );
+			xTick = (int)( _minFrequency * (double) plotArea_width / freq );
 		} else {
-			xTick = (int)( 40.0 * (double) plotArea_width / ((k % 10) * freq) );
+			xTick = (int)( _minFrequency * (double) plotArea_width / ((k % 10) * freq) );
 		}
 
 
@@ -326,27 +358,24 @@ void QOsziView::drawAxisBox( QPainter& painter, const int plotArea_width, const
 }
 
 
-void QOsziView::drawCurve( QPainter& painter, const double* plotData, const unsigned int plotData_size,
-	const int plotArea_width, const int plotArea_height, const QColor& color,
+void QOsziView::drawCurve( QPainter& painter, const qfftw_real* plotMinimum, const qfftw_real* plotMaximum, const unsigned int plotData_size,
+	const double columnWidth, const int plotArea_height, const QColor& color,
 	const double autoScaleThreshold )
 {
 	// ** ENSURE THAT THE DATA ARE VALID ** //
- 	Q_ASSERT( plotData != NULL );
+ 	Q_ASSERT( (plotMinimum != NULL) && (plotMaximum != NULL) );
  	Q_ASSERT( plotData_size != 0 );
 
-	// enable antialiasing and plot signal samples
-	painter.setPen( QPen( color, 0, Qt::SolidLine ) );
-
 	// find min and max of the signal in order to autoscale the signal up to 16 times
-	double minValue = plotData[0];
-	double maxValue = plotData[0];
+	double minValue = plotMinimum[0];
+	double maxValue = plotMaximum[0];
 
 	for ( unsigned int k = 1 ; k < plotData_size ; ++k ) {
-		if ( plotData[k] < minValue ) {
-			minValue = plotData[k];
+		if ( plotMinimum[k] < minValue ) {
+			minValue = plotMinimum[k];
 		}
-		if ( plotData[k] > maxValue ) {
-			maxValue = plotData[k];
+		if ( plotMaximum[k] > maxValue ) {
+			maxValue = plotMaximum[k];
 		}
 	}
 
@@ -356,9 +385,18 @@ void QOsziView::drawCurve( QPainter& painter, const double* plotData, const unsi
 	// y-axis is upside-down so use a negative scale factor to mirror the plot
 	double scaleFactor	= -(0.95 * plotArea_height) / ((limitValue > autoScaleThreshold) ? limitValue : autoScaleThreshold );
 
-	double xIntervalStep = (double) plotArea_width / (double) plotData_size;
-	for ( unsigned int k = 1 ; k < plotData_size ; ++k ) {
-		painter.drawLine( QPointF( (k - 1) * xIntervalStep, plotData[k - 1] * scaleFactor ),
-			QPointF( k * xIntervalStep, plotData[k] * scaleFactor) );
+	// the upper edge follows the largest samples from left to right, the lower edge the smallest ones back
+	QPolygonF envelope( 2 * plotData_size );
+	for ( unsigned int k = 0 ; k < plotData_size ; ++k ) {
+		const double xColumn = (k + 0.5) * columnWidth;
+		envelope[k]							= QPointF( xColumn, plotMaximum[k] * scaleFactor );
+		envelope[2 * plotData_size - 1 - k]	= QPointF( xColumn, plotMinimum[k] * scaleFactor );
 	}
+
+	// plot the envelope with a single call (the outline keeps visible the columns without any range)
+	painter.save( );
+	painter.setPen( QPen( color, 0, Qt::SolidLine ) );
+	painter.setBrush( color );
+	painter.drawPolygon( envelope );
+	painter.restore( );
 }
@@ -31,9 +31,13 @@
  * goes to 32768.
  * The autocorrelation of the input signal instead is plotted
  * in the lower axis. The x-axis has a (somehow) logarithmic
- * scale ranging from 40 Hz to 1000 Hz. The peak of the
+ * scale ranging from the lowest frequency of the tuner (40 Hz
+ * by default) to 1000 Hz. The peak of the
  * autocorrelation used to detect the frequency of the input
  * signal is indicated by a red line.
+ * Both curves are drawn as the envelope of the samples of each
+ * pixel column, which the analysis computes for the width of the
+ * plot area reported by updatePlotWidth.
  */
 
 #ifndef __QOSZIVIEW_H_
@@ -41,6 +45,9 @@
 
 #include <QWidget>
 
+#include "qfftw.h"
+#include "qframesnapshot.h"
+
 class QOsziView : public QWidget {
 	Q_OBJECT
 
@@ -55,27 +62,21 @@ public: /* methods */
 	//! Default destructor.
 	~QOsziView( );
 
-	//! Set the size of the buffer used for visualization.
+	//! Set the lowest frequency displayed in the graph of the autocorrelation.
 	/*!
-	 * \param[in] plotBuffer_size size of the buffer used for visualization
+	 * \param[in] minFrequency lowest frequency at the right end of the lower axis
 	 */
-	void setBufferSize( const unsigned int plotBuffer_size );
+	void setMinFrequency( const double minFrequency );
 
 
 public slots:
-	//! Update the graph of the input signal displayed in the oscilloscope.
-	/*!
-	 * \param[in] plotSample the array with the new samples of the input signal to display
-	 * \param[in] timeRangeSample time range used to place the tick marks on the signal axis
-	 */
-	void setPlotSamples( const double* plotSample, double timeRangeSample );
-
-	//! Update the graph of the autocorrelation displayed in the oscilloscope.
+	//! Update the graphs displayed in the oscilloscope.
 	/*!
-	 * \param[in] plotAutoCorr the array with the new samples of the autocorrelation to display
-	 * \param[in] estimatedFrequency frequency of the input signal estimated as the first autocorrelation peak
+	 * The snapshot is held until the next one replaces it, and the graph
+	 * of the autocorrelation keeps the last snapshot that has one.
+	 * \param[in] frame the snapshot with the new samples of the input signal and of the autocorrelation to display
 	 */
-	void setPlotAutoCorr( const double* plotAutoCorr, double estimatedFrequency );
+	void setPlotFrame( const QFrameSnapshotPointer& frame );
 
 	//! Enable the plot area, and display a blank axis box if disabled.
 	/*!
@@ -84,6 +85,14 @@ public slots:
 	void setPlotEnabled( bool enabled );
 
 
+signals:
+	//! Update the number of pixels of the plot area, i.e. the number of columns of the envelopes to display.
+	/*!
+	 * \param[in] columnCount the width of the plot area in device pixels
+	 */
+	void updatePlotWidth( unsigned int columnCount );
+
+
 protected: /* methods */
 	//! Function called to handle a repaint request.
 	/*!
@@ -97,6 +106,12 @@ protected: /* methods */
 	 */
 	virtual void resizeEvent( QResizeEvent* event );
 
+	//! Function called when the palette, the font or the style of the widget change.
+	/*!
+	 * \param[in] event the details of the change
+	 */
+	virtual void changeEvent( QEvent* event );
+
 
 private: /* static constants */
 	static const double	SIDE_MARGIN;					//!< Percent width of the horizontal margin of the plot area
@@ -110,9 +125,8 @@ private: /* static constants */
 
 private: /* members */
 	// ** VISUALIZATION BUFFERS ** //
-	double*				_plotSample;					//!< Buffer used to store time samples for visualization
-	double*				_plotAutoCorr;					//!< Buffer used to store autocorrelation samples for visualization
-	unsigned int		_plotBuffer_size;				//!< Size of the buffer used for visualization
+	QFrameSnapshotPointer	_sampleFrame;				//!< Snapshot with the time samples for visualization (NULL before the first one)
+	QFrameSnapshotPointer	_autoCorrFrame;				//!< Last snapshot with the autocorrelation samples for visualization (NULL before the first one)
 
 	// ** REPAINT FLAG **//
 	bool				_drawBackground;				//!< Redraw everything when true, otherwise redraw only the note scale
@@ -120,11 +134,19 @@ private: /* members */
 	QPixmap				_pixmap;						//!< Pixmap used to store the background to reduce the load
 
 	// ** PLOT PARAMETERS ** //
-	double				_timeRangeSample;				//!< Time range of the signal axis
-	double				_estimatedFrequency;			//!< Value of the estimated frequency
+	double				_minFrequency;					//!< Lowest frequency displayed in the graph of the autocorrelation
 
 
 private: /* methods */
+	//! Compute the plot area of one of the axes, where the curves are drawn.
+	/*!
+	 * The area is used to repaint only the pixels changed by the
+	 * curves, since the axes and the labels are blitted from the pixmap.
+	 * \param[in] lowerAxis select the lower axis (autocorrelation) instead of the upper one (audio signal)
+	 * \return the rectangle in widget coordinates, including the border of the axis box
+	 */
+	QRect plotAreaRect( bool lowerAxis ) const;
+
 	//! Draws an axis box with a linear scale with a fixed range [0, 50] ms.
 	/*!
 	 * \param[in] painter reference to the painter object used to draw on screen
@@ -133,7 +155,7 @@ private: /* methods */
 	 */
 	void drawLinearAxis( QPainter& painter, const int plotArea_width, const int plotArea_height );
 
-	//! Draw an axis box with a reversed logarithmic scale with a fixed range [1000, 40] Hz.
+	//! Draw an axis box with a reversed logarithmic scale with a range [1000, minFrequency] Hz.
 	/*!
 	 * \param[in] painter reference to the painter object used to draw on screen
 	 * \param[in] plotArea_width width of the plot area
@@ -149,18 +171,19 @@ private: /* methods */
 	 */
 	void drawAxisBox( QPainter& painter, const int plotArea_width, const int plotArea_height );
 
-	//! Draws an axis box with an optional x-axis and ticks in linear or logarithmic scale
+	//! Draws the envelope of a curve as a single polygon, from the largest samples of the columns back along the smallest ones.
 	/*!
 	 * \param[in] painter reference to the painter object used to draw on screen
-	 * \param[in] plotData buffer with the data to draw
-	 * \param[in] plotData_size size of the data buffer
-	 * \param[in] plotArea_width width of the plot area
+	 * \param[in] plotMinimum buffer with the smallest sample of each column
+	 * \param[in] plotMaximum buffer with the largest sample of each column
+	 * \param[in] plotData_size number of columns to draw
+	 * \param[in] columnWidth width of each column
 	 * \param[in] plotArea_height half the height of the plot area (used instead of the height to simplify coding)
 	 * \param[in] color the color used to draw the data
 	 * \param[in] autoScaleThreshold threshold under which autoscale is disabled (0 to always enable autoscale)
 	 */
-	void drawCurve( QPainter& painter, const double* plotData, const unsigned int plotData_size,
-		const int plotArea_width, const int plotArea_height, const QColor& color,
+	void drawCurve( QPainter& painter, const qfftw_real* plotMinimum, const qfftw_real* plotMaximum, const unsigned int plotData_size,
+		const double columnWidth, const int plotArea_height, const QColor& color,
 		const double autoScaleThreshold );
 };
 
@@ -0,0 +1,171 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpasoundinput.h"
+
+#include <cstring>
+
+#include <QtDebug>
+
+
+QPaSoundInput::QPaSoundInput( ) : QSoundInput( )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_stream = NULL;
+
+	// ** INITIALIZE PORTAUDIO ** //
+	PaError err = Pa_Initialize( );
+	if ( err != paNoError ) {
+		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	}
+}
+
+
+QPaSoundInput::~QPaSoundInput( )
+{
+	// ** ENSURE THAT THE STREAM IS CLOSED ** //
+	Q_ASSERT( _stream == NULL );
+
+	// ** TERMINATE PORTAUDIO ** //
+	Pa_Terminate( );
+}
+
+
+void QPaSoundInput::openStream( const unsigned int sampleFrequency, const unsigned int channelCount, QSoundInputCallback callback,
+	void* userData )
+{
+	// ** ENSURE THAT THE STREAM IS CLOSED ** //
+	Q_ASSERT( _stream == NULL );
+	Q_ASSERT( callback != NULL );
+
+	// ** SELECT THE INPUT DEVICE ** //
+        _inputParameters.device = -1;
+        for (int i = 0, end = Pa_GetDeviceCount(); i != end; ++i) {
+            PaDeviceInfo const* info = Pa_GetDeviceInfo(i);
+            if (!info) continue;
+            if (strcmp(info->name, "pulse") == 0) {
+                _inputParameters.device = i;
+                break;
+            }
+        }
+
+	// ** CONFIGURE THE INPUT AUDIO STREAM ** //
+	_sampleFrequency							=	sampleFrequency;
+	_callback									=	callback;
+	_userData									=	userData;
+        if (_inputParameters.device == -1) {
+            _inputParameters.device						=	Pa_GetDefaultInputDevice( );				// default input device
+        }
+	_channelCount								=	qBound( 1, (int) channelCount, Pa_GetDeviceInfo( _inputParameters.device )->maxInputChannels );
+	_inputParameters.channelCount				=	_channelCount;								// interleaved channels (mono by default)
+	_inputParameters.sampleFormat				=	paInt16;									// 16 bit integer
+	_inputParameters.suggestedLatency			=	Pa_GetDeviceInfo( _inputParameters.device )->defaultHighInputLatency;
+																								// set the latency for a robust non-interactive application
+	_inputParameters.hostApiSpecificStreamInfo	=	NULL;
+
+	// ** OPEN AN AUDIO INPUT STREAM ** //
+	_framesPerBuffer = (unsigned int)((double) _inputParameters.suggestedLatency * sampleFrequency);
+	PaError err = Pa_OpenStream(
+		&_stream,
+		&_inputParameters,
+		NULL,									// no output
+		_sampleFrequency,						// sample rate (default 44100 Hz)
+		(long) _framesPerBuffer,				// frames per buffer
+		paClipOff,								// disable clipping
+        paCallback,                             // callback
+		this									// pointer to user data
+	);
+
+	if ( err != paNoError ) {
+		_stream = NULL;
+		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	}
+
+	qDebug( ) << "QPaSoundInput::openStream";
+	qDebug( ) << " - defaultHighInputLatency = " << _inputParameters.suggestedLatency;
+	qDebug( ) << " - channelCount            = " << _channelCount;
+}
+
+
+void QPaSoundInput::closeStream( )
+{
+	// ** ENSURE THAT THE STREAM IS OPEN ** //
+	Q_ASSERT( _stream != NULL );
+
+	// ** CLOSE PORTAUDIO STREAM ** //
+	PaError err = Pa_CloseStream( _stream );
+	_stream = NULL;
+	if( err != paNoError ) {
+		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	}
+}
+
+
+void QPaSoundInput::startStream( )
+{
+	// ** ENSURE THAT THE STREAM IS OPEN ** //
+	Q_ASSERT( _stream != NULL );
+
+	// ** START PORTAUDIO STREAM ** //
+	PaError err = Pa_StartStream( _stream );
+	if( err != paNoError ) {
+		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	}
+}
+
+
+void QPaSoundInput::stopStream( )
+{
+	// ** ENSURE THAT THE STREAM IS OPEN ** //
+	Q_ASSERT( _stream != NULL );
+
+	// ** STOP PORTAUDIO STREAM ** //
+	PaError err = Pa_StopStream( _stream );
+	if( err != paNoError ) {
+		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	}
+}
+
+
+QString QPaSoundInput::description( ) const
+{
+	// ** ENSURE THAT THE STREAM IS OPEN ** //
+	Q_ASSERT( _stream != NULL );
+
+	// ** RETRIEVE STREAM PROPERTIES ** //
+	return QString( "Device: " + QString(Pa_GetDeviceInfo( _inputParameters.device )->name) + " [" +
+		QString(Pa_GetHostApiInfo( Pa_GetDeviceInfo( _inputParameters.device )->hostApi )->name)  + "]");
+}
+
+
+int QPaSoundInput::paCallback( const void* input, void* /*output*/, unsigned long frameCount,
+		const PaStreamCallbackTimeInfo* /*timeInfo*/, PaStreamCallbackFlags /*statusFlags*/, void* userData )
+{
+	Q_ASSERT( input		!= NULL );
+	Q_ASSERT( userData	!= NULL );
+
+	// ** DELIVER THE SAMPLES ** //
+	QPaSoundInput* soundInput = static_cast<QPaSoundInput*>( userData );
+	soundInput->_callback( (const short int*) input, (unsigned int) frameCount, soundInput->_userData );
+
+	return paContinue;
+}
@@ -0,0 +1,104 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPASOUNDINPUT_H_
+#define __QPASOUNDINPUT_H_
+
+#include "qsoundinput.h"
+
+#include <portaudio.h>
+
+
+//! An exception thrown when a PortAudio error occurs
+class QPaSoundInputException : public QSoundInputException {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] msg the error message to display
+	 */
+	QPaSoundInputException( const std::string& msg ) : QSoundInputException( "PortAudio error: " + msg ) {
+		return;
+	};
+};
+
+
+//! Sound input acquired through the PortAudio library.
+/*!
+ * This class acquires the audio stream through the PortAudio library
+ * (cross-platform) using a callback function. The size of the internal
+ * buffer is set to the size suggested for robust non-interactive
+ * application, since the latency is not an issue in this application.
+ * The "pulse" device is preferred when available, otherwise the default
+ * audio input stream is used, thus the selection of the audio input is
+ * performed using the control panel of the operating system.
+ */
+
+class QPaSoundInput : public QSoundInput {
+
+public: /* methods */
+	//! Default constructor.
+	QPaSoundInput( );
+
+	//! Default destructor.
+	~QPaSoundInput( );
+
+	//! Open the audio stream.
+	/*!
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 * \param[in] channelCount the number of channels (limited to the channels of the input device)
+	 * \param[in] callback the function called to deliver the samples
+	 * \param[in] userData the pointer passed to the callback
+	 */
+	virtual void openStream( const unsigned int sampleFrequency, const unsigned int channelCount, QSoundInputCallback callback,
+		void* userData );
+
+	//! Close the audio stream.
+	virtual void closeStream( );
+
+	//! Start the PortAudio stream.
+	virtual void startStream( );
+
+	//! Stop the PortAudio stream.
+	virtual void stopStream( );
+
+	//! Retrieve the name of the device used by PortAudio plus the name of the API used by PortAudio.
+	virtual QString description( ) const;
+
+    /*! \brief Dummy callback function to call the callback of the sound input.
+     *  \param[in] input Pointer to the interleaved input samples.
+     *  \param[out] output Pointer to the interleaved output samples.
+     *  \param[in] frameCount Number of sample frames to be processed.
+     *  \param[in] timeInfo Time when the buffer is processed.
+     *  \param[in] statusFlags Whether underflow or overflow occurred.
+     *  \param[in] userData Pointer to user data.
+     */
+    static int paCallback( const void* input, void* output, unsigned long frameCount,
+        const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void* userData );
+
+
+private: /* members */
+	PaStreamParameters	_inputParameters;						//!< Parameters of the input audio stream
+	PaStream*			_stream;								//!< Handle to the PortAudio stream
+};
+
+#endif /* __QPASOUNDINPUT_H_ */
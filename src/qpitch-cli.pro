@@ -0,0 +1,50 @@
+# .pro configuration file for the command line version of qpitch
+TEMPLATE		=	app
+
+
+## CONFIGURATIONS ##
+CONFIG			+=	qt thread console
+CONFIG			-=	app_bundle
+QT				-=	gui
+
+# create a debug version
+CONFIG			+=	debug warn_on
+
+# create a release version
+#CONFIG			+=	release warn_off
+
+# use the single precision FFTW library (fftw3f) for the analysis
+#CONFIG			+=	fftw_float
+
+
+## FILES AND DIRECTORIES ##
+include( qpitchcore.pri )
+
+HEADERS			+=	\
+					qpitchbatch.h \
+					qpitchcli.h
+
+SOURCES			+=	\
+					main_cli.cpp \
+					qpitchbatch.cpp \
+					qpitchcli.cpp
+
+
+## LIBRARIES ##
+fftw_float {
+	DEFINES		+=	QPITCH_FFTW_FLOAT
+	unix:LIBS	+=	-lportaudio -lfftw3f
+} else {
+	unix:LIBS	+=	-lportaudio -lfftw3
+}
+
+mac:LIBS		+=	-framework CoreAudio -framework AudioUnit -framework AudioToolbox
+
+
+## TEMPORARY DIRECTORIES ##
+MOC_DIR			=	tmp-cli
+OBJECTS_DIR		=	tmp-cli
+
+
+## TARGET NAME ##
+TARGET			=	qpitch-cli
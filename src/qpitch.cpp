@@ -25,18 +25,21 @@
 #include "qaboutdlg.h"
 #include "qsettingsdlg.h"
 #include "qpitchcore.h"
+#include "qpasoundinput.h"
 
+#include <iostream>
+
+#include <QMessageBox>
 #include <QSettings>
 #include <QTimer>
 
 // ** CONSTANTS ** //
-const int QPitch::PLOT_BUFFER_SIZE = 551;		// 44100 * 0.05 / 4 = 551.25
-													// size computed to have a time range of 50 ms with an integer downsample ratio
-													// sample rate = 44100 Hz --> downsample ratio = 4
-													// sample rate = 22050 Hz --> downsample ratio = 2
+const int QPitch::PLOT_BUFFER_SIZE = 2048;		// largest number of columns of the envelopes of the oscilloscope
+													// the 50 ms of the plot area are reduced to one column for each pixel
+													// (about 780 pixels at the default size of the window, twice on high-DPI screens)
 
 
-QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
+QPitch::QPitch( QSoundInput* soundInput, QMainWindow* parent ) : QMainWindow( parent )
 {
 	// ** SETUP THE MAIN WINDOW ** //
 	_gt.setupUi( this );
@@ -51,13 +54,48 @@ QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
 		sampleFrequency = 44100;
 	}
 
-	// restrict frame buffer size to 8192 - 4096 samples
+	// restrict frame buffer size to 8192 - 4096 - 2048 samples
 	unsigned int fftFrameSize = settings.value( "audio/buffersize", 4096 ).toUInt( );
-	if ( (fftFrameSize != 8192) && (fftFrameSize != 4096) ) {
+	if ( (fftFrameSize != 8192) && (fftFrameSize != 4096) && (fftFrameSize != 2048) ) {
 		// invalid value, set to default (4096 samples)
 		fftFrameSize = 4096;
 	}
 
+	// restrict the hop size to 4096 - 2048 - 1024 - 512 - 256 samples
+	unsigned int hopSize = settings.value( "audio/hopsize", 1024 ).toUInt( );
+	if ( (hopSize != 4096) && (hopSize != 2048) && (hopSize != 1024) && (hopSize != 512) && (hopSize != 256) ) {
+		// invalid value, set to default (1024 samples)
+		hopSize = 1024;
+	}
+
+	// restrict the peak estimation to 0 (zero-padding) - 1 (interpolation)
+	unsigned int peakEstimation = settings.value( "audio/peakestimation", QPitchCore::PEAK_INTERPOLATION ).toUInt( );
+	if ( peakEstimation > QPitchCore::PEAK_INTERPOLATION ) {
+		// invalid value, set to default (interpolation)
+		peakEstimation = QPitchCore::PEAK_INTERPOLATION;
+	}
+
+	// restrict the pitch estimator to 0 (autocorrelation) - 1 (YIN) - 2 (NSDF)
+	unsigned int pitchEstimator = settings.value( "audio/pitchestimator", QPitchCore::ESTIMATOR_AUTOCORRELATION ).toUInt( );
+	if ( pitchEstimator > QPitchCore::ESTIMATOR_NSDF ) {
+		// invalid value, set to default (autocorrelation)
+		pitchEstimator = QPitchCore::ESTIMATOR_AUTOCORRELATION;
+	}
+
+	// restrict the number of input channels to the range [1, 8]
+	unsigned int channelCount = settings.value( "audio/channelcount", 1 ).toUInt( );
+	if ( (channelCount < 1) || (channelCount > 8) ) {
+		// invalid value, set to default (mono)
+		channelCount = 1;
+	}
+
+	// restrict the lowest frequency to the range [20, 40] Hz
+	double lowestFrequency = settings.value( "audio/lowestfrequency", QTuningScale::MIN_FREQUENCY ).toDouble( );
+	if ( (lowestFrequency < QTuningScale::LOWEST_FREQUENCY) || (lowestFrequency > QTuningScale::MIN_FREQUENCY) ) {
+		// invalid value, set to default (40.0 Hz)
+		lowestFrequency = QTuningScale::MIN_FREQUENCY;
+	}
+
 	// restrict the fundamental frequency to the range [400, 480] Hz
 	double fundamentalFrequency = settings.value( "audio/fundamentalfrequency", 440.0 ).toDouble( );
 	if ( (fundamentalFrequency > 480.0) || (fundamentalFrequency <= 400.0) ) {
@@ -67,28 +105,41 @@ QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
 
 	// restrict the fundamental TuningNotation to the range 0 (US) - 1 (French) - 2 (German)
 	unsigned int tuningNotation = settings.value( "audio/tuningnotation", 0 ).toUInt( );
-	if ( tuningNotation <= QLogView::NOTATION_GERMAN ) {
+	if ( tuningNotation > QTuningScale::NOTATION_GERMAN ) {
 		// invalid value, set to default (US)
 		tuningNotation = 0;
 	}
 
 	// ** SETUP PRIVATE ITEMS ** //
 	_hRepaintTimer = new QTimer( );
+	_compactModeActivated	= false;
+	_strobeModeActivated	= false;
+	_lineEditEnabled		= false;
+	_estimatedFrequency		= 0.0;
 
 	// ** REJECT MOUSE EVENT FOR QLINEEDIT ** //
 	_gt.lineEdit_note->installEventFilter( this );
 	_gt.lineEdit_frequency->installEventFilter( this );
 
-	// ** INTIALIZE PORTAUDIO STREAM ** //
+	// ** INTIALIZE THE SOUND INPUT (PORTAUDIO STREAM BY DEFAULT) ** //
+	// (the window is still shown without a pitch detector if the sound input cannot be created)
+	_hQPitchCore = NULL;
 	try {
-		_hQPitchCore = new QPitchCore( PLOT_BUFFER_SIZE );
-	} catch ( QPaSoundInputException& e ) {
-		e.report( );
+		if ( soundInput == NULL ) {
+			soundInput = new QPaSoundInput( );
+		}
+		_hQPitchCore = new QPitchCore( soundInput, PLOT_BUFFER_SIZE );
+	} catch ( QSoundInputException& e ) {
+		reportError( e );
 	}
 
 	// ** INITIALIZE CUSTOM WIDGETS ** //
-	_gt.widget_qlogview->setTuningParameters( fundamentalFrequency, (QLogView::TuningNotation) tuningNotation );
-	_gt.widget_qosziview->setBufferSize( PLOT_BUFFER_SIZE );
+	_gt.widget_qlogview->setTuningParameters( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation );
+	_gt.widget_qlogview->setMinFrequency( lowestFrequency );
+	_gt.widget_qosziview->setMinFrequency( lowestFrequency );
+	_gt.widget_qstrobeview->setVisible( false );
+	_tuningScale.setTuningParameters( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation );
+	_tuningScale.setMinFrequency( lowestFrequency );
 
 	// ** SETUP THE CONNECTIONS ** //
 	// File menu
@@ -96,6 +147,8 @@ QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
 		this, SLOT( showPreferencesDialog() ) );
 	connect( _gt.action_compactView, SIGNAL( triggered(bool) ),
 		this, SLOT( setViewCompactMode(bool) ) );
+	connect( _gt.action_strobeMode, SIGNAL( triggered(bool) ),
+		this, SLOT( setViewStrobeMode(bool) ) );
 
 	// Help menu
 	connect( _gt.action_about, SIGNAL( triggered() ),
@@ -104,45 +157,50 @@ QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
 		qApp, SLOT( aboutQt() ) );
 
 	// Internal connections
-	connect( _hQPitchCore, SIGNAL( updatePlotSamples(const double*, double) ),
-		_gt.widget_qosziview, SLOT( setPlotSamples(const double*, double) ) );
-	connect( _hQPitchCore, SIGNAL( updatePlotAutoCorr(const double*, double) ),
-		_gt.widget_qosziview, SLOT( setPlotAutoCorr(const double*, double) ) );
-	connect( _hQPitchCore, SIGNAL( updateSignalPresence( bool ) ),
-		_gt.widget_qosziview, SLOT( setPlotEnabled(bool) ) );
-
-	connect( _hQPitchCore, SIGNAL( updateEstimatedFrequency(double) ),
-		_gt.widget_qlogview, SLOT( setEstimatedFrequency(double) ) );
-	connect( _hQPitchCore, SIGNAL( updateEstimatedFrequency(double) ),
-		_gt.widget_qlogview, SLOT( setEstimatedFrequency(double) ) );
-	connect( _hQPitchCore, SIGNAL( updateSignalPresence( bool ) ),
-		_gt.widget_qlogview, SLOT( setPlotEnabled(bool) ) );
-
-	connect( _hQPitchCore, SIGNAL( updateEstimatedFrequency(double) ),
-		this, SLOT( setEstimatedFrequency(double) ) );
-	connect( _hQPitchCore, SIGNAL( updateSignalPresence( bool ) ),
-		this, SLOT( setUpdateEnabled(bool) ) );
-
+	// (the results of the analysis are read by updateQPitchGui, so that the
+	// events posted to the GUI thread do not depend on the rate of the estimates)
 	connect( _gt.widget_qlogview, SIGNAL( updateEstimatedNote(double) ),
 		this, SLOT( setEstimatedNote(double) ) );
 
+	if ( _hQPitchCore != NULL ) {
+		connect( _hQPitchCore, SIGNAL( updateChannelPresence(unsigned int, bool) ),
+			this, SLOT( setChannelPresence(unsigned int, bool) ) );
+
+		connect( _gt.widget_qosziview, SIGNAL( updatePlotWidth(unsigned int) ),
+			_hQPitchCore, SLOT( setPlotWidth(unsigned int) ) );
+	}
+
 	connect( _hRepaintTimer, SIGNAL( timeout() ),
 		this, SLOT( updateQPitchGui() ) );
 
-	// ** START PORTAUDIO STREAM ** //
-	try {
-		Q_ASSERT( _hQPitchCore != NULL );
-		_hQPitchCore->startStream( sampleFrequency, fftFrameSize );
-	} catch ( QPaSoundInputException& e ) {
-		e.report( );
+	// ** START THE INPUT STREAM ** //
+	// (the requested parameters are kept, so that they are stored even if the stream cannot be started)
+	_requestedParameters.sampleFrequency	= sampleFrequency;
+	_requestedParameters.fftFrameSize		= fftFrameSize;
+	_requestedParameters.hopSize			= hopSize;
+	_requestedParameters.peakEstimation		= (QPitchCore::PeakEstimation) peakEstimation;
+	_requestedParameters.pitchEstimator		= (QPitchCore::PitchEstimator) pitchEstimator;
+	_requestedParameters.channelCount		= channelCount;
+	_requestedParameters.lowestFrequency	= lowestFrequency;
+	if ( _hQPitchCore != NULL ) {
+		try {
+			_hQPitchCore->startStream( sampleFrequency, fftFrameSize, hopSize, (QPitchCore::PeakEstimation) peakEstimation,
+				(QPitchCore::PitchEstimator) pitchEstimator, channelCount, lowestFrequency );
+		} catch ( QSoundInputException& e ) {
+			reportError( e );
+		}
 	}
 
 	// ** SETUP THE STATUS BAR ** //
+	// (the device is described only once its stream is open)
 	QString device;
-	_hQPitchCore->getPortAudioInfo( device );
+	if ( (_hQPitchCore != NULL) && (_hQPitchCore->isStreamStarted( ) == true) ) {
+		_hQPitchCore->getSoundInputInfo( device );
+	}
 	_sb_labelDeviceInfo.setText( device );
 	_sb_labelDeviceInfo.setIndent( 10 );
 	_gt.statusbar->addWidget( &_sb_labelDeviceInfo, 1 );
+	setupChannelLabels( );
 
 	// ** REMOVE MAXIMIZE BUTTON ** //
 	Qt::WindowFlags flags = windowFlags( );
@@ -150,19 +208,22 @@ QPitch::QPitch( QMainWindow* parent ) : QMainWindow( parent )
 	setWindowFlags( flags );
 
 	// ** START REPAINT TIMER WITH 60 FPS REFRESH RATE ** //
-	_hRepaintTimer->start( 16 );
+	// (it is stopped while the signal is absent on all the channels)
+	_hRepaintTimer->setInterval( 16 );
+	_hRepaintTimer->start( );
 }
 
 
 QPitch::~QPitch( )
 {
 	// ** ENSURE THAT THE DATA ARE VALID ** //
+	// (the pitch detector is NULL if the sound input could not be created)
 	Q_ASSERT( _hRepaintTimer	!= NULL );
-	Q_ASSERT( _hQPitchCore	!= NULL );
 
 	// ** RELEASE RESOURCES ** //
 	delete _hRepaintTimer;
 	delete _hQPitchCore;
+	qDeleteAll( _sb_labelChannel );
 }
 
 
@@ -170,6 +231,12 @@ void QPitch::setEstimatedNote( double estimatedNote )
 {
 	// ** STORE ESTIMATED NOTE ** //
 	_estimatedNote = estimatedNote;
+
+	// ** LOCK THE STROBE TO THE NOTE IDENTIFIED BY THE TUNER ** //
+	// (the core locks it only once the estimates have settled on the note)
+	if ( (_strobeModeActivated == true) && (_hQPitchCore != NULL) ) {
+		_hQPitchCore->setStrobeNote( _estimatedNote );
+	}
 }
 
 
@@ -186,11 +253,30 @@ void QPitch::setUpdateEnabled( bool enabled )
 }
 
 
+void QPitch::setChannelEstimate( unsigned int channel, double /* streamTime */, double estimatedFrequency, bool signalPresent )
+{
+	// ** STORE THE ESTIMATE OF THE CHANNEL ** //
+	// (an estimate queued before a restart of the stream may refer to a channel that is gone)
+	if ( (int) channel < _channelFrequency.size( ) ) {
+		_channelFrequency[channel] = signalPresent ? estimatedFrequency : 0.0;
+	}
+}
+
+
+void QPitch::setChannelPresence( unsigned int /* channel */, bool signalPresent )
+{
+	// ** WAKE THE REPAINT TIMER WHEN A SIGNAL APPEARS ** //
+	// (the new state is read by the next repaint, the timer stops again once all the channels are silent)
+	if ( (signalPresent == true) && (_hRepaintTimer->isActive( ) == false) ) {
+		_hRepaintTimer->start( );
+	}
+}
+
+
 void QPitch::closeEvent( QCloseEvent* /* event */ )
 {
 	// ** ENSURE THAT THE DATA ARE VALID ** //
 	Q_ASSERT( _hRepaintTimer	!= NULL );
-	Q_ASSERT( _hQPitchCore	!= NULL );
 
 	// ** STOP REFRESH ** //
 	_hRepaintTimer->stop( );
@@ -200,21 +286,26 @@ void QPitch::closeEvent( QCloseEvent* /* event */ )
 
 	// audio settings
 	QPitchParameters param;
-	_hQPitchCore->getStreamParameters( param.sampleFrequency, param.fftFrameSize );
-	_gt.widget_qlogview->getTuningParameters( param.fundamentalFrequency, param.tuningNotation );
+	getApplicationSettings( param );
 
 	settings.setValue( "audio/samplefrequency", param.sampleFrequency );
 	settings.setValue( "audio/buffersize", param.fftFrameSize );
+	settings.setValue( "audio/hopsize", param.hopSize );
+	settings.setValue( "audio/peakestimation", param.peakEstimation );
+	settings.setValue( "audio/pitchestimator", param.pitchEstimator );
+	settings.setValue( "audio/channelcount", param.channelCount );
+	settings.setValue( "audio/lowestfrequency", param.lowestFrequency );
 	settings.setValue( "audio/fundamentalfrequency", param.fundamentalFrequency );
 	settings.setValue( "audio/tuningnotation", param.tuningNotation );
 
 	// ** STOP THE INPUT STREAM ** //
-	try {
-		_hQPitchCore->stopStream( );
-	} catch ( QPaSoundInputException& e ) {
-		e.report( );
+	if ( (_hQPitchCore != NULL) && (_hQPitchCore->isStreamStarted( ) == true) ) {
+		try {
+			_hQPitchCore->stopStream( );
+		} catch ( QSoundInputException& e ) {
+			reportError( e );
+		}
 	}
-
 }
 
 
@@ -236,36 +327,115 @@ void QPitch::showPreferencesDialog( )
 {
 	// ** ENSURE THAT THE DATA ARE VALID ** //
 	Q_ASSERT( _hRepaintTimer	!= NULL );
-	Q_ASSERT( _hQPitchCore	!= NULL );
 
 	// ** GET CURRENT PROPERTIES ** //
 	QPitchParameters param;
-	_hQPitchCore->getStreamParameters( param.sampleFrequency, param.fftFrameSize );
-	_gt.widget_qlogview->getTuningParameters( param.fundamentalFrequency, param.tuningNotation );
+	getApplicationSettings( param );
 
 	// ** SHOW PREFERENCES DIALOG ** //
 	QSettingsDlg as( param, this );
-	connect( &as, SIGNAL( updateApplicationSettings(unsigned int, unsigned int, double, unsigned int) ),
-		this, SLOT( setApplicationSettings(unsigned int, unsigned int, double, unsigned int) ) );
+	connect( &as, SIGNAL( updateApplicationSettings(unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, double, double, unsigned int) ),
+		this, SLOT( setApplicationSettings(unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, double, double, unsigned int) ) );
 	as.exec( );
 }
 
 
-void QPitch::setApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize,
+void QPitch::setApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize, unsigned int hopSize,
+	unsigned int peakEstimation, unsigned int pitchEstimator, unsigned int channelCount, double lowestFrequency,
 	double fundamentalFrequency, unsigned int tuningNotation )
 {
 	// ** UPDATE AUDIO STREAM ** //
-	try {
-		// ** RESTART THE INPUT STREAM ** //
-		Q_ASSERT( _hQPitchCore != NULL );
-		_hQPitchCore->stopStream( );
-		_hQPitchCore->startStream( sampleFrequency, fftFrameSize );
-	} catch ( QPaSoundInputException& e ) {
-		e.report( );
+	_requestedParameters.sampleFrequency	= sampleFrequency;
+	_requestedParameters.fftFrameSize		= fftFrameSize;
+	_requestedParameters.hopSize			= hopSize;
+	_requestedParameters.peakEstimation		= (QPitchCore::PeakEstimation) peakEstimation;
+	_requestedParameters.pitchEstimator		= (QPitchCore::PitchEstimator) pitchEstimator;
+	_requestedParameters.channelCount		= channelCount;
+	_requestedParameters.lowestFrequency	= lowestFrequency;
+	if ( _hQPitchCore != NULL ) {
+		try {
+			// ** RESTART THE INPUT STREAM ** //
+			// (the previous stream may have failed to start, in which case there is nothing to stop)
+			if ( _hQPitchCore->isStreamStarted( ) == true ) {
+				_hQPitchCore->stopStream( );
+			}
+			_hQPitchCore->startStream( sampleFrequency, fftFrameSize, hopSize, (QPitchCore::PeakEstimation) peakEstimation,
+				(QPitchCore::PitchEstimator) pitchEstimator, channelCount, lowestFrequency );
+		} catch ( QSoundInputException& e ) {
+			reportError( e );
+		}
 	}
+	setupChannelLabels( );
+
+	// ** CLEAR THE VIEWS OF THE PREVIOUS STREAM ** //
+	// the repaint timer stops since no channel of the new stream has a signal yet, so the views
+	// are disabled here and enabled again by the first state of the new stream with a signal
+	setUpdateEnabled( false );
+	_gt.lineEdit_note->clear( );
+	_gt.lineEdit_frequency->clear( );
+	_gt.widget_qosziview->setPlotEnabled( false );
+	_gt.widget_qlogview->setPlotEnabled( false );
+	_gt.widget_qstrobeview->setPlotEnabled( false );
 
 	// ** UPDATE NOTE SCALE ** //
-	_gt.widget_qlogview->setTuningParameters( fundamentalFrequency, (QLogView::TuningNotation) tuningNotation );
+	_gt.widget_qlogview->setTuningParameters( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation );
+	_gt.widget_qlogview->setMinFrequency( lowestFrequency );
+	_gt.widget_qosziview->setMinFrequency( lowestFrequency );
+	_tuningScale.setTuningParameters( fundamentalFrequency, (QTuningScale::TuningNotation) tuningNotation );
+	_tuningScale.setMinFrequency( lowestFrequency );
+}
+
+
+
+void QPitch::reportError( const QSoundInputException& e )
+{
+	// ** SHOW THE ERROR TO THE USER ** //
+	QMessageBox::critical( this, "QPitch", QString( "%1." ).arg( e.what( ) ) );
+	std::cerr << e.what( ) << "\n";
+}
+
+
+void QPitch::getApplicationSettings( QPitchParameters& param ) const
+{
+	// ** RETRIEVE THE PARAMETERS OF THE STREAM ** //
+	// (the requested ones if the stream could not be started, the sound input may impose others otherwise)
+	param = _requestedParameters;
+	if ( (_hQPitchCore != NULL) && (_hQPitchCore->isStreamStarted( ) == true) ) {
+		_hQPitchCore->getStreamParameters( param.sampleFrequency, param.fftFrameSize, param.hopSize, param.peakEstimation,
+			param.pitchEstimator, param.channelCount, param.lowestFrequency );
+	}
+
+	// ** RETRIEVE THE PARAMETERS OF THE NOTE SCALE ** //
+	_gt.widget_qlogview->getTuningParameters( param.fundamentalFrequency, param.tuningNotation );
+}
+
+
+void QPitch::setupChannelLabels( )
+{
+	// ** RETRIEVE THE NUMBER OF CHANNELS OF THE STREAM ** //
+	// (no channel is analysed, and thus read by updateQPitchGui, if the stream could not be started)
+	QPitchParameters param;
+	param.channelCount = 0;
+	if ( (_hQPitchCore != NULL) && (_hQPitchCore->isStreamStarted( ) == true) ) {
+		_hQPitchCore->getStreamParameters( param.sampleFrequency, param.fftFrameSize, param.hopSize, param.peakEstimation,
+			param.pitchEstimator, param.channelCount, param.lowestFrequency );
+	}
+
+	// ** REPLACE THE LABELS OF THE PREVIOUS STREAM ** //
+	// the main tuner displays the first channel, so a mono stream needs no label
+	qDeleteAll( _sb_labelChannel );
+	_sb_labelChannel.clear( );
+	_channelFrequency.fill( 0.0, param.channelCount );
+	_channelPresence.fill( false, param.channelCount );
+
+	if ( param.channelCount > 1 ) {
+		for ( unsigned int c = 0 ; c < param.channelCount ; ++c ) {
+			QLabel* label = new QLabel( );
+			label->setMinimumWidth( 90 );
+			_gt.statusbar->addPermanentWidget( label );
+			_sb_labelChannel.append( label );
+		}
+	}
 }
 
 
@@ -281,27 +451,91 @@ void QPitch::showAboutDialog( )
 void QPitch::setViewCompactMode( bool enabled )
 {
 	// ** MANAGE COMPACT MODE ** //
+	// the lower widget is the strobe in strobe mode
+	QWidget* lowerView = (_strobeModeActivated == true) ? (QWidget*) _gt.widget_qstrobeview : (QWidget*) _gt.widget_qosziview;
 	if ( enabled == true ) {
-		setMinimumSize(800, 600 - _gt.widget_qosziview->height( ) - 6 );
-		setMaximumSize(800, 600 - _gt.widget_qosziview->height( ) - 6 );
-		_gt.widget_qosziview->setVisible( false );
+		setMinimumSize(800, 600 - lowerView->height( ) - 6 );
+		setMaximumSize(800, 600 - lowerView->height( ) - 6 );
+		lowerView->setVisible( false );
 		_compactModeActivated = true;
+
+		// the window is resized by the next repaint, so wake the timer if it is stopped
+		_hRepaintTimer->start( );
 	} else {
-		_gt.widget_qosziview->setVisible( true );
+		lowerView->setVisible( true );
 		setMinimumSize(800, 600);
 		setMaximumSize(800, 600);
 	}
 }
 
+
+void QPitch::setViewStrobeMode( bool enabled )
+{
+	// ** SWAP THE OSCILLOSCOPE AND THE STROBE (NONE IS DISPLAYED IN COMPACT MODE) ** //
+	_strobeModeActivated = enabled;
+	if ( _gt.action_compactView->isChecked( ) == false ) {
+		_gt.widget_qosziview->setVisible( ! enabled );
+		_gt.widget_qstrobeview->setVisible( enabled );
+	}
+
+	// ** RELEASE THE STROBE (THE NEXT ESTIMATED NOTE LOCKS IT OTHERWISE) ** //
+	if ( (enabled == false) && (_hQPitchCore != NULL) ) {
+		_hQPitchCore->setStrobeNote( 0.0 );
+	}
+}
+
 void QPitch::updateQPitchGui( )
 {
-	// ** UPDATE WIDGETS ** //
-	_gt.widget_qosziview->update( );
-	_gt.widget_qlogview->update( );
+	// ** READ THE LATEST STATE OF THE ANALYSIS ** //
+	// only the last state of each channel is read, however many frames have been analysed since the last repaint
+	// (there is no channel to read if the stream could not be started, see setupChannelLabels)
+	QPitchCore::ChannelState state;
+	bool stateUpdated = false;
+	for ( int c = 0 ; c < _channelFrequency.size( ) ; ++c ) {
+		if ( _hQPitchCore->latestState( c, state ) == false ) {
+			continue;
+		}
+		stateUpdated			= true;
+		_channelPresence[c]		= state.signalPresent;
+
+		// the views display the first channel
+		if ( c == 0 ) {
+			setUpdateEnabled( state.signalPresent );
+			_gt.widget_qosziview->setPlotEnabled( state.signalPresent );
+			_gt.widget_qlogview->setPlotEnabled( state.signalPresent );
+			_gt.widget_qstrobeview->setPlotEnabled( state.signalPresent );
+
+			if ( state.signalPresent == true ) {
+				setEstimatedFrequency( state.estimatedFrequency );
+				_gt.widget_qlogview->setEstimatedFrequency( state.estimatedFrequency );
+				_gt.widget_qstrobeview->setStrobe( state.strobeNote, state.strobeFrequency, state.strobePhase );
+			}
+			if ( state.frame ) {
+				_gt.widget_qosziview->setPlotFrame( state.frame );
+			}
+		}
+		setChannelEstimate( c, state.streamTime, state.estimatedFrequency, state.signalPresent );
+	}
+
+	// ** STOP THE TIMER WHILE ALL THE CHANNELS ARE SILENT ** //
+	// (the views repaint themselves when their data change, and updateChannelPresence starts the timer again)
+	if ( _channelPresence.contains( true ) == false ) {
+		_hRepaintTimer->stop( );
+	}
+
+	if ( _compactModeActivated == true ) {
+		resize( minimumSize( ) );
+		_compactModeActivated = false;
+	}
+
+	// nothing to display if the analysis has not published any new state
+	if ( stateUpdated == false ) {
+		return;
+	}
 
 	if ( _lineEditEnabled == true ) {
 		// ** UPDATE LABELS ** //
-		if ( (_estimatedFrequency < 40.0) || (_estimatedFrequency > 2000.0) ) {
+		if ( (_estimatedFrequency < _tuningScale.minFrequency( )) || (_estimatedFrequency > QTuningScale::MAX_FREQUENCY) ) {
 			// if frequencies are out of range clear widgets
 			_gt.lineEdit_note->clear( );
 			_gt.lineEdit_frequency->clear( );
@@ -311,9 +545,17 @@ void QPitch::updateQPitchGui( )
 		}
 	}
 
-	if ( _compactModeActivated == true ) {
-		resize( minimumSize( ) );
-		_compactModeActivated = false;
+	// ** UPDATE THE ESTIMATES OF THE CHANNELS ** //
+	for ( int c = 0 ; c < _sb_labelChannel.size( ) ; ++c ) {
+		int		note;
+		int		octave;
+		double	deviation;
+		if ( _tuningScale.findNote( _channelFrequency[c], note, octave, deviation ) ) {
+			_sb_labelChannel[c]->setText( QString( "%1: %2%3 %4%5" ).arg( c + 1 ).arg( _tuningScale.noteLabel( note ) ).arg( octave )
+				.arg( (deviation < 0.0) ? "" : "+" ).arg( 100.0 * deviation, 0, 'f', 1 ) );
+		} else {
+			_sb_labelChannel[c]->setText( QString( "%1: -" ).arg( c + 1 ) );
+		}
 	}
 }
 
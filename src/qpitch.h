@@ -24,10 +24,14 @@
 #define __QPITCH_H_
 
 #include "ui_qpitch.h"
+#include "qsettingsdlg.h"
+#include "qtuningscale.h"
 
 #include <QMainWindow>
+#include <QVector>
 
-class QPitchCore;
+class QSoundInput;
+class QSoundInputException;
 class QTimer;
 
 
@@ -45,9 +49,10 @@ class QPitch : public QMainWindow {
 public: /* methods */
 	//! Deafult constructor.
 	/*!
+	 * \param[in] soundInput the source of the audio stream (default NULL to use PortAudio)
 	 * \param[in] parent handle to the parent widget
 	 */
-	QPitch( QMainWindow* parent = 0 );
+	QPitch( QSoundInput* soundInput = NULL, QMainWindow* parent = 0 );
 
 	//! Deafult destructor.
 	~QPitch( );
@@ -72,6 +77,22 @@ public slots:
 	 */
 	void setUpdateEnabled( bool enabled );
 
+	//! Update the stored estimate of one channel of the audio stream.
+	/*!
+	 * \param[in] channel the index of the channel
+	 * \param[in] streamTime the time of the estimate measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence of the channel
+	 */
+	void setChannelEstimate( unsigned int channel, double streamTime, double estimatedFrequency, bool signalPresent );
+
+	//! Restart the repaint of the GUI when the signal of a channel appears.
+	/*!
+	 * \param[in] channel the index of the channel
+	 * \param[in] signalPresent flag with the new signal presence of the channel
+	 */
+	void setChannelPresence( unsigned int channel, bool signalPresent );
+
 
 protected: /* methods */
 	//! Function called when the main window is closed.
@@ -90,25 +111,31 @@ protected: /* methods */
 
 private: /* static constants */
 	// ** BUFFER SIZE ** //
-	static const int	PLOT_BUFFER_SIZE;				//!< Size of the buffers used for visualization
+	static const int	PLOT_BUFFER_SIZE;				//!< Largest number of columns of the envelopes used for visualization
 
 
 private: /* members */
 	// ** Qt WIDGETS ** //
 	Ui::QPitch		_gt;							//!< Mainwindow created with Qt-Designer
-	QPitchCore*		_hQPitchCore;					//!< Handle to the working thread
+	QPitchCore*		_hQPitchCore;					//!< Handle to the pitch detector
 
 	// ** STATUS BAR ITEMS ** //
 	QLabel				_sb_labelDeviceInfo;			//!< Label with the device information
+	QVector<QLabel*>	_sb_labelChannel;				//!< Labels with the estimate of each channel, side by side (multichannel streams only)
 
 	// ** UPDATE TIMERS ** //
-	QTimer*				_hRepaintTimer;					//!< Support timer to trigger the repaint of children
+	QTimer*				_hRepaintTimer;					//!< Support timer to read the state of the analysis (stopped while all the channels are silent)
 	bool				_lineEditEnabled;				//!< Flag to disable the update of the frequency estimation
 	bool				_compactModeActivated;			//!< Flag to request a widget resize to the compact mode
+	bool				_strobeModeActivated;			//!< Flag to lock the strobe to the estimated note and display it instead of the oscilloscope
 
 	// ** PITCH ESTIMATION ** //
 	double				_estimatedFrequency;			//!< Estimated frequency for the input signal
 	double				_estimatedNote;					//!< Estimated note closest to the estimated frequency
+	QVector<double>		_channelFrequency;				//!< Last estimated frequency of each channel (0 without signal)
+	QVector<bool>		_channelPresence;				//!< Last signal presence read for each channel (the repaint timer stops when none is present)
+	QTuningScale		_tuningScale;					//!< Note scale used to label the estimates of the channels
+	QPitchParameters	_requestedParameters;			//!< Parameters requested for the stream (stored even if the stream could not be started)
 
 private slots:
 	//! Open a dialog to configure the application settings.
@@ -121,10 +148,16 @@ private slots:
 	/*!
 	 * \param[in] sampleFrequency requested sample frequency
 	 * \param[in] fftFrameSize requested size of the buffer used to compute the FFT
+	 * \param[in] hopSize requested number of new samples between two consecutive estimates
+	 * \param[in] peakEstimation requested method used to locate the peak of the autocorrelation
+	 * \param[in] pitchEstimator requested algorithm used to estimate the pitch
+	 * \param[in] channelCount requested number of input channels
+	 * \param[in] lowestFrequency requested lowest frequency identified as a note
 	 * \param[in] fundamentalFrequency requested fundamental frequency of the note A4
 	 * \param[in] tuningNotation requested tuning notation
 	 */
-	void setApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize,
+	void setApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize, unsigned int hopSize,
+		unsigned int peakEstimation, unsigned int pitchEstimator, unsigned int channelCount, double lowestFrequency,
 		double fundamentalFrequency, unsigned int tuningNotation );
 
 	//! Set the compactmode for the application hiding the oscilloscope widget.
@@ -133,8 +166,30 @@ private slots:
 	 */
 	void setViewCompactMode( bool enabled );
 
+	//! Set the strobe mode, following the estimated note with the strobe displayed instead of the oscilloscope widget.
+	/*!
+	 * \param[in] enabled flag controlling the strobe mode
+	 */
+	void setViewStrobeMode( bool enabled );
+
 	//! Update all the elements in the GUI.
 	void updateQPitchGui( );
+
+private: /* methods */
+	//! Report an error of the sound input to the user.
+	/*!
+	 * \param[in] e the exception thrown by the sound input
+	 */
+	void reportError( const QSoundInputException& e );
+
+	//! Retrieve the current application settings.
+	/*!
+	 * \param[out] param the parameters of the stream (the requested ones if it could not be started) and of the note scale
+	 */
+	void getApplicationSettings( QPitchParameters& param ) const;
+
+	//! Create a label in the status bar for each channel of the stream (none for a mono stream).
+	void setupChannelLabels( );
 };
 
 #endif /* __QPITCH_H_ */
@@ -12,15 +12,20 @@ CONFIG			+=	debug warn_on
 # create a release version
 #CONFIG			+=	release warn_off
 
+# use the single precision FFTW library (fftw3f) for the analysis
+#CONFIG			+=	fftw_float
+
 
 ## FILES AND DIRECTORIES ##
+include( qpitchcore.pri )
+
 HEADERS			+=	\
 					qaboutdlg.h \
 					qlogview.h \
 					qosziview.h \
 					qpitch.h \
-					qpitchcore.h \
-					qsettingsdlg.h
+					qsettingsdlg.h \
+					qstrobeview.h
 
 SOURCES			+=	\
 					main.cpp \
@@ -28,8 +33,8 @@ SOURCES			+=	\
 					qlogview.cpp \
 					qosziview.cpp \
 					qpitch.cpp \
-					qpitchcore.cpp \
-					qsettingsdlg.cpp
+					qsettingsdlg.cpp \
+					qstrobeview.cpp
 
 FORMS			+=	\
 					ui/qaboutdlg.ui \
@@ -45,7 +50,12 @@ mac:ICON		=	ui/icons/qpitch.icns
 
 
 ## LIBRARIES ##
-unix:LIBS		+=	-lportaudio -lfftw3
+fftw_float {
+	DEFINES		+=	QPITCH_FFTW_FLOAT
+	unix:LIBS	+=	-lportaudio -lfftw3f
+} else {
+	unix:LIBS	+=	-lportaudio -lfftw3
+}
 
 mac:INCLUDEPATH	+=	/Users/willy/Sviluppo/PortAudio/portaudio/include \
 					/sw/include/
@@ -61,6 +71,8 @@ win32:INCLUDEPATH	+=	C:\Development\fftw-3.1.2-dll \
 win32:LIBS		+=	C:\Development\portaudio\build\msvc\Win32\Release\portaudio_x86.lib \
 					C:\Development\fftw-3.1.2-dll\libfftw3-3.lib
 
+fftw_float:win32:LIBS	+=	C:\Development\fftw-3.1.2-dll\libfftw3f-3.lib
+
 
 ## TEMPORARY DIRECTORIES ##
 UI_DIR			=	ui
@@ -0,0 +1,50 @@
+# .pro configuration file for the benchmark of the pitch detection algorithm
+TEMPLATE		=	app
+
+
+## CONFIGURATIONS ##
+CONFIG			+=	qt thread console
+CONFIG			-=	app_bundle
+QT				-=	gui
+
+# create a release version (the benchmark is meaningless in debug)
+CONFIG			+=	release warn_on
+
+# use the single precision FFTW library (fftw3f) for the analysis
+#CONFIG			+=	fftw_float
+
+# time each stage of the pitch detection algorithm
+DEFINES			+=	QPITCH_STAGE_TIMING
+
+
+## FILES AND DIRECTORIES ##
+include( qpitchcore.pri )
+
+HEADERS			+=	\
+					qbenchsoundinput.h \
+					qpitchregression.h
+
+SOURCES			+=	\
+					qpitchbench.cpp \
+					qpitchregression.cpp
+
+
+## LIBRARIES ##
+# the shared core includes the PortAudio input
+fftw_float {
+	DEFINES		+=	QPITCH_FFTW_FLOAT
+	unix:LIBS	+=	-lportaudio -lfftw3f
+} else {
+	unix:LIBS	+=	-lportaudio -lfftw3
+}
+
+mac:LIBS		+=	-framework CoreAudio -framework AudioUnit -framework AudioToolbox
+
+
+## TEMPORARY DIRECTORIES ##
+MOC_DIR			=	tmp-bench
+OBJECTS_DIR		=	tmp-bench
+
+
+## TARGET NAME ##
+TARGET			=	qpitch_bench
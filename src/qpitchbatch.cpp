@@ -0,0 +1,244 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchbatch.h"
+#include "qwavsoundinput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtNumeric>
+
+
+QPitchBatchTask::QPitchBatchTask( const QPitchBatch* batch, QPitchFileReport* report ) : QObject( ), QRunnable( )
+{
+	// ** ENSURE THAT THE DATA ARE VALID ** //
+	Q_ASSERT( batch		!= NULL );
+	Q_ASSERT( report	!= NULL );
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_batch	= batch;
+	_report	= report;
+}
+
+
+void QPitchBatchTask::run( )
+{
+	// ** ANALYSE THE WHOLE FILE IN THE THREAD OF THE POOL ** //
+	QPitchCore core( new QWavSoundInput( _report->fileName ) );
+	core.setAdaptiveFrame( _batch->_adaptiveFrame );
+	connect( &core, SIGNAL( updateTimedEstimate(double, double, bool) ),
+		this, SLOT( collectEstimate(double, double, bool) ), Qt::DirectConnection );
+
+	try {
+		// the lowest note of the scale is the lowest frequency that must be estimated
+		core.analyseStream( 44100, _batch->_fftFrameSize, _batch->_hopSize, _batch->_peakEstimation, _batch->_pitchEstimator,
+			1, _batch->_tuningScale.minFrequency( ) );
+		_report->duration = core.getStreamTime( );
+	} catch ( QSoundInputException& e ) {
+		_report->error = e.what( );
+		return;
+	}
+
+	// ** SUMMARIZE THE ESTIMATES ** //
+	_report->estimateCount = _estimates.size( );
+	if ( _estimates.isEmpty( ) ) {
+		return;
+	}
+
+	std::sort( _estimates.begin( ), _estimates.end( ) );
+	_report->frequency = _estimates[_estimates.size( ) / 2];
+
+	double variance = 0.0;
+	for ( int k = 0 ; k < _estimates.size( ) ; ++k ) {
+		const double cents = 1200.0 * log( _estimates[k] / _report->frequency ) / log( 2.0 );
+		variance += cents * cents;
+	}
+	_report->spread = sqrt( variance / _estimates.size( ) );
+}
+
+
+void QPitchBatchTask::collectEstimate( double /* streamTime */, double estimatedFrequency, bool signalPresent )
+{
+	// ** STORE THE ESTIMATES OF THE SIGNAL ABOVE THE THRESHOLD ** //
+	// (the frames without periodicity have no estimate, so they would spoil the median and the spread)
+	if ( signalPresent && qIsFinite( estimatedFrequency ) && (estimatedFrequency > 0.0) ) {
+		_estimates.append( estimatedFrequency );
+	}
+}
+
+
+QPitchBatch::QPitchBatch( const QStringList& fileNames, const unsigned int fftFrameSize, const bool adaptiveFrame, const unsigned int hopSize,
+	const QPitchCore::PeakEstimation peakEstimation, const QPitchCore::PitchEstimator pitchEstimator, const QTuningScale& tuningScale,
+	const QPitchCli::OutputFormat outputFormat )
+{
+	// ** EXPAND THE DIRECTORIES TO THEIR WAV FILES ** //
+	for ( int k = 0 ; k < fileNames.size( ) ; ++k ) {
+		if ( QFileInfo( fileNames[k] ).isDir( ) ) {
+			const QDir dir( fileNames[k] );
+			const QStringList entries = dir.entryList( QStringList( ) << "*.wav" << "*.WAV", QDir::Files | QDir::Readable, QDir::Name );
+			for ( int j = 0 ; j < entries.size( ) ; ++j ) {
+				_fileNames.append( dir.filePath( entries[j] ) );
+			}
+		} else {
+			_fileNames.append( fileNames[k] );
+		}
+	}
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_fftFrameSize	= fftFrameSize;
+	_adaptiveFrame	= adaptiveFrame;
+	_hopSize		= hopSize;
+	_peakEstimation	= peakEstimation;
+	_pitchEstimator	= pitchEstimator;
+	_tuningScale	= tuningScale;
+	_outputFormat	= outputFormat;
+}
+
+
+int QPitchBatch::run( const int threadCount )
+{
+	QElapsedTimer wallClock;
+	wallClock.start( );
+
+	// ** ANALYSE THE FILES CONCURRENTLY ** //
+	// the reports are preallocated, so that each task writes only its own one
+	QVector<QPitchFileReport> reports( _fileNames.size( ) );
+	QThreadPool pool;
+	pool.setMaxThreadCount( (threadCount > 0) ? threadCount : QThread::idealThreadCount( ) );
+	for ( int k = 0 ; k < _fileNames.size( ) ; ++k ) {
+		reports[k].fileName			= _fileNames[k];
+		reports[k].duration			= 0.0;
+		reports[k].estimateCount	= 0;
+		reports[k].frequency		= 0.0;
+		reports[k].spread			= 0.0;
+		pool.start( new QPitchBatchTask( this, &reports[k] ) );
+	}
+	pool.waitForDone( );
+
+	// ** WRITE THE REPORTS IN THE ORDER OF THE LIST ** //
+	if ( _outputFormat == QPitchCli::FORMAT_CSV ) {
+		std::cout << "file,duration,estimates,frequency,note,cents,spread,error" << std::endl;
+	}
+
+	int failedCount = 0;
+	double audioTime = 0.0;
+	for ( int k = 0 ; k < reports.size( ) ; ++k ) {
+		writeReport( reports[k] );
+		audioTime += reports[k].duration;
+		if ( ! reports[k].error.isEmpty( ) ) {
+			++failedCount;
+		}
+	}
+
+	// ** WRITE THE AGGREGATE SUMMARY ** //
+	const double wallTime = qMax( wallClock.nsecsElapsed( ) * 1e-9, 1e-9 );
+	std::cerr << QString( "QPitch: analysed %1 files (%2 failed), %3 s of audio in %4 s with %5 threads (%6 times real time)\n" )
+		.arg( reports.size( ) ).arg( failedCount ).arg( audioTime, 0, 'f', 2 ).arg( wallTime, 0, 'f', 3 )
+		.arg( pool.maxThreadCount( ) ).arg( audioTime / wallTime, 0, 'f', 1 ).toLocal8Bit( ).constData( );
+
+	return failedCount;
+}
+
+
+//! Quote a string as a JSON string, escaping the quotes, the backslashes and the control characters.
+/*!
+ * \param[in] text the string to quote
+ * \return the quoted string
+ */
+static QString jsonString( const QString& text )
+{
+	QString quoted = "\"";
+	for ( int k = 0 ; k < text.size( ) ; ++k ) {
+		const QChar c = text[k];
+		if ( (c == '\\') || (c == '"') ) {
+			quoted += '\\';
+			quoted += c;
+		} else if ( c.unicode( ) < 0x20 ) {
+			// U+0000 to U+001F are not allowed in a JSON string
+			quoted += QString( "\\u%1" ).arg( c.unicode( ), 4, 16, QChar( '0' ) );
+		} else {
+			quoted += c;
+		}
+	}
+	return quoted + "\"";
+}
+
+
+void QPitchBatch::writeReport( const QPitchFileReport& report ) const
+{
+	// ** FIND THE NEAREST NOTE ** //
+	int		note;
+	int		octave;
+	double	deviation;
+	const bool noteFound = (report.estimateCount > 0) && _tuningScale.findNote( report.frequency, note, octave, deviation );
+
+	// ** FORMAT THE REPORT ** //
+	// the strings are quoted and escaped, the fields without a meaningful value are left empty (CSV) or null (JSON)
+	const bool json = (_outputFormat == QPitchCli::FORMAT_JSON);
+	const QString emptyField = json ? "null" : "";
+	QString fileName	= report.fileName;
+	QString error		= report.error;
+	if ( json ) {
+		fileName	= jsonString( fileName );
+		error		= error.isEmpty( ) ? emptyField : jsonString( error );
+	} else {
+		fileName	= "\"" + fileName.replace( "\"", "\"\"" ) + "\"";
+		error		= error.isEmpty( ) ? emptyField : "\"" + error.replace( "\"", "\"\"" ) + "\"";
+	}
+
+	const QString duration	= QString::number( report.duration, 'f', 3 );
+	const QString estimates	= QString::number( report.estimateCount );
+	QString frequency		= emptyField;
+	QString spread			= emptyField;
+	QString noteLabel		= emptyField;
+	QString cents			= emptyField;
+	if ( report.estimateCount > 0 ) {
+		frequency	= QString::number( report.frequency, 'f', 2 );
+		spread		= QString::number( report.spread, 'f', 1 );
+	}
+	if ( noteFound ) {
+		noteLabel	= _tuningScale.noteLabel( note ) + QString::number( octave );
+		cents		= QString::number( 100.0 * deviation, 'f', 1 );
+		if ( json ) {
+			noteLabel = "\"" + noteLabel + "\"";
+		}
+	}
+
+	QString line;
+	if ( json ) {
+		line = QString( "{\"file\":%1,\"duration\":%2,\"estimates\":%3,\"frequency\":%4,\"note\":%5," )
+			.arg( fileName, duration, estimates, frequency, noteLabel ) +
+			QString( "\"cents\":%1,\"spread\":%2,\"error\":%3}" ).arg( cents, spread, error );
+	} else {
+		line = QString( "%1,%2,%3,%4,%5," ).arg( fileName, duration, estimates, frequency, noteLabel ) +
+			QString( "%1,%2,%3" ).arg( cents, spread, error );
+	}
+
+	std::cout << line.toUtf8( ).constData( ) << std::endl;
+}
@@ -0,0 +1,146 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHBATCH_H_
+#define __QPITCHBATCH_H_
+
+#include <QObject>
+#include <QRunnable>
+#include <QStringList>
+#include <QVector>
+
+#include "qpitchcli.h"
+#include "qpitchcore.h"
+#include "qtuningscale.h"
+
+
+//! Structure holding the result of the analysis of a single file
+struct QPitchFileReport {
+	QString			fileName;				//!< Name of the file
+	QString			error;					//!< Error raised while reading the file (empty on success)
+	double			duration;				//!< Duration of the file (in seconds)
+	unsigned int	estimateCount;			//!< Number of estimates with a signal above the threshold and a periodicity (finite and positive)
+	double			frequency;				//!< Median of the estimated frequencies (0 without estimates)
+	double			spread;					//!< Standard deviation of the estimates around the median (in cents)
+};
+
+
+class QPitchBatch;
+
+
+//! Analysis of a single file of a batch.
+/*!
+ * The file is analysed by a QPitchCore owned by the task, which pulls
+ * the samples in the thread of the pool, so that each worker has its
+ * own buffers and only the FFTW plans (created under the planner mutex
+ * of the plan cache) are shared.
+ */
+
+class QPitchBatchTask : public QObject, public QRunnable {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] batch the batch with the parameters of the analysis
+	 * \param[out] report the structure filled with the result of the analysis
+	 */
+	QPitchBatchTask( const QPitchBatch* batch, QPitchFileReport* report );
+
+	//! Analyse the file.
+	virtual void run( );
+
+
+public slots:
+	//! Collect a new estimate of the file.
+	/*!
+	 * \param[in] streamTime the time of the estimate measured from the start of the file (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence
+	 */
+	void collectEstimate( double streamTime, double estimatedFrequency, bool signalPresent );
+
+
+private: /* members */
+	const QPitchBatch*	_batch;						//!< Batch with the parameters of the analysis
+	QPitchFileReport*	_report;					//!< Result of the analysis
+	QVector<double>		_estimates;					//!< Estimated frequencies collected during the analysis
+};
+
+
+//! Batch analysis of many recordings.
+/*!
+ * This class analyses a list of WAV files concurrently on a thread pool,
+ * one file for each task, and writes one report for each file (median
+ * pitch, nearest note, deviation in cents and spread of the estimates)
+ * in the order of the list, followed by an aggregate summary on the
+ * standard error.
+ */
+
+class QPitchBatch {
+	friend class QPitchBatchTask;
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] fileNames the list of files or directories (whose WAV files are analysed)
+	 * \param[in] fftFrameSize the size of the (largest) frame used to compute the FFT and the note pitch
+	 * \param[in] adaptiveFrame true to choose the size of each frame from the previous estimate
+	 * \param[in] hopSize the number of new samples between two consecutive estimates
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch
+	 * \param[in] tuningScale the note scale used to find the nearest note (its lowest note is the lowest frequency analysed)
+	 * \param[in] outputFormat the format of the reports written to the standard output
+	 */
+	QPitchBatch( const QStringList& fileNames, const unsigned int fftFrameSize, const bool adaptiveFrame, const unsigned int hopSize,
+		const QPitchCore::PeakEstimation peakEstimation, const QPitchCore::PitchEstimator pitchEstimator, const QTuningScale& tuningScale,
+		const QPitchCli::OutputFormat outputFormat );
+
+	//! Analyse all the files and write the reports.
+	/*!
+	 * \param[in] threadCount the number of files analysed concurrently (0 to use all the cores)
+	 * \return the number of files that could not be analysed
+	 */
+	int run( const int threadCount = 0 );
+
+
+private: /* members */
+	QStringList					_fileNames;				//!< Files to analyse
+	unsigned int				_fftFrameSize;			//!< Size of the (largest) frame used to compute the FFT
+	bool						_adaptiveFrame;			//!< True when the size of each frame is chosen from the previous estimate
+	unsigned int				_hopSize;				//!< Number of new samples between two consecutive estimates
+	QPitchCore::PeakEstimation	_peakEstimation;		//!< Method used to locate the peak of the autocorrelation
+	QPitchCore::PitchEstimator	_pitchEstimator;		//!< Algorithm used to estimate the pitch
+	QTuningScale				_tuningScale;			//!< Note scale used to find the nearest note
+	QPitchCli::OutputFormat		_outputFormat;			//!< Format of the reports written to the standard output
+
+private: /* methods */
+	//! Write the report of a file to the standard output.
+	/*!
+	 * \param[in] report the result of the analysis of the file
+	 */
+	void writeReport( const QPitchFileReport& report ) const;
+};
+
+#endif /* __QPITCHBATCH_H_ */
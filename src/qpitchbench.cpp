@@ -0,0 +1,228 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+#include <cmath>
+#include <iostream>
+
+#include "qbenchsoundinput.h"
+#include "qfftwplancache.h"
+#include "qpitchcore.h"
+#include "qpitchengine.h"
+#include "qpitchregression.h"
+
+#ifndef QPITCH_STAGE_TIMING
+#error "qpitch_bench must be compiled with QPITCH_STAGE_TIMING defined"
+#endif
+
+
+int main( int argc, char *argv[] )
+{
+	// ** CREATE QT APPLICATION (NO GUI) ** //
+	QCoreApplication app( argc, argv );
+
+	// ** PARSE THE COMMAND LINE ** //
+	QCommandLineParser parser;
+	parser.setApplicationDescription( "QPitch - Benchmark of the pitch detection algorithm\n"
+		"Time each stage of the algorithm for all the supported frame sizes, sample rates and estimators,\n"
+		"or check the accuracy and the speed of the algorithm on a suite of synthetic signals,\n"
+		"or measure the throughput of many concurrent sessions sharing the analysis engine." );
+	parser.addHelpOption( );
+	QCommandLineOption formatOption( "format", "Output <format>: json (JSON lines) or csv (default json).", "format", "json" );
+	QCommandLineOption durationOption( "duration", "Duration of the synthetic signal analysed for each configuration (default 20 s).", "seconds", "20" );
+	QCommandLineOption regressionOption( "regression", "Run the accuracy and speed regression suite instead of the benchmark." );
+	QCommandLineOption sessionsOption( "sessions", "Analyse <count> synthetic streams concurrently as live sessions of the shared engine instead of the benchmark.", "count" );
+	QCommandLineOption estimatorOption( "estimator", "Pitch detection <algorithm> checked by the regression suite or used by the sessions: autocorrelation, yin or nsdf.", "algorithm", "autocorrelation" );
+	QCommandLineOption peakOption( "peak-estimation", "Peak <estimation> of the autocorrelation checked by the regression suite or used by the sessions: zero-padding or interpolation.", "estimation", "interpolation" );
+	QCommandLineOption maxLoadOption( "max-load", "Fail the regression cases whose ratio between the time spent for a frame and the time between two frames is above <ratio> (default 0, the time is only reported).", "ratio", "0" );
+	parser.addOption( formatOption );
+	parser.addOption( durationOption );
+	parser.addOption( regressionOption );
+	parser.addOption( sessionsOption );
+	parser.addOption( estimatorOption );
+	parser.addOption( peakOption );
+	parser.addOption( maxLoadOption );
+	parser.process( app );
+
+	// ** RUN THE REGRESSION SUITE ** //
+	if ( parser.isSet( regressionOption ) ) {
+		const int estimatorIndex = ( QStringList( ) << "autocorrelation" << "yin" << "nsdf" ).indexOf( parser.value( estimatorOption ) );
+		const int peakIndex = ( QStringList( ) << "zero-padding" << "interpolation" ).indexOf( parser.value( peakOption ) );
+		const double maxLoad = parser.value( maxLoadOption ).toDouble( );
+		if ( (estimatorIndex < 0) || (peakIndex < 0) || (maxLoad < 0.0) ) {
+			parser.showHelp( 1 );
+		}
+
+		QPitchRegression regression( (QPitchCore::PitchEstimator) estimatorIndex, (QPitchCore::PeakEstimation) peakIndex, maxLoad );
+		return ( regression.run( ) == 0 ) ? 0 : 1;
+	}
+
+	const int outputFormat = ( QStringList( ) << "json" << "csv" ).indexOf( parser.value( formatOption ) );
+	const double duration = parser.value( durationOption ).toDouble( );
+	if ( (outputFormat < 0) || (duration <= 0.0) ) {
+		parser.showHelp( 1 );
+	}
+
+	// ** RUN CONCURRENT SESSIONS ** //
+	// each session is fed by its own thread as fast as it is analysed, like a file or a socket
+	if ( parser.isSet( sessionsOption ) ) {
+		const int sessionCount = parser.value( sessionsOption ).toInt( );
+		const int estimatorIndex = ( QStringList( ) << "autocorrelation" << "yin" << "nsdf" ).indexOf( parser.value( estimatorOption ) );
+		const int peakIndex = ( QStringList( ) << "zero-padding" << "interpolation" ).indexOf( parser.value( peakOption ) );
+		if ( (sessionCount <= 0) || (estimatorIndex < 0) || (peakIndex < 0) ) {
+			parser.showHelp( 1 );
+		}
+
+		const unsigned int	sessionFrequency	= 44100;
+		const unsigned int	sessionFrameSize	= 4096;
+		const unsigned int	sessionHopSize		= 1024;
+
+		QVector<QBenchSoundInput*>	inputs;
+		QVector<QPitchCore*>		sessions;
+		QElapsedTimer				wallClock;
+		double						audioTime = 0.0;
+		try {
+			// request the plans with a short run, then time the measured plans instead of the estimated ones
+			QPitchCore warmUp( new QBenchSoundInput( QSynthSoundInput::WAVE_HARMONICS, 82.41, 0.5 ) );
+			warmUp.analyseStream( sessionFrequency, sessionFrameSize, sessionHopSize,
+				(QPitchCore::PeakEstimation) peakIndex, (QPitchCore::PitchEstimator) estimatorIndex );
+			QFftwPlanCache::instance( )->waitForMeasuredPlans( );
+
+			// the sessions play the notes of a chromatic scale
+			for ( int k = 0 ; k < sessionCount ; ++k ) {
+				inputs.append( new QBenchSoundInput( QSynthSoundInput::WAVE_HARMONICS, 82.41 * pow( 2.0, (k % 24) / 12.0 ), duration ) );
+				inputs[k]->setRealTime( false );
+				sessions.append( new QPitchCore( inputs[k] ) );
+			}
+
+			wallClock.start( );
+			for ( int k = 0 ; k < sessionCount ; ++k ) {
+				sessions[k]->startStream( sessionFrequency, sessionFrameSize, sessionHopSize,
+					(QPitchCore::PeakEstimation) peakIndex, (QPitchCore::PitchEstimator) estimatorIndex );
+			}
+
+			// the thread of each sound input terminates at the end of its stream
+			for ( int k = 0 ; k < sessionCount ; ++k ) {
+				inputs[k]->wait( );
+				sessions[k]->stopStream( );
+				audioTime += sessions[k]->getStreamTime( );
+			}
+		} catch ( QSoundInputException& e ) {
+			std::cerr << e.what( ) << "\n";
+			return 1;
+		}
+		const double wallTime = qMax( wallClock.nsecsElapsed( ) * 1e-9, 1e-9 );
+		qDeleteAll( sessions );
+
+		QString line = ( outputFormat == 0 )
+			? QString( "{\"sessions\":%1,\"threads\":%2,\"audio_s\":%3,\"wall_s\":%4,\"realtime\":%5}" )
+			: QString( "sessions,threads,audio_s,wall_s,realtime\n%1,%2,%3,%4,%5" );
+		std::cout << line.arg( sessionCount ).arg( QPitchEngine::instance( )->threadCount( ) ).arg( audioTime, 0, 'f', 2 )
+			.arg( wallTime, 0, 'f', 3 ).arg( audioTime / wallTime, 0, 'f', 1 ).toLocal8Bit( ).constData( ) << std::endl;
+		return 0;
+	}
+
+	// ** CONFIGURATIONS ** //
+	const QSynthSoundInput::Waveform	waveform[]			= { QSynthSoundInput::WAVE_SINE, QSynthSoundInput::WAVE_HARMONICS };
+	const char*							waveformName[]		= { "sine", "harmonics" };
+	const double						frequency[]			= { 440.0, 82.41 };					// A4 and the low E of a guitar
+	const unsigned int					sampleFrequency[]	= { 22050, 44100 };
+	const unsigned int					fftFrameSize[]		= { 2048, 4096, 8192 };
+	const QPitchCore::PitchEstimator	pitchEstimator[]	= { QPitchCore::ESTIMATOR_AUTOCORRELATION, QPitchCore::ESTIMATOR_AUTOCORRELATION,
+		QPitchCore::ESTIMATOR_YIN, QPitchCore::ESTIMATOR_NSDF };
+	const QPitchCore::PeakEstimation	peakEstimation[]	= { QPitchCore::PEAK_ZERO_PADDING, QPitchCore::PEAK_INTERPOLATION,
+		QPitchCore::PEAK_INTERPOLATION, QPitchCore::PEAK_INTERPOLATION };
+	const char*							estimatorName[]		= { "acf-zero-padding", "acf-interpolation", "yin", "nsdf" };
+	const char*							stageName[]			= { "fft", "power", "padding", "ifft", "minimum", "maximum" };
+#ifdef QPITCH_FFTW_FLOAT
+	const char*							precision			= "float";
+#else
+	const char*							precision			= "double";
+#endif
+
+	if ( outputFormat == 1 ) {
+		std::cout << "precision,signal,sampleFrequency,frameSize,estimator,estimates";
+		for ( int s = 0 ; s < QPitchCore::STAGE_COUNT ; ++s ) {
+			std::cout << "," << stageName[s] << "_us";
+		}
+		std::cout << ",total_us" << std::endl;
+	}
+
+	// ** RUN THE BENCHMARK ** //
+	// the times are reported as the mean time of each stage for a single estimate (in microseconds)
+	for ( int w = 0 ; w < 2 ; ++w ) {
+		for ( int f = 0 ; f < 2 ; ++f ) {
+			for ( int n = 0 ; n < 3 ; ++n ) {
+				for ( int p = 0 ; p < 4 ; ++p ) {
+					QPitchCore warmUp( new QBenchSoundInput( waveform[w], frequency[w], 0.5 ) );
+					QPitchCore core( new QBenchSoundInput( waveform[w], frequency[w], duration ) );
+
+					// each configuration times its own frame size
+					warmUp.setAdaptiveFrame( false );
+					core.setAdaptiveFrame( false );
+
+					qint64			stageTime[QPitchCore::STAGE_COUNT];
+					unsigned int	estimateCount;
+					try {
+						// request the plans with a short run, then time the measured plans instead of the estimated ones
+						warmUp.analyseStream( sampleFrequency[f], fftFrameSize[n], fftFrameSize[n] / 4, peakEstimation[p], pitchEstimator[p] );
+						QFftwPlanCache::instance( )->waitForMeasuredPlans( );
+
+						core.analyseStream( sampleFrequency[f], fftFrameSize[n], fftFrameSize[n] / 4, peakEstimation[p], pitchEstimator[p] );
+					} catch ( QSoundInputException& e ) {
+						std::cerr << e.what( ) << "\n";
+						return 1;
+					}
+					core.getStageTimings( stageTime, estimateCount );
+
+					const double scale = 1e-3 / qMax( estimateCount, 1u );
+					double totalTime = 0.0;
+					QString line;
+					for ( int s = 0 ; s < QPitchCore::STAGE_COUNT ; ++s ) {
+						totalTime += stageTime[s] * scale;
+						line += ( outputFormat == 0 )
+							? QString( ",\"%1_us\":%2" ).arg( stageName[s] ).arg( stageTime[s] * scale, 0, 'f', 3 )
+							: QString( ",%1" ).arg( stageTime[s] * scale, 0, 'f', 3 );
+					}
+
+					if ( outputFormat == 0 ) {
+						line = QString( "{\"precision\":\"%1\",\"signal\":\"%2\",\"sampleFrequency\":%3,\"frameSize\":%4,\"estimator\":\"%5\",\"estimates\":%6" )
+							.arg( precision ).arg( waveformName[w] ).arg( sampleFrequency[f] ).arg( fftFrameSize[n] ).arg( estimatorName[p] ).arg( estimateCount )
+							+ line + QString( ",\"total_us\":%1}" ).arg( totalTime, 0, 'f', 3 );
+					} else {
+						line = QString( "%1,%2,%3,%4,%5,%6" )
+							.arg( precision ).arg( waveformName[w] ).arg( sampleFrequency[f] ).arg( fftFrameSize[n] ).arg( estimatorName[p] ).arg( estimateCount )
+							+ line + QString( ",%1" ).arg( totalTime, 0, 'f', 3 );
+					}
+					std::cout << line.toLocal8Bit( ).constData( ) << std::endl;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
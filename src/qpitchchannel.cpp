@@ -0,0 +1,522 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchchannel.h"
+#include "qdecimator.h"
+#include "qframesnapshot.h"
+#include "qpitchestimator.h"
+#include "qplotenvelope.h"
+#include "qringbuffer.h"
+#include "qsamplescanner.h"
+#include "qstrobebank.h"
+
+#include <cmath>
+#include <iostream>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const int QPitchChannel::SIGNAL_THRESHOLD_ON	= 100;
+const int QPitchChannel::SIGNAL_THRESHOLD_OFF	= 20;
+const unsigned int QPitchChannel::MIN_ADAPTIVE_FRAME_SIZE	= 1024;
+const double QPitchChannel::ADAPTIVE_FRAME_PERIODS			= 24.0;
+const double QPitchChannel::MAX_ADAPTIVE_JUMP				= 1.0 / 12.0;
+const unsigned int QPitchChannel::FULL_FRAME_INTERVAL		= 16;
+const unsigned int QPitchChannel::STROBE_LOCK_ESTIMATES		= 3;
+const unsigned int QPitchChannel::ANALYSIS_BUFFER_FRAMES	= 4;
+const double QPitchChannel::STROBE_LOCK_RANGE				= 1.0 / 24.0;
+
+
+QPitchChannel::QPitchChannel( QPitchCore* core, const unsigned int channel, const double sampleFrequency, const unsigned int decimationFactor,
+	const unsigned int bufferSize, const unsigned int ringBufferSize, const unsigned int fftFrameSize, const unsigned int hopSize,
+	const QPitchCore::PeakEstimation peakEstimation, const QPitchCore::PitchEstimator pitchEstimator,
+	const unsigned int plotData_size, const double lowestFrequency, const bool adaptiveFrame ) : QPitchTask( )
+{
+	// ** ENSURE THAT THE PARAMETERS ARE VALID ** //
+	Q_ASSERT( core != NULL );
+	Q_ASSERT( decimationFactor > 0 );
+	Q_ASSERT( (hopSize > 0) && (hopSize <= decimationFactor * fftFrameSize) );
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_core				= core;
+	_channel			= channel;
+	_sampleFrequency	= sampleFrequency / decimationFactor;
+	_block_size			= bufferSize;
+	_ringBuffer			= new QRingBuffer<short int>( ringBufferSize );
+	_streamSamples		= 0;
+
+	// ** INITIALIZE THE DECIMATION OF THE INPUT SAMPLES ** //
+	// the decimator keeps its phase between two blocks, so a block may produce one more sample
+	_decimator			= (decimationFactor > 1) ? new QDecimator( decimationFactor ) : NULL;
+	_decimatedBuffer	= (decimationFactor > 1) ? new short int[_block_size / decimationFactor + 1] : NULL;
+	_droppedSamples.storeRelaxed( 0 );
+#ifdef QPITCH_STAGE_TIMING
+	memset( _stageTime, 0, sizeof( _stageTime ) );
+	_estimateCount		= 0;
+#endif
+
+	// ** INITIALIZE THE SLIDING WINDOW ** //
+	_frame_size			= fftFrameSize;			// size of the external buffer (default 4096)
+	_frame_index		= 0;
+
+	// ** INITIALIZE THE ANALYSIS BUFFER ** //
+	// the sliding window moves along the buffer and each block is converted right after it,
+	// so the window is moved back to the start only once every few frames
+	const unsigned int analysedBlock_size = (decimationFactor > 1) ? _block_size / decimationFactor + 1 : _block_size;
+	_analysisBuffer_size	= ANALYSIS_BUFFER_FRAMES * _frame_size + analysedBlock_size;
+	_analysisBuffer			= (qfftw_real*) QFFTW( malloc )( sizeof(qfftw_real) * _analysisBuffer_size );
+	_frame					= _analysisBuffer;
+	_hopSize			= qMax( hopSize / decimationFactor, 1u );
+
+	// ** INITIALIZE THE PITCH DETECTION ALGORITHM ** //
+	// the estimators of the shorter frames are created in advance, and their plans come from the cache as well
+	_adaptiveFrame		= adaptiveFrame;
+	unsigned int estimatorFrameSize = _frame_size;
+	do {
+		QPitchEstimator* estimator = QPitchEstimator::create( pitchEstimator, peakEstimation, estimatorFrameSize, _sampleFrequency );
+#ifdef QPITCH_STAGE_TIMING
+		estimator->setStageTimings( _stageTime );
+#endif
+		_estimators.append( estimator );
+		estimatorFrameSize /= 2;
+	} while ( _adaptiveFrame && (estimatorFrameSize >= MIN_ADAPTIVE_FRAME_SIZE) );
+	_lastFrequency		= 0.0;
+
+	// ** INITIALIZE THE STROBE ** //
+	// only the first channel is displayed by the tuner, thus only its note can be locked
+	_strobeBank			= (_channel == 0) ? new QStrobeBank( _sampleFrequency ) : NULL;
+	resetFrames( );
+
+	// ** INITIALIZE TEMPORARY BUFFERS ** //
+	// only the first channel is displayed by the oscilloscope view, which spans 50 milliseconds of the input signal
+	_plotData_size		= plotData_size;
+	_plotPool			= (_plotData_size > 0) ? new QFrameSnapshotPool( _plotData_size ) : NULL;
+	_lowestFrequency	= lowestFrequency;
+	_plotSample_size	= qBound( 1u, (unsigned int) qRound( 0.05 * _sampleFrequency ), _frame_size );
+
+	unsigned int plotEnvelope_size = _plotSample_size;
+	for ( int e = 0 ; e < _estimators.size( ) ; ++e ) {
+		plotEnvelope_size = qMax( plotEnvelope_size, plotLagSize( _estimators[e] ) );
+	}
+	_plotEnvelope		= (_plotData_size > 0) ? new QPlotEnvelope( plotEnvelope_size ) : NULL;
+	_visualizationStatus = STOPPED;
+}
+
+
+QPitchChannel::~QPitchChannel( )
+{
+	// ** RELEASE RESOURCES ** //
+	QFFTW( free )( _analysisBuffer );
+	delete[]	_decimatedBuffer;
+	delete		_ringBuffer;
+	delete		_decimator;
+	delete		_strobeBank;
+	delete		_plotPool;
+	delete		_plotEnvelope;
+	qDeleteAll( _estimators );
+}
+
+
+unsigned int QPitchChannel::writeAvailable( ) const
+{
+	return _ringBuffer->writeAvailable( );
+}
+
+
+unsigned int QPitchChannel::readAvailable( ) const
+{
+	return _ringBuffer->readAvailable( );
+}
+
+
+void QPitchChannel::store( const short int* input, const unsigned int frameCount, const unsigned int channelCount )
+{
+	// ** DEINTERLEAVE THE SAMPLES OF THE CHANNEL ** //
+	unsigned int storedSamples = _ringBuffer->write( input + _channel, frameCount, channelCount );
+	Q_ASSERT( storedSamples == frameCount );
+	Q_UNUSED( storedSamples );
+}
+
+
+void QPitchChannel::addDroppedSamples( const unsigned int sampleCount )
+{
+	_droppedSamples.fetchAndAddRelaxed( sampleCount );
+}
+
+
+void QPitchChannel::run( )
+{
+	// ** DRAIN THE RING BUFFER ** //
+	// the samples are read in place, so they are released only once processed
+	const short int* first;
+	const short int* second;
+	unsigned int firstCount;
+	unsigned int frameCount;
+	while ( (frameCount = _ringBuffer->peek( first, firstCount, second, _block_size )) > 0 ) {
+		if ( _decimator != NULL ) {
+			// a block shorter than the decimation factor may not complete any analysed sample
+			unsigned int decimatedCount	= _decimator->process( first, firstCount, _decimatedBuffer );
+			decimatedCount				+= _decimator->process( second, frameCount - firstCount, _decimatedBuffer + decimatedCount );
+			if ( decimatedCount > 0 ) {
+				processInputBuffer( _decimatedBuffer, decimatedCount, NULL, 0 );
+			}
+		} else {
+			processInputBuffer( first, firstCount, second, frameCount - firstCount );
+		}
+
+		_ringBuffer->skip( frameCount );
+	}
+
+	// ** ACCOUNT FOR THE SAMPLES DROPPED BY THE CALLBACK ** //
+	// the report is delegated to the analysis since the callback must not block
+	unsigned int droppedSamples = _droppedSamples.fetchAndStoreRelaxed( 0 );
+	if ( droppedSamples > 0 ) {
+		if ( _channel == 0 ) {
+			std::cerr << "QPitch: ring buffer full, dropped " << droppedSamples << " samples!\n";
+		}
+		dropSamples( droppedSamples );
+	}
+}
+
+
+void QPitchChannel::dropSamples( const unsigned int sampleCount )
+{
+	// the partial phase of the decimator is lost too, which is below one analysed sample
+	if ( _decimator != NULL ) {
+		_decimator->reset( );
+		_streamSamples += sampleCount / _decimator->factor( );
+	} else {
+		_streamSamples += sampleCount;
+	}
+
+	// the frame is not contiguous anymore so drop all the samples in the sliding window
+	_frame_index = 0;
+	resetFrames( );
+}
+
+
+void QPitchChannel::resetFrames( )
+{
+	// ** THE NEXT FRAME IS UNRELATED TO THE LAST ONE ** //
+	// the last estimate is stale too, so the size of the frame is chosen again from the full sliding window
+	_frameLevel			= 0;
+	_adaptiveEstimates	= 0;
+
+	// the phases of the partials are lost as well, so the note must be locked again
+	_strobeLocked		= false;
+	_strobeEstimates	= 0;
+}
+
+
+unsigned int QPitchChannel::frameHopSize( const int frameLevel ) const
+{
+	// the shorter frames overlap by at least a half, so that the high notes are updated faster
+	return ( frameLevel == 0 ) ? _hopSize : qMin( _hopSize, _estimators[frameLevel]->frameSize( ) / 2 );
+}
+
+
+unsigned int QPitchChannel::plotLagSize( const QPitchEstimator* estimator ) const
+{
+	// the shorter frames have less lags than the range, which is then displayed only in part
+	return qBound( 1u, (unsigned int) qRound( _sampleFrequency / _lowestFrequency ), estimator->frameSize( ) ) * estimator->lagOversampling( );
+}
+
+
+#ifdef QPITCH_STAGE_TIMING
+void QPitchChannel::addStageTimings( qint64 stageTime[QPitchCore::STAGE_COUNT], unsigned int& estimateCount ) const
+{
+	for ( int s = 0 ; s < QPitchCore::STAGE_COUNT ; ++s ) {
+		stageTime[s] += _stageTime[s];
+	}
+	estimateCount += _estimateCount;
+}
+#endif
+
+
+void QPitchChannel::processInputBuffer( const short int* first, const unsigned int firstCount, const short int* second, const unsigned int secondCount )
+{
+	const unsigned int frameCount = firstCount + secondCount;
+
+	// ** MAKE ROOM FOR THE BLOCK AFTER THE SLIDING WINDOW ** //
+	Q_ASSERT( _frame_index + frameCount <= _analysisBuffer_size );
+	if ( (_frame_index == 0) || ((_frame - _analysisBuffer) + _frame_index + frameCount > _analysisBuffer_size) ) {
+		memmove( _analysisBuffer, _frame, _frame_index * sizeof( qfftw_real ) );
+		_frame = _analysisBuffer;
+	}
+
+	// ** SCAN THE BUFFER ** //
+	// convert the samples right after the sliding window, measuring the level of
+	// the block and finding its first rising edge accross zero in a single pass
+	qfftw_real* block = _frame + _frame_index;
+	QSampleScanner::BlockLevel level;
+	QSampleScanner::scan( first, firstCount, second, secondCount, block, level );
+
+	_state.peakLevel	= level.peak / 32768.0;
+	_state.rmsLevel		= sqrt( level.energy / frameCount ) / 32768.0;
+	emit _core->updateChannelLevel( _channel, _state.peakLevel, _state.rmsLevel );
+
+	// ** PROCESS THE BUFFER ** //
+	// extend the sliding window over the converted block and
+	// compute a new estimate each time the window is full
+
+	// trigger the signal to have the first sample on a rising edge accross zero
+	unsigned int k = 0;
+	if ( _frame_index == 0 ) {
+		k		= level.trigger;
+		_frame	= block + k;
+	}
+	unsigned int strobeIndex = k;
+
+	// check if the audio stream is below a given threshold to stop visualization
+	// (the gate is evaluated on the peak of the whole block, one callback period at a time)
+	const int threshold = ( _visualizationStatus == STOPPED ) ? SIGNAL_THRESHOLD_ON : SIGNAL_THRESHOLD_OFF;
+
+	if ( level.peak < threshold ) {
+		// the level of the signal is too low, so drop all the buffer
+		_frame_index = 0;
+		resetFrames( );
+
+		if ( _visualizationStatus == RUNNING ) {
+			_visualizationStatus = STOP_REQUEST;
+		}
+	} else {
+		if ( _visualizationStatus == STOPPED ) {
+			_visualizationStatus = START_REQUEST;
+		}
+
+		// read the buffer, processing the sliding window every hopSize samples
+		// (the block is already in place, so the window only grows up to its end)
+		while ( k < frameCount ) {
+			const unsigned int sampleCount = qMin( frameCount - k, _frame_size - _frame_index );
+			_frame_index	+= sampleCount;
+			k				+= sampleCount;
+
+			if ( _frame_index == _frame_size ) {
+				// the locked strobe receives the same samples as the sliding window, up to the end of the frame
+				if ( _strobeLocked ) {
+					_strobeBank->process( block + strobeIndex, k - strobeIndex );
+				}
+				strobeIndex = k;
+
+				processFrame( (_streamSamples + k) / _sampleFrequency );
+			}
+		}
+
+		if ( _strobeLocked ) {
+			_strobeBank->process( block + strobeIndex, frameCount - strobeIndex );
+		}
+	}
+
+	_streamSamples += frameCount;
+
+	// manage the visualization status
+	const VisualizationStatus visualizationStatus = _visualizationStatus;
+	if ( visualizationStatus == STOP_REQUEST ) {
+		_visualizationStatus		= STOPPED;
+		_state.signalPresent		= false;
+		_state.streamTime			= _streamSamples / _sampleFrequency;
+		_state.estimatedFrequency	= 0.0;
+	} else if ( visualizationStatus == START_REQUEST ) {
+		_visualizationStatus		= RUNNING;
+		_state.signalPresent		= true;
+	}
+
+	// ** PUBLISH THE STATE REACHED AT THE END OF THE BLOCK ** //
+	// (before the signals of the status, so that a reader woken by them finds the new state)
+	_latestState.write( _state );
+
+	if ( visualizationStatus == STOP_REQUEST ) {
+		if ( _channel == 0 ) {
+			emit _core->updateSignalPresence( false );
+			emit _core->updateTimedEstimate( _streamSamples / _sampleFrequency, 0.0, false );
+		}
+		emit _core->updateChannelEstimate( _channel, _streamSamples / _sampleFrequency, 0.0, false );
+		emit _core->updateChannelPresence( _channel, false );
+	} else if ( visualizationStatus == START_REQUEST ) {
+		if ( _channel == 0 ) {
+			emit _core->updateSignalPresence( true );
+		}
+		emit _core->updateChannelPresence( _channel, true );
+	}
+}
+
+
+bool QPitchChannel::latestState( QPitchCore::ChannelState& state )
+{
+	return _latestState.read( state );
+}
+
+
+void QPitchChannel::processFrame( const double frameTime )
+{
+	// ** ENSURE THAT THE SLIDING WINDOW IS FULL ** //
+	Q_ASSERT( _frame_index == _frame_size );
+
+	// the snapshot is skipped while the views still hold all of them
+	QFrameSnapshot* snapshot = (_plotPool != NULL) ? _plotPool->acquire( ) : NULL;
+
+	if ( snapshot != NULL ) {
+		// one column of the envelopes for each pixel of the plot area, as requested by the view
+		snapshot->setSize( qMin( _core->plotWidth( ), _plotData_size ) );
+
+		/*
+		 * the start of the sliding window is aligned to a rising edge only
+		 * after a silence, so trigger the plot on the first rising edge
+		 * accross zero to have a steady picture in the oscilloscope view
+		 */
+		unsigned int plotOffset = 0;
+		unsigned int plotOffset_max = _frame_size - _plotSample_size;
+		for (  ; (plotOffset < plotOffset_max) && ((_frame[plotOffset] >= 0) || (_frame[plotOffset+1] < 0)) ; ++plotOffset ) {};
+		if ( plotOffset == plotOffset_max ) {
+			plotOffset = 0;
+		}
+
+		// reduce all the samples of the time range, so that the high frequencies are not aliased
+		_plotEnvelope->reduce( _frame + plotOffset, _plotSample_size, snapshot->size( ), snapshot->sampleMinimum( ), snapshot->sampleMaximum( ) );
+		snapshot->setTimeRange( _plotSample_size / _sampleFrequency );
+	}
+
+	// follow the locked note with the strobe, which needs two blocks before its first estimate
+	QPitchEstimator* estimator = NULL;
+	double estimatedFrequency = _strobeLocked ? estimateStrobe( ) : 0.0;
+
+	if ( estimatedFrequency > 0.0 ) {
+		// the estimators skip this frame
+		_frameLevel			= 0;
+		_adaptiveEstimates	= 0;
+	} else {
+		// estimate the pitch of the most recent samples
+		estimator			= _estimators[_frameLevel];
+		estimatedFrequency	= estimateFrame( estimator );
+
+		// a jump of the estimate may be a lower note than the frame can hold, so check it with the full frame
+		if ( (_frameLevel > 0) && ( (estimatedFrequency <= 0.0) || (fabs( log2( estimatedFrequency / _lastFrequency ) ) > MAX_ADAPTIVE_JUMP) ) ) {
+			estimator			= _estimators[0];
+			estimatedFrequency	= estimateFrame( estimator );
+		}
+
+		// choose the shortest frame spanning enough periods of the estimate, with a periodic check of the full frame
+		_frameLevel = 0;
+		if ( _adaptiveFrame && (estimatedFrequency > 0.0) && (++_adaptiveEstimates < FULL_FRAME_INTERVAL) ) {
+			const double periodsSpan = ADAPTIVE_FRAME_PERIODS * _sampleFrequency / estimatedFrequency;
+			while ( (_frameLevel + 1 < _estimators.size( )) && (_estimators[_frameLevel + 1]->frameSize( ) >= periodsSpan) ) {
+				++_frameLevel;
+			}
+			_lastFrequency = estimatedFrequency;
+		} else {
+			_adaptiveEstimates = 0;
+		}
+
+		if ( (_strobeBank != NULL) && (! _strobeLocked) ) {
+			lockStrobe( estimatedFrequency );
+		}
+	}
+
+	// slide the window by the hop of the next frame
+	const unsigned int hopSize = frameHopSize( _frameLevel );
+	_frame			+= hopSize;
+	_frame_index	= _frame_size - hopSize;
+
+	if ( _channel == 0 ) {
+		emit _core->updateEstimatedFrequency( estimatedFrequency );
+		emit _core->updateTimedEstimate( frameTime, estimatedFrequency, true );
+	}
+	emit _core->updateChannelEstimate( _channel, frameTime, estimatedFrequency, true );
+
+	_state.streamTime			= frameTime;
+	_state.estimatedFrequency	= estimatedFrequency;
+
+	if ( (_strobeBank != NULL) && (_core->strobeNote( ) > 0.0) ) {
+		emit _core->updateStrobe( _strobeLocked ? _strobeBank->noteFrequency( ) : 0.0, estimatedFrequency, _strobeBank->phase( ) );
+
+		_state.strobeNote		= _strobeLocked ? _strobeBank->noteFrequency( ) : 0.0;
+		_state.strobeFrequency	= estimatedFrequency;
+		_state.strobePhase		= _strobeBank->phase( );
+	} else {
+		_state.strobeNote		= 0.0;
+		_state.strobeFrequency	= 0.0;
+		_state.strobePhase		= 0.0;
+	}
+
+	// the strobe has no lag function, so the graph keeps the last one of the estimators
+	if ( (snapshot != NULL) && (estimator != NULL) ) {
+		// reduce the autocorrelation for the oscilloscope view in the range [lowest, 1000] Hz --> [0, 1 / lowest] sec
+		// (the lags of a shorter frame fill only the first columns, so that the scale of the axis is kept)
+		const unsigned int plotLag_size		= plotLagSize( estimator );
+		const unsigned int plotRange_size	= qMax( qRound( _sampleFrequency / _lowestFrequency ), 1 ) * estimator->lagOversampling( );
+		snapshot->setAutoCorrSize( qMax( (unsigned int) ( (quint64) snapshot->size( ) * plotLag_size / plotRange_size ), 1u ) );
+		_plotEnvelope->reduce( estimator->lagFunction( ), plotLag_size, snapshot->autoCorrSize( ),
+			snapshot->autoCorrMinimum( ), snapshot->autoCorrMaximum( ) );
+	}
+
+	// publish the snapshot, which is recycled by the pool once the views release it
+	if ( snapshot != NULL ) {
+		snapshot->setEstimate( frameTime, estimatedFrequency, estimator != NULL );
+		_state.frame = QFrameSnapshotPointer( snapshot );
+		emit _core->updatePlotFrame( _state.frame );
+	}
+}
+
+
+double QPitchChannel::estimateFrame( QPitchEstimator* estimator )
+{
+	// ** ANALYSE THE MOST RECENT SAMPLES IN PLACE ** //
+	// the FFT reads the frame directly from the sliding window, which it does not modify
+#ifdef QPITCH_STAGE_TIMING
+	++_estimateCount;
+#endif
+	return estimator->estimate( _frame + _frame_size - estimator->frameSize( ) );
+}
+
+
+double QPitchChannel::estimateStrobe( )
+{
+	// ** ENSURE THAT THE STROBE IS LOCKED ** //
+	Q_ASSERT( _strobeLocked );
+
+	// ** UNLOCK WHEN THE NOTE IS LOST, OR WHEN THE REQUESTED NOTE HAS CHANGED ** //
+	const double estimatedFrequency = _strobeBank->estimate( );
+	if ( (! _strobeBank->isLocked( )) || (_core->strobeNote( ) != _strobeBank->noteFrequency( )) ) {
+		_strobeLocked		= false;
+		_strobeEstimates	= 0;
+		return 0.0;
+	}
+
+	return estimatedFrequency;
+}
+
+
+void QPitchChannel::lockStrobe( const double estimatedFrequency )
+{
+	// ** COUNT THE CONSECUTIVE ESTIMATES WITHIN THE STROBE NOTE ** //
+	const double noteFrequency = _core->strobeNote( );
+	if ( (noteFrequency > 0.0) && (estimatedFrequency > 0.0) && (fabs( log2( estimatedFrequency / noteFrequency ) ) <= STROBE_LOCK_RANGE) ) {
+		++_strobeEstimates;
+	} else {
+		_strobeEstimates = 0;
+	}
+
+	// ** SWITCH TO THE STROBE ONCE THE NOTE IS STEADY ** //
+	// (a note above the range of the analysis is never locked)
+	if ( (_strobeEstimates >= STROBE_LOCK_ESTIMATES) && _strobeBank->setNoteFrequency( noteFrequency ) ) {
+		_strobeLocked = true;
+	}
+}
@@ -0,0 +1,289 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHCHANNEL_H_
+#define __QPITCHCHANNEL_H_
+
+#include <QAtomicInteger>
+#include <QVector>
+
+#include "qfftw.h"
+#include "qlatestvalue.h"
+#include "qpitchcore.h"
+#include "qpitchengine.h"
+
+class QDecimator;
+class QFrameSnapshotPool;
+class QPitchEstimator;
+class QPlotEnvelope;
+class QStrobeBank;
+template <typename T> class QRingBuffer;
+
+
+//! Pitch detection pipeline of a single channel of the audio stream.
+/*!
+ * This class holds the whole state of the analysis of one channel: the
+ * ring buffer filled by the callback of the sound input, the sliding
+ * window with the signal gate and the pitch estimator with its own FFTW
+ * buffers. Each block is read in place from the ring buffer and scanned
+ * once by QSampleScanner, which converts the samples right after the
+ * sliding window and measures the level used by the gate and by
+ * updateChannelLevel. The sliding window moves along the analysis
+ * buffer by one hop at a time, so the samples are not copied again
+ * until they are handed to the estimator.
+ * When the lowest note requires a longer frame, the samples
+ * extracted from the ring buffer are decimated before the sliding
+ * window, so that the whole analysis runs at the reduced rate.
+ * With the adaptive frame, the channel keeps an estimator for each size
+ * obtained halving the sliding window down to MIN_ADAPTIVE_FRAME_SIZE
+ * and estimates each frame from its most recent samples only, choosing
+ * the shortest frame spanning ADAPTIVE_FRAME_PERIODS periods of the last
+ * estimate (and a shorter hop with it). A frame too short for the note
+ * that follows is detected by the jump of the estimate, and the same
+ * window is estimated again at full size.
+ * When a strobe note is requested to the session, the first channel
+ * waits for STROBE_LOCK_ESTIMATES consecutive estimates within a quarter
+ * tone of the note, then stops the pitch estimator and follows the
+ * partials of the note with a QStrobeBank fed by every new sample, until
+ * the note is lost, released or changed, or the signal falls below the
+ * threshold. The channels do not share any state but the FFTW plans, thus
+ * they are analysed concurrently by the threads of a QPitchEngine, each
+ * run of the task draining the ring buffer of its channel.
+ * The results are published through the signals of QPitchCore: every
+ * channel emits updateChannelEstimate, while the first channel also
+ * emits the signals used by the views and by the mono clients, exactly
+ * as for a mono stream. The state reached at the end of each block is
+ * also published in a QLatestValue mailbox, read by the views at their
+ * own pace.
+ */
+
+class QPitchChannel : public QPitchTask {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] core the pitch detector whose signals publish the results
+	 * \param[in] channel the index of the channel in the frames of the stream
+	 * \param[in] sampleFrequency the sample rate of the audio stream
+	 * \param[in] decimationFactor the number of samples of the audio stream for each analysed sample (1 to analyse the full rate)
+	 * \param[in] bufferSize the number of samples extracted from the ring buffer at once (one callback period)
+	 * \param[in] ringBufferSize the minimum number of samples stored in the ring buffer
+	 * \param[in] fftFrameSize the size of the frame used to compute the FFT and the note pitch (in analysed samples)
+	 * \param[in] hopSize the number of new samples of the audio stream between two consecutive estimates
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch
+	 * \param[in] plotData_size the number of samples in the buffers used for visualization (first channel only)
+	 * \param[in] lowestFrequency the lowest frequency displayed in the graph of the autocorrelation
+	 * \param[in] adaptiveFrame true to choose the size of each frame from the last estimate (fftFrameSize is the largest one)
+	 */
+	QPitchChannel( QPitchCore* core, const unsigned int channel, const double sampleFrequency, const unsigned int decimationFactor,
+		const unsigned int bufferSize, const unsigned int ringBufferSize, const unsigned int fftFrameSize, const unsigned int hopSize,
+		const QPitchCore::PeakEstimation peakEstimation, const QPitchCore::PitchEstimator pitchEstimator,
+		const unsigned int plotData_size, const double lowestFrequency, const bool adaptiveFrame );
+
+	//! Default destructor.
+	~QPitchChannel( );
+
+	//! Number of samples that can be stored in the ring buffer (callback side).
+	unsigned int writeAvailable( ) const;
+
+	//! Number of samples waiting in the ring buffer (analysis side).
+	unsigned int readAvailable( ) const;
+
+	//! Store the samples of the channel taken from a buffer of interleaved frames (callback side).
+	/*!
+	 * \param[in] input the array with the interleaved frames
+	 * \param[in] frameCount the number of frames to store (at most writeAvailable)
+	 * \param[in] channelCount the number of channels in each frame
+	 */
+	void store( const short int* input, const unsigned int frameCount, const unsigned int channelCount );
+
+	//! Account for the samples dropped by the callback because the ring buffer was full (callback side).
+	/*!
+	 * \param[in] sampleCount the number of samples lost
+	 */
+	void addDroppedSamples( const unsigned int sampleCount );
+
+	//! Analyse all the samples waiting in the ring buffer, then the samples dropped by the callback.
+	virtual void run( );
+
+	//! Retrieve the duration of the samples received since the start of the stream, dropped ones included (in seconds).
+	double streamTime( ) const { return _streamSamples / _sampleFrequency; };
+
+	//! Retrieve the latest state published by the analysis (see QPitchCore::latestState).
+	/*!
+	 * \param[out] state the latest state of the channel
+	 * \return true if the state has been updated since the previous call
+	 */
+	bool latestState( QPitchCore::ChannelState& state );
+
+	//! Retrieve the pitch detection algorithm (for the full sliding window).
+	const QPitchEstimator* estimator( ) const { return _estimators[0]; };
+
+#ifdef QPITCH_STAGE_TIMING
+	//! Add the time spent in each stage of the pitch detection algorithm to the given totals.
+	/*!
+	 * \param[in,out] stageTime the time spent in each stage (in nanoseconds)
+	 * \param[in,out] estimateCount the number of estimates computed
+	 */
+	void addStageTimings( qint64 stageTime[QPitchCore::STAGE_COUNT], unsigned int& estimateCount ) const;
+#endif
+
+
+private: /* enumerations */
+	//! Status of the visualization used to handle silence in the input stream.
+	enum VisualizationStatus {
+		STOPPED,
+		STOP_REQUEST,
+		START_REQUEST,
+		RUNNING
+		};
+
+private: /* static constants */
+	static const int 	SIGNAL_THRESHOLD_ON;					//!< Value of the threshold above which the processing is activated
+	static const int 	SIGNAL_THRESHOLD_OFF;					//!< Value of the threshold below which the input audio signal is deactivated
+	static const unsigned int	MIN_ADAPTIVE_FRAME_SIZE;		//!< Size of the shortest frame used by the adaptive frame
+	static const double	ADAPTIVE_FRAME_PERIODS;					//!< Number of periods of the last estimate spanned by the adaptive frame
+	static const double	MAX_ADAPTIVE_JUMP;						//!< Largest change of the estimate accepted from a shorter frame (in octaves)
+	static const unsigned int	FULL_FRAME_INTERVAL;			//!< Number of estimates between two checks with the full frame
+	static const unsigned int	STROBE_LOCK_ESTIMATES;			//!< Number of consecutive estimates within the strobe note required to lock it
+	static const double	STROBE_LOCK_RANGE;						//!< Largest deviation of an estimate from the strobe note (in octaves)
+	static const unsigned int	ANALYSIS_BUFFER_FRAMES;			//!< Number of sliding windows stored in the analysis buffer besides one block
+
+
+private: /* members */
+	// ** CHANNEL ** //
+	QPitchCore*			_core;									//!< Pitch detector whose signals publish the results
+	unsigned int		_channel;								//!< Index of the channel in the frames of the stream
+	double				_sampleFrequency;						//!< Sample rate of the analysis (the rate of the audio stream divided by the decimation factor)
+	unsigned int		_block_size;							//!< Largest number of samples extracted from the ring buffer at once (one callback period)
+	QRingBuffer<short int>*	_ringBuffer;						//!< Lock-free buffer used to transfer the input samples from the callback
+	QDecimator*			_decimator;								//!< Lowpass filter and decimator of the input samples (NULL at the full rate)
+	short int*			_decimatedBuffer;						//!< Internal buffer to store the decimated samples (NULL at the full rate)
+	quint64				_streamSamples;							//!< Number of analysed samples received since the start of the stream (dropped ones included)
+	QAtomicInteger<unsigned int>	_droppedSamples;			//!< Number of samples dropped by the callback and not accounted for yet
+
+	// ** PITCH DETECTION ** //
+	QVector<QPitchEstimator*>	_estimators;					//!< Pitch detection algorithm for each frame size, from the full sliding window down, owning the FFTW buffers
+	int					_frameLevel;							//!< Index of the estimator of the next frame (0 for the full sliding window)
+	bool				_adaptiveFrame;							//!< True when the size of each frame is chosen from the last estimate
+	double				_lastFrequency;							//!< Last estimated frequency used to choose the size of the frame
+	unsigned int		_adaptiveEstimates;						//!< Number of estimates since the last check with the full frame
+
+	// ** STROBE ** //
+	QStrobeBank*		_strobeBank;							//!< Filter bank following the partials of the strobe note (NULL except for the first channel)
+	bool				_strobeLocked;							//!< True when the pitch is estimated by the strobe instead of the pitch estimator
+	unsigned int		_strobeEstimates;						//!< Number of consecutive estimates within the strobe note
+
+	// ** SLIDING WINDOW ** //
+	qfftw_real*			_analysisBuffer;						//!< Buffer receiving the converted input samples, which holds the sliding window (allocated with fftw_malloc)
+	unsigned int		_analysisBuffer_size;					//!< Size of the analysis buffer
+	qfftw_real*			_frame;									//!< Sliding window with the most recent input samples, inside the analysis buffer (the external buffer is overwritten by the estimator)
+	unsigned int		_frame_size;							//!< Size of the sliding window (size of the frame used to compute the FFT)
+	unsigned int		_frame_index;							//!< Index in the sliding window
+	unsigned int		_hopSize;								//!< Number of new analysed samples between two consecutive estimates of the full sliding window
+
+#ifdef QPITCH_STAGE_TIMING
+	// ** BENCHMARK ** //
+	qint64				_stageTime[QPitchCore::STAGE_COUNT];	//!< Time spent in each stage of the pitch detection algorithm (in nanoseconds)
+	unsigned int		_estimateCount;							//!< Number of estimates computed since the start of the stream
+#endif
+
+	// ** TEMPORARY BUFFERS USED FOR VISUALIZATION ** //
+	QFrameSnapshotPool*	_plotPool;								//!< Snapshots of the frames published for visualization (NULL except for the first channel)
+	QPlotEnvelope*		_plotEnvelope;							//!< Reduction of the plotted samples to the columns of the envelopes (NULL except for the first channel)
+	unsigned int		_plotData_size;							//!< Largest number of columns of the envelopes used for visualization
+	unsigned int		_plotSample_size;						//!< Number of samples of the input signal displayed by the oscilloscope view (50 milliseconds)
+	double				_lowestFrequency;						//!< Lowest frequency displayed in the graph of the autocorrelation
+	VisualizationStatus	_visualizationStatus;					//!< Visualization status used to handle silence
+
+	// ** STATE READ BY THE VIEWS ** //
+	QPitchCore::ChannelState	_state;							//!< State of the analysis updated by each block and each estimate
+	QLatestValue<QPitchCore::ChannelState>	_latestState;		//!< Mailbox with the state published at the end of each block
+
+private: /* methods */
+	//! Account for the samples dropped by the callback in the position of the stream.
+	/*!
+	 * \param[in] sampleCount the number of samples of the audio stream lost since the last call
+	 */
+	void dropSamples( const unsigned int sampleCount );
+
+	//! Process a block of input samples extracted from the ring buffer.
+	/*!
+	 * The block is converted right after the sliding window, in the analysis buffer.
+	 * \param[in] first the array with the first input samples
+	 * \param[in] firstCount the number of samples in the first array
+	 * \param[in] second the array with the input samples following the first ones (split by the wrap around of the ring buffer)
+	 * \param[in] secondCount the number of samples in the second array
+	 */
+	void processInputBuffer( const short int* first, const unsigned int firstCount, const short int* second, const unsigned int secondCount );
+
+	//! Estimate the pitch of the full sliding window, publish the results and slide the window by one hop.
+	/*!
+	 * \param[in] frameTime the time of the last sample of the sliding window (in seconds)
+	 */
+	void processFrame( const double frameTime );
+
+	//! Estimate the pitch of the most recent samples of the sliding window.
+	/*!
+	 * \param[in] estimator the estimator whose frame size is used
+	 * \return the estimated frequency (0 if the frame does not show any periodicity)
+	 */
+	double estimateFrame( QPitchEstimator* estimator );
+
+	//! Retrieve the number of new samples between the frame of an estimator and the next one.
+	/*!
+	 * \param[in] frameLevel the index of the estimator
+	 * \return the hop size of the estimator (the hop of the stream, at most half the frame of the shorter ones)
+	 */
+	unsigned int frameHopSize( const int frameLevel ) const;
+
+	//! Retrieve the number of samples of the lag function displayed by the oscilloscope view.
+	/*!
+	 * \param[in] estimator the estimator whose lag function is displayed
+	 * \return the number of lags in the range [lowest, 1000] Hz --> [0, 1 / lowest] sec, times the zero-padding factor
+	 */
+	unsigned int plotLagSize( const QPitchEstimator* estimator ) const;
+
+	//! Estimate the pitch with the strobe, unlocking it when the note is not held anymore.
+	/*!
+	 * \return the estimated frequency (0 if the strobe has been unlocked or has no estimate yet)
+	 */
+	double estimateStrobe( );
+
+	//! Lock the strobe once enough consecutive estimates fall within the strobe note.
+	/*!
+	 * \param[in] estimatedFrequency the last frequency estimated by the pitch estimator
+	 */
+	void lockStrobe( const double estimatedFrequency );
+
+	//! Restart the analysis from the full sliding window (and without the strobe) after a discontinuity of the stream.
+	void resetFrames( );
+
+	//! Disabled copy constructor.
+	QPitchChannel( const QPitchChannel& );
+
+	//! Disabled assignment operator.
+	QPitchChannel& operator=( const QPitchChannel& );
+};
+
+#endif /* __QPITCHCHANNEL_H_ */
@@ -0,0 +1,132 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchcli.h"
+#include "qpitchcore.h"
+
+#include <iostream>
+
+#include <QCoreApplication>
+#include <QtNumeric>
+
+
+QPitchCli::QPitchCli( QPitchCore* hQPitchCore, const QTuningScale& tuningScale, const OutputFormat outputFormat,
+	const unsigned int channelCount, QObject* parent ) : QObject( parent )
+{
+	// ** ENSURE THAT THE WORKING THREAD IS VALID ** //
+	Q_ASSERT( hQPitchCore != NULL );
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_hQPitchCore	= hQPitchCore;
+	_tuningScale	= tuningScale;
+	_outputFormat	= outputFormat;
+	_wallClock.start( );
+
+	// ** WRITE THE HEADER ** //
+	if ( _outputFormat == FORMAT_CSV ) {
+		std::cout << ( (channelCount > 1) ? "time,channel,frequency,note,cents,signal" : "time,frequency,note,cents,signal" ) << std::endl;
+	}
+
+	// ** SETUP THE CONNECTIONS ** //
+	// the estimates are written by the analysis threads, so that they are not delayed by the event loop
+	if ( channelCount > 1 ) {
+		connect( _hQPitchCore, SIGNAL( updateChannelEstimate(unsigned int, double, double, bool) ),
+			this, SLOT( writeChannelEstimate(unsigned int, double, double, bool) ), Qt::DirectConnection );
+	} else {
+		connect( _hQPitchCore, SIGNAL( updateTimedEstimate(double, double, bool) ),
+			this, SLOT( writeEstimate(double, double, bool) ), Qt::DirectConnection );
+	}
+}
+
+
+void QPitchCli::writeEstimate( double streamTime, double estimatedFrequency, bool signalPresent )
+{
+	writeLine( -1, streamTime, estimatedFrequency, signalPresent );
+}
+
+
+void QPitchCli::writeChannelEstimate( unsigned int channel, double streamTime, double estimatedFrequency, bool signalPresent )
+{
+	writeLine( (int) channel, streamTime, estimatedFrequency, signalPresent );
+}
+
+
+void QPitchCli::writeLine( const int channel, const double streamTime, const double estimatedFrequency, const bool signalPresent )
+{
+	// ** FIND THE NEAREST NOTE ** //
+	// (a frame without periodicity has no estimate, and a non-finite one would not be valid JSON nor CSV)
+	const bool estimateFound = signalPresent && qIsFinite( estimatedFrequency ) && (estimatedFrequency > 0.0);
+	int		note;
+	int		octave;
+	double	deviation;
+	const bool noteFound = estimateFound && _tuningScale.findNote( estimatedFrequency, note, octave, deviation );
+
+	// ** FORMAT THE ESTIMATE ** //
+	// the fields without a meaningful value are left empty (CSV) or null (JSON)
+	const QString emptyField = (_outputFormat == FORMAT_JSON) ? "null" : "";
+	const QString time		= QString::number( streamTime, 'f', 3 );
+	const QString frequency	= estimateFound ? QString::number( estimatedFrequency, 'f', 2 ) : emptyField;
+	QString noteLabel		= emptyField;
+	QString cents			= emptyField;
+	if ( noteFound ) {
+		noteLabel	= _tuningScale.noteLabel( note ) + QString::number( octave );
+		cents		= QString::number( 100.0 * deviation, 'f', 1 );
+		if ( _outputFormat == FORMAT_JSON ) {
+			noteLabel = "\"" + noteLabel + "\"";
+		}
+	}
+
+	QString line;
+	if ( _outputFormat == FORMAT_JSON ) {
+		const QString channelField = (channel < 0) ? QString( ) : QString( "\"channel\":%1," ).arg( channel );
+		line = QString( "{\"time\":%1,%2\"frequency\":%3,\"note\":%4,\"cents\":%5,\"signal\":%6}" )
+			.arg( time, channelField, frequency, noteLabel, cents, signalPresent ? "true" : "false" );
+	} else {
+		const QString channelField = (channel < 0) ? QString( ) : QString( "%1," ).arg( channel );
+		line = QString( "%1,%2%3,%4,%5,%6" ).arg( time, channelField, frequency, noteLabel, cents, signalPresent ? "1" : "0" );
+	}
+
+	// ** WRITE THE LINE (FLUSHED TO FOLLOW THE STREAM THROUGH A PIPE) ** //
+	// the channels are analysed concurrently, so the lines are serialised
+	_outputMutex.lock( );
+	std::cout << line.toUtf8( ).constData( ) << std::endl;
+	_outputMutex.unlock( );
+}
+
+
+void QPitchCli::stopStream( )
+{
+	// ** STOP THE ANALYSIS AND LEAVE THE EVENT LOOP ** //
+	try {
+		_hQPitchCore->stopStream( );
+	} catch ( QSoundInputException& e ) {
+		std::cerr << e.what( ) << "\n";
+	}
+
+	// ** REPORT THE THROUGHPUT AS AUDIO SECONDS PROCESSED PER WALL-CLOCK SECOND ** //
+	const double audioTime	= _hQPitchCore->getStreamTime( );
+	const double wallTime	= qMax( _wallClock.nsecsElapsed( ) * 1e-9, 1e-9 );
+	std::cerr << QString( "QPitch: analysed %1 s of audio in %2 s (%3 times real time)\n" )
+		.arg( audioTime, 0, 'f', 2 ).arg( wallTime, 0, 'f', 3 ).arg( audioTime / wallTime, 0, 'f', 1 ).toLocal8Bit( ).constData( );
+
+	QCoreApplication::quit( );
+}
@@ -0,0 +1,121 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHCLI_H_
+#define __QPITCHCLI_H_
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+
+#include "qtuningscale.h"
+
+class QPitchCore;
+
+
+//! Command line front-end of the QPitch application.
+/*!
+ * This class writes the estimates of the pitch detector to the standard
+ * output, one line for each estimate, so that the tuner can be driven by
+ * scripts or used on a machine without a display.
+ * Each line reports the position in the audio stream, the estimated
+ * frequency, the nearest note with its deviation in cents and the signal
+ * presence, either as a JSON object (JSON lines) or as a CSV record.
+ * The estimates are written from the threads of the analysis engine as
+ * soon as they are computed, thus the output does not depend on the
+ * event loop.
+ * With a multichannel stream the estimates of every channel are written,
+ * each line with the index of its channel; the lines are written by the
+ * threads that analyse the channels, serialised by a mutex.
+ * A recording read as fast as possible (a WAV file with the option --fast)
+ * goes through the same windowing, signal gate and estimator used by the
+ * live tuner, and at the end of the stream the throughput of the analysis
+ * is reported on the standard error.
+ */
+
+class QPitchCli : public QObject {
+	Q_OBJECT
+
+
+public: /* enumerations */
+	//! Format of the lines written to the standard output.
+	enum OutputFormat {
+		FORMAT_JSON,										//!< One JSON object for each line
+		FORMAT_CSV											//!< One CSV record for each line, after a header
+	};
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] hQPitchCore handle to the pitch detector whose estimates are written
+	 * \param[in] tuningScale the note scale used to find the nearest note
+	 * \param[in] outputFormat the format of the lines written to the standard output
+	 * \param[in] channelCount the number of channels requested for the stream (default 1, mono output without the channel)
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QPitchCli( QPitchCore* hQPitchCore, const QTuningScale& tuningScale, const OutputFormat outputFormat = FORMAT_JSON,
+		const unsigned int channelCount = 1, QObject* parent = 0 );
+
+
+public slots:
+	//! Write a new estimate to the standard output.
+	/*!
+	 * \param[in] streamTime the time of the estimate measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence
+	 */
+	void writeEstimate( double streamTime, double estimatedFrequency, bool signalPresent );
+
+	//! Write a new estimate of one channel to the standard output.
+	/*!
+	 * \param[in] channel the index of the channel
+	 * \param[in] streamTime the time of the estimate measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence of the channel
+	 */
+	void writeChannelEstimate( unsigned int channel, double streamTime, double estimatedFrequency, bool signalPresent );
+
+	//! Stop the analysis, report the throughput and quit the application (at the end of a file or of the standard input).
+	void stopStream( );
+
+
+private: /* members */
+	QPitchCore*			_hQPitchCore;					//!< Handle to the pitch detector
+	QTuningScale		_tuningScale;					//!< Note scale used to find the nearest note
+	OutputFormat		_outputFormat;					//!< Format of the lines written to the standard output
+	QElapsedTimer		_wallClock;						//!< Timer used to measure the throughput of the analysis
+	QMutex				_outputMutex;					//!< Mutex serialising the lines written by the channels
+
+
+private: /* methods */
+	//! Format an estimate and write it to the standard output.
+	/*!
+	 * \param[in] channel the index of the channel (negative to omit the field)
+	 * \param[in] streamTime the time of the estimate measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence
+	 */
+	void writeLine( const int channel, const double streamTime, const double estimatedFrequency, const bool signalPresent );
+};
+
+#endif /* __QPITCHCLI_H_ */
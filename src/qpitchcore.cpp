@@ -21,448 +21,410 @@
  */
 
 #include "qpitchcore.h"
+#include "qpitchchannel.h"
+#include "qpitchengine.h"
+#include "qpitchestimator.h"
+#include "qplotenvelope.h"
+#include "qsamplescanner.h"
+#include "qstreamsoundinput.h"
 
-#include <QMessageBox>
-#include <QMutex>
 #include <QtDebug>
-#include <QWaitCondition>
-
-#ifdef _REFERENCE_SQUAREWAVE_INPUT
-	#include <cmath>
-#endif
 
 
 // ** INITIALIZATION OF STATIC VARIABLES ** //
-const int QPitchCore::ZERO_PADDING_FACTOR	= 8;
-const int QPitchCore::SIGNAL_THRESHOLD_ON	= 100;
-const int QPitchCore::SIGNAL_THRESHOLD_OFF	= 20;
+const int QPitchCore::RING_BUFFER_PERIODS				= 8;
+const double QPitchCore::FULL_RATE_LOWEST_FREQUENCY		= 40.0;
+const double QPitchCore::MIN_DECIMATED_FREQUENCY		= 8000.0;
 
 
-QPitchCore::QPitchCore( const unsigned int plotPlot_size, QObject* parent ) : QThread( parent )
+QPitchCore::QPitchCore( QSoundInput* soundInput, const unsigned int plotPlot_size, QPitchEngine* engine, QObject* parent ) : QObject( parent )
 {
+	// ** ENSURE THAT THE SOUND INPUT IS VALID ** //
+	Q_ASSERT( soundInput != NULL );
+
 	// ** INITIALIZE PRIVATE VARIABLES ** //
-	_mutex			= new QMutex( );
-	_waitCond		= new QWaitCondition( );
-	_stream			= NULL;
+	_engine			= ( engine != NULL ) ? engine : QPitchEngine::instance( );
+	_soundInput		= soundInput;
+	_streamOpen		= false;
+	_channelCount	= 1;
 	_buffer			= NULL;
-	_fftw_plan_FFT	= NULL;
-	_fftw_plan_IFFT	= NULL;
-	_fftw_in_time	= NULL;
-	_fftw_out_freq 	= NULL;
-
-	// ** INITIALIZE TEMPORARY BUFFERS ** //
+	_streamTime		= 0.0;
+	_adaptiveFrame	= true;
+	_strobeNote.storeRelaxed( 0 );
+	_running		= false;
 	_plotData_size	= plotPlot_size;
-	_plotSample		= new double[plotPlot_size];
-	_plotAutoCorr	= new double[plotPlot_size];
+	_plotWidth.storeRelaxed( qMax( plotPlot_size, 1u ) );
 
-	// ** INITIALIZE PORTAUDIO ** //
-	PaError err = Pa_Initialize( );
-	if ( err != paNoError ) {
-		throw QPaSoundInputException( Pa_GetErrorText( err ) );
-	}
+	// ** ALLOW THE SNAPSHOTS ACROSS QUEUED CONNECTIONS ** //
+	qRegisterMetaType<QFrameSnapshotPointer>( "QFrameSnapshotPointer" );
 }
 
 
 QPitchCore::~QPitchCore( )
 {
-	// ** ENSURE THAT THE STREAM IS STOPPED AND THE THREAD NOT RUNNING ** //
-	Q_ASSERT( _stream		== NULL );
-	Q_ASSERT( _mutex		!= NULL );
-	Q_ASSERT( _waitCond		!= NULL );
-	Q_ASSERT( _plotSample	!= NULL );
-	Q_ASSERT( _plotAutoCorr	!= NULL );
+	// ** ENSURE THAT THE STREAM IS STOPPED ** //
+	Q_ASSERT( _streamOpen	== false );
+	Q_ASSERT( _channels.isEmpty( ) );
 	Q_ASSERT( _running		== false );
-	Q_ASSERT( ! this->isRunning( ) );
-
-	// ** TERMINATE PORTAUDIO ** //
-	Pa_Terminate( );
 
 	// ** RELEASE RESOURCES ** //
-	delete		_mutex;
-	delete		_waitCond;
-	delete[]	_plotSample;
-	delete[]	_plotAutoCorr;
+	delete		_soundInput;
 }
 
 
-void QPitchCore::startStream( const unsigned int sampleFrequency, const unsigned int fftFrameSize )
+void QPitchCore::startStream( const unsigned int sampleFrequency, const unsigned int fftFrameSize, const unsigned int hopSize,
+	const PeakEstimation peakEstimation, const PitchEstimator pitchEstimator, const unsigned int channelCount,
+	const double lowestFrequency )
 {
-	// ** ENSURE THAT THE STREAM IS STOPPED AND THE THREAD IS NOT RUNNING ** //
-	Q_ASSERT( _stream == NULL );
-	Q_ASSERT( _buffer == NULL );
-	Q_ASSERT( ! this->isRunning( ) );
+	// ** ENSURE THAT THE STREAM IS STOPPED ** //
+	Q_ASSERT( _streamOpen == false );
+	Q_ASSERT( _running == false );
 
-#ifdef _REFERENCE_SQUAREWAVE_INPUT
-	// create the artificial square wave with some harmonics :: 110.0 Hz
-	for ( unsigned int k = 0 ; k < 4410 ; ++k ) {
-		_referenceSineWave[k] = ( (sin( 2 * M_PI * 110.0 * (double) k / sampleFrequency ) >= 0.0) ? 1000 : -1000 );
-	}
-	_referenceSineWave_index = 0;
-#endif
-        _inputParameters.device = -1;
-        for (int i = 0, end = Pa_GetDeviceCount(); i != end; ++i) {
-            PaDeviceInfo const* info = Pa_GetDeviceInfo(i);
-            if (!info) continue;
-            if (strcmp(info->name, "pulse") == 0) {
-                _inputParameters.device = i;
-                break;
-            }
-        }
-
-	// ** CONFIGURE THE INPUT AUDIO STREAM ** //
-	_sampleFrequency							=	sampleFrequency;
-        if (_inputParameters.device == -1) {
-            _inputParameters.device						=	Pa_GetDefaultInputDevice( );				// default input device
-        }
-	_inputParameters.channelCount				=	1;											// mono input
-	_inputParameters.sampleFormat				=	paInt16;									// 16 bit integer
-	_inputParameters.suggestedLatency			=	Pa_GetDeviceInfo( _inputParameters.device )->defaultHighInputLatency;
-																								// set the latency for a robust non-interactive application
-	_inputParameters.hostApiSpecificStreamInfo	=	NULL;
-
-	// ** OPEN AN AUDIO INPUT STREAM ** //
-	_buffer_size = (unsigned int)((double) _inputParameters.suggestedLatency * sampleFrequency);
-	PaError err = Pa_OpenStream(
-		&_stream,
-		&_inputParameters,
-		NULL,									// no output
-		_sampleFrequency,						// sample rate (default 44100 Hz)
-		(long) _buffer_size,					// frames per buffer
-		paClipOff,								// disable clipping
-        paCallback,                             // callback
-		this									// pointer to user data
-	);
-
-	if ( err != paNoError ) {
-		throw QPaSoundInputException( Pa_GetErrorText( err ) );
-	}
-
-	// ** INITIALIZE BUFFERS ** //
-	_buffer 			= new short int[_buffer_size];
-	_fftw_in_time_size 	= fftFrameSize;			// size of the external buffer (default 2048)
-	_fftw_in_time_index	= 0;
-
-	// ** INITIALIZE FFT STRUCTURES ** //
-	_fftw_in_time	= (double*) fftw_malloc( ZERO_PADDING_FACTOR * sizeof(double) * _fftw_in_time_size );
-	_fftw_out_freq	= (fftw_complex*) fftw_malloc( ZERO_PADDING_FACTOR * sizeof(fftw_complex) * _fftw_in_time_size );
-	_fftw_plan_FFT	= fftw_plan_dft_r2c_1d( _fftw_in_time_size, _fftw_in_time, _fftw_out_freq, FFTW_ESTIMATE );							// FFT
-	_fftw_plan_IFFT	= fftw_plan_dft_c2r_1d( ZERO_PADDING_FACTOR * _fftw_in_time_size, _fftw_out_freq, _fftw_in_time, FFTW_ESTIMATE );	// IFFT zero-padded
-
-	// ** START PORTAUDIO STREAM ** //
-	err = Pa_StartStream( _stream );
-	if( err != paNoError ) {
-		throw QPaSoundInputException( Pa_GetErrorText( err ) );
-	}
+	// ** OPEN THE AUDIO INPUT STREAM AND INITIALIZE BUFFERS ** //
+	openStream( sampleFrequency, fftFrameSize, hopSize, peakEstimation, pitchEstimator, channelCount, lowestFrequency );
 
-	// ** START WORKING THREAD ** //
+	// ** START THE AUDIO INPUT STREAM ** //
+	// from now on the callback schedules the channels on the engine, and each schedule wakes up a worker
 	_running = true;
-	this->start( );
+	try {
+		_soundInput->startStream( );
+	} catch ( QSoundInputException& ) {
+		// the stream is left closed, so that it can be started again
+		_running = false;
+		closeStream( );
+		throw;
+	}
 
-	// ** ENSURE THAT THE STREAM IS STARTED AND THE THREAD IS RUNNING ** //
-	Q_ASSERT( _stream != NULL );
+	// ** ENSURE THAT THE STREAM IS STARTED ** //
+	Q_ASSERT( _streamOpen == true );
 	Q_ASSERT( _buffer != NULL );
-	Q_ASSERT( this->isRunning( ) );
+	Q_ASSERT( ! _channels.isEmpty( ) );
 
 	qDebug( ) << "QPitchCore::startStream";
+	qDebug( ) << " - soundInput              = " << _soundInput->description( );
 	qDebug( ) << " - sampleFrequency         = " << _sampleFrequency;
-	qDebug( ) << " - defaultHighInputLatency = " << _inputParameters.suggestedLatency;
+	qDebug( ) << " - channelCount            = " << _channelCount;
 	qDebug( ) << " - framesPerBuffer         = " << _buffer_size;
-	qDebug( ) << " - fftFrameSize            = " << _fftw_in_time_size << "\n";
+	qDebug( ) << " - ringBufferSize          = " << RING_BUFFER_PERIODS * _buffer_size;
+	qDebug( ) << " - fftFrameSize            = " << _frame_size;
+	qDebug( ) << " - hopSize                 = " << _hopSize;
+	qDebug( ) << " - lowestFrequency         = " << _lowestFrequency;
+	qDebug( ) << " - decimationFactor        = " << _decimationFactor;
+	qDebug( ) << " - adaptiveFrame           = " << _adaptiveFrame;
+	qDebug( ) << " - inputKernel             = " << QSampleScanner::instructionSet( );
+	qDebug( ) << " - plotKernel              = " << QPlotEnvelope::instructionSet( );
+	qDebug( ) << " - pitchEstimator          = " << _pitchEstimator;
+	qDebug( ) << " - zeroPaddingFactor       = " << _channels[0]->estimator( )->lagOversampling( );
+	qDebug( ) << " - engineThreads           = " << _engine->threadCount( ) << "\n";
 }
 
 
 void QPitchCore::stopStream( )
 {
 	// ** ENSURE THAT THE STREAM IS STARTED ** //
-	Q_ASSERT( _stream			!= NULL );
-	Q_ASSERT( _buffer			!= NULL );
-	Q_ASSERT( _fftw_plan_FFT	!= NULL );
-	Q_ASSERT( _fftw_plan_IFFT 	!= NULL );
-	Q_ASSERT( _fftw_in_time		!= NULL );
-	Q_ASSERT( _fftw_out_freq	!= NULL );
+	Q_ASSERT( _streamOpen		== true );
+	Q_ASSERT( _running			== true );
+	Q_ASSERT( ! _channels.isEmpty( ) );
 
-	// ** STOP THE THREAD ** //
-	_mutex->lock( );
+	// ** STOP THE AUDIO INPUT STREAM ** //
+	// once the stream is stopped the callback cannot schedule the channels anymore
+	_soundInput->stopStream( );
 	_running = false;
-	_mutex->unlock( );
 
-	// ** STOP PORTAUDIO STREAM ** //
-	PaError err = Pa_StopStream( _stream );
-	if( err != paNoError ) {
-		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	// ** WAIT FOR THE ANALYSIS OF THE SAMPLES STORED SO FAR ** //
+	// no channel is scheduled again, so the workers go to sleep for good once these runs are over
+	for ( int c = 0 ; c < _channels.size( ) ; ++c ) {
+		_engine->waitForTask( _channels[c] );
+	}
+
+	// ** CLOSE THE AUDIO INPUT STREAM ** //
+	closeStream( );
+}
+
+
+bool QPitchCore::isStreamStarted( ) const
+{
+	return _running;
+}
+
+
+void QPitchCore::analyseStream( const unsigned int sampleFrequency, const unsigned int fftFrameSize, const unsigned int hopSize,
+	const PeakEstimation peakEstimation, const PitchEstimator pitchEstimator, const unsigned int channelCount,
+	const double lowestFrequency )
+{
+	// ** ENSURE THAT THE STREAM IS STOPPED ** //
+	Q_ASSERT( _streamOpen == false );
+	Q_ASSERT( _running == false );
+
+	// ** ENSURE THAT THE SAMPLES CAN BE PULLED FROM THE SOUND INPUT ** //
+	QStreamSoundInput* streamInput = dynamic_cast<QStreamSoundInput*>( _soundInput );
+	if ( streamInput == NULL ) {
+		throw QSoundInputException( QString( "%1 cannot be analysed offline" ).arg( _soundInput->description( ) ).toLocal8Bit( ).constData( ) );
+	}
+
+	// ** OPEN THE AUDIO INPUT STREAM AND INITIALIZE BUFFERS ** //
+	openStream( sampleFrequency, fftFrameSize, hopSize, peakEstimation, pitchEstimator, channelCount, lowestFrequency );
+
+	// ** PROCESS THE WHOLE STREAM ** //
+	// the ring buffers are drained after each period, so they always have room for the next one
+	try {
+		unsigned int frameCount;
+		while ( (frameCount = streamInput->readStream( _buffer, _buffer_size )) > 0 ) {
+			storeFrames( _buffer, frameCount );
+			processChannels( );
+		}
+	} catch ( QSoundInputException& ) {
+		closeStream( );
+		throw;
+	}
+
+	// ** CLOSE THE AUDIO INPUT STREAM ** //
+	closeStream( );
+}
+
+
+void QPitchCore::openStream( const unsigned int sampleFrequency, const unsigned int fftFrameSize, const unsigned int hopSize,
+	const PeakEstimation peakEstimation, const PitchEstimator pitchEstimator, const unsigned int channelCount,
+	const double lowestFrequency )
+{
+	// ** ENSURE THAT THE STREAM IS CLOSED ** //
+	Q_ASSERT( _streamOpen == false );
+	Q_ASSERT( _buffer == NULL );
+	Q_ASSERT( _channels.isEmpty( ) );
+
+	// ** OPEN THE AUDIO INPUT STREAM ** //
+	_soundInput->openStream( sampleFrequency, qMax( channelCount, 1u ), soundInputCallback, this );
+	_streamOpen			= true;
+	_sampleFrequency	= _soundInput->sampleFrequency( );		// the sound input may impose its own rate
+	_channelCount		= _soundInput->channelCount( );			// and its own number of channels
+	_buffer_size		= _soundInput->framesPerBuffer( );
+	_realTimeInput		= _soundInput->isRealTime( );
+
+	// ** INITIALIZE BUFFERS ** //
+	_buffer 			= new short int[_buffer_size * _channelCount];
+	_streamTime			= 0.0;
+#ifdef QPITCH_STAGE_TIMING
+	memset( _stageTime, 0, sizeof( _stageTime ) );
+	_estimateCount		= 0;
+#endif
+	_frame_size			= fftFrameSize;			// size of the external buffer (default 4096)
+	_pitchEstimator		= pitchEstimator;
+	_peakEstimation		= peakEstimation;
+	_lowestFrequency	= lowestFrequency;
+
+	// ** CHOOSE THE DECIMATION FACTOR ** //
+	/*
+	 * the frame must cover as many periods of the lowest frequency as it
+	 * covers at the full rate for FULL_RATE_LOWEST_FREQUENCY (so the factor
+	 * is 2 for the low B of a 5-string bass), but the bandwidth left by the
+	 * decimation must still include the harmonics of the highest notes
+	 */
+	_decimationFactor	= 1;
+	while ( (_decimationFactor * _lowestFrequency < FULL_RATE_LOWEST_FREQUENCY) &&
+		(_sampleFrequency / (2 * _decimationFactor) >= MIN_DECIMATED_FREQUENCY) ) {
+		_decimationFactor *= 2;
 	}
 
-	// ** CLOSE PORTAUDIO STREAM ** //
-	err = Pa_CloseStream( _stream );
-	if( err != paNoError ) {
-		throw QPaSoundInputException( Pa_GetErrorText( err ) );
+	// the hop is counted at the rate of the stream, and the frame spans decimationFactor times more samples
+	_hopSize			= ( (hopSize == 0) || (hopSize > _decimationFactor * _frame_size) ) ? _decimationFactor * _frame_size : hopSize;
+
+	// ** INITIALIZE THE PIPELINE OF EACH CHANNEL ** //
+	// only the first channel is displayed by the oscilloscope view
+	for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+		_channels.append( new QPitchChannel( this, c, _sampleFrequency, _decimationFactor, _buffer_size, RING_BUFFER_PERIODS * _buffer_size,
+			_frame_size, _hopSize, _peakEstimation, _pitchEstimator, (c == 0) ? _plotData_size : 0, _lowestFrequency, _adaptiveFrame ) );
 	}
+}
 
-	// ** DESTROY FFTW STRUCTURES ** //
-	fftw_destroy_plan( _fftw_plan_FFT );
-	fftw_destroy_plan( _fftw_plan_IFFT );
-	fftw_free( _fftw_in_time );
-	fftw_free( _fftw_out_freq );
+
+void QPitchCore::closeStream( )
+{
+	// ** ENSURE THAT THE STREAM IS OPEN ** //
+	Q_ASSERT( _streamOpen		== true );
+	Q_ASSERT( _buffer			!= NULL );
+	Q_ASSERT( ! _channels.isEmpty( ) );
+
+	// ** CLOSE THE AUDIO INPUT STREAM ** //
+	_soundInput->closeStream( );
+	_streamOpen = false;
+
+	// ** KEEP THE POSITION AND THE TIMINGS OF THE STREAM ** //
+	_streamTime = _channels[0]->streamTime( );
+#ifdef QPITCH_STAGE_TIMING
+	for ( int c = 0 ; c < _channels.size( ) ; ++c ) {
+		_channels[c]->addStageTimings( _stageTime, _estimateCount );
+	}
+#endif
 
 	// ** RELEASE RESOURCES ** //
 	delete[] _buffer;
+	qDeleteAll( _channels );
 	_buffer			= NULL;
-	_stream			= NULL;
-	_fftw_plan_FFT	= NULL;
-	_fftw_plan_FFT	= NULL;
-	_fftw_in_time 	= NULL;
-	_fftw_out_freq 	= NULL;
+	_channels.clear( );
 }
 
 
-void QPitchCore::getStreamParameters( unsigned int& sampleFrequency, unsigned int& fftBufferSize ) const
+void QPitchCore::getStreamParameters( unsigned int& sampleFrequency, unsigned int& fftBufferSize, unsigned int& hopSize,
+	PeakEstimation& peakEstimation, PitchEstimator& pitchEstimator, unsigned int& channelCount, double& lowestFrequency ) const
 {
 	// ** ENSURE THAT THE STREAM IS STARTED ** //
-	Q_ASSERT( _stream != NULL );
+	Q_ASSERT( _streamOpen == true );
 
 	// ** GET STREAM PROPERTIES ** //
 	sampleFrequency	= (unsigned int) _sampleFrequency;
-	fftBufferSize	= _fftw_in_time_size;
+	fftBufferSize	= _frame_size;
+	hopSize			= _hopSize;
+	peakEstimation	= _peakEstimation;
+	pitchEstimator	= _pitchEstimator;
+	channelCount	= _channelCount;
+	lowestFrequency	= _lowestFrequency;
 }
 
 
-void QPitchCore::getPortAudioInfo( QString& device ) const
+double QPitchCore::getStreamTime( ) const
 {
-	// ** ENSURE THAT THE STREAM IS STARTED ** //
-	Q_ASSERT( _stream != NULL );
+	// ** ENSURE THAT THE POSITION IS NOT BEING UPDATED ** //
+	Q_ASSERT( _running == false );
 
-	// ** RETRIEVE STREAM PROPERTIES ** //
-	device = QString( "Device: " + QString(Pa_GetDeviceInfo( _inputParameters.device )->name) + " [" +
-		QString(Pa_GetHostApiInfo( Pa_GetDeviceInfo( _inputParameters.device )->hostApi )->name)  + "]");
+	return _channels.isEmpty( ) ? _streamTime : _channels[0]->streamTime( );
 }
 
 
-int QPitchCore::paCallback( const void* input, void* /*output*/, unsigned long frameCount,
-		const PaStreamCallbackTimeInfo* /*timeInfo*/, PaStreamCallbackFlags /*statusFlags*/, void* userData )
+bool QPitchCore::latestState( const unsigned int channel, ChannelState& state )
 {
-	Q_ASSERT( input		!= NULL );
-	Q_ASSERT( userData	!= NULL );
-
-    return( static_cast<QPitchCore*>( userData )->paStoreInputBufferCallback( (const short int*)input, frameCount ) );
+	// ** THE CHANNELS EXIST ONLY WHILE THE STREAM IS OPEN ** //
+	// (and a restart of the stream may reduce their number)
+	if ( (int) channel >= _channels.size( ) ) {
+		return false;
+	}
+	return _channels[channel]->latestState( state );
 }
 
-int QPitchCore::paStoreInputBufferCallback( const short int* input, unsigned long frameCount )
+
+#ifdef QPITCH_STAGE_TIMING
+void QPitchCore::getStageTimings( qint64 stageTime[STAGE_COUNT], unsigned int& estimateCount ) const
 {
-    // ** TRY TO ACQUIRE THE SEMAPHORE ** //
-    if ( _mutex->tryLock( 1 ) ) {
-        // buffer has been locked
-        _mutex->unlock( );
-
-        // ** COPY BUFFER ** //
-#ifdef _REFERENCE_SQUAREWAVE_INPUT
-        // ** USE THE REFERENCE SINE WAVE INPUT SIGNAL ** //
-        for ( unsigned int k = 0 ; k < frameCount ; ++k ) {
-            _buffer[k] = _referenceSineWave[_referenceSineWave_index++];
-            if ( _referenceSineWave_index >= 4410 ) {
-                _referenceSineWave_index = 0;
-            }
-        }
-#else
-        // ** READ THE REAL AUDIO SIGNAL ** //
-        memcpy( _buffer, input, frameCount * sizeof( short int ) );
+	// ** ENSURE THAT THE TIMES ARE NOT BEING UPDATED ** //
+	Q_ASSERT( _running == false );
+
+	memcpy( stageTime, _stageTime, sizeof( _stageTime ) );
+	estimateCount = _estimateCount;
+}
 #endif
 
-        // ** REQUEST BUFFER RELEASE ** //
-        _waitCond->wakeOne( );
-    } else {
-        // buffer cannot be locked
-        std::cerr << "QPitch: buffer full, dropping " << frameCount << " samples!\n";
-        // drop all the samples in the external buffer
-        _fftw_in_time_index = 0;
-    }
 
-	return paContinue;
+void QPitchCore::setAdaptiveFrame( const bool enabled )
+{
+	// ** THE FRAME SIZES ARE CHOSEN WHEN THE STREAM IS OPENED ** //
+	_adaptiveFrame = enabled;
 }
 
 
-void QPitchCore::run( )
+void QPitchCore::setStrobeNote( double noteFrequency )
 {
-	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
-	Q_ASSERT( _fftw_plan_FFT	!= NULL );
-	Q_ASSERT( _fftw_plan_IFFT 	!= NULL );
-	Q_ASSERT( _fftw_in_time		!= NULL );
-	Q_ASSERT( _fftw_out_freq	!= NULL );
-	Q_ASSERT( _fftw_in_time		!= NULL );
-	Q_ASSERT( _fftw_out_freq	!= NULL );
-	Q_ASSERT( _plotSample		!= NULL );
-	Q_ASSERT( _plotAutoCorr		!= NULL );
-
-	// initialize the visualization status
-	_visualizationStatus = STOPPED;
-
-	forever {
-		// lock the buffer
-		_mutex->lock( );
-		if ( _running == false ) {
-			_mutex->unlock( );
-				_visualizationStatus = STOPPED;
-			return;
-		}
+	// ** ENSURE THAT THE NOTE IS VALID ** //
+	Q_ASSERT( noteFrequency >= 0.0 );
 
-		// ** PROCESS THE BUFFER AND SLEEP TILL THE NEXT FRAME ** //
-		// transfer the internal buffer to the external buffer and
-		// drop all the samples that exceed its length
-		// check if the whole signal is below a given threshold to
-		// stop visualization
+	// ** PUBLISH THE NOTE TO THE ANALYSIS, WHICH MAY BE RUNNING ** //
+	quint64 noteBits;
+	memcpy( &noteBits, &noteFrequency, sizeof( noteBits ) );
+	_strobeNote.storeRelaxed( noteBits );
+}
 
-		unsigned int k = 0;
 
-		// trigger the signal to have the first sample on a rising edge accross zero
-		if ( _fftw_in_time_index == 0 ) {
-            for (  ; (k < (_buffer_size - 1)) && ((_buffer[k] >= 0) || (_buffer[k+1] < 0)) ; ++k ) {};
-		}
+double QPitchCore::strobeNote( ) const
+{
+	const quint64 noteBits = _strobeNote.loadRelaxed( );
+	double noteFrequency;
+	memcpy( &noteFrequency, &noteBits, sizeof( noteFrequency ) );
+	return noteFrequency;
+}
 
-		// check if the audio stream is below a given threshold to stop visualization
-		if ( _visualizationStatus == STOPPED ) {
-			for (  ; ( (k < _buffer_size) && (_fftw_in_time_index < _fftw_in_time_size) && ( (_buffer[k] < SIGNAL_THRESHOLD_ON) && (_buffer[k] > -SIGNAL_THRESHOLD_ON) ) ) ; ++k ) {
-				_fftw_in_time[_fftw_in_time_index++] = _buffer[k];
-			}
-		} else if ( _visualizationStatus == RUNNING ) {
-			for (  ; ( (k < _buffer_size) && (_fftw_in_time_index < _fftw_in_time_size) && ( (_buffer[k] < SIGNAL_THRESHOLD_OFF) && (_buffer[k] > -SIGNAL_THRESHOLD_OFF) ) ) ; ++k ) {
-				_fftw_in_time[_fftw_in_time_index++] = _buffer[k];
-			}
-		}
 
-		// check if the level has been triggered
-		if ( (k == _buffer_size) || (_fftw_in_time_index == _fftw_in_time_size) ) {
-			// if the array end has been hit the level of the signal is too low, so drop all the buffer
-			_fftw_in_time_index = 0;
-
-			if ( _visualizationStatus == RUNNING ) {
-				_visualizationStatus = STOP_REQUEST;
-			}
-		} else {
-			// read the remaining of the buffer
-			for (  ; ( (k < _buffer_size) && (_fftw_in_time_index < _fftw_in_time_size) ) ; ++k ) {
-				_fftw_in_time[_fftw_in_time_index++] = _buffer[k];
-			}
-
-			if ( _visualizationStatus == STOPPED ) {
-				_visualizationStatus = START_REQUEST;
-			}
-
-			// process the external buffer if required
-			if ( _fftw_in_time_index == _fftw_in_time_size ) {
-				// downsample factor used to extract a buffer with a time range of 50 milliseconds
-				unsigned int fftw_in_downsampleFactor;
-				if ( _sampleFrequency == 44100.0 ) {
-					fftw_in_downsampleFactor = 4;
-				} else if ( _sampleFrequency == 22050.0 ) {
-					fftw_in_downsampleFactor = 2;
-				}
-
-				for ( unsigned int k = 0 ; k < _plotData_size ; ++k ) {
-					Q_ASSERT( (k * fftw_in_downsampleFactor) < (_fftw_in_time_size) );
-					_plotSample[k] = _fftw_in_time[k * fftw_in_downsampleFactor];
-				}
-				emit updatePlotSamples( _plotSample, _fftw_in_time_size / _sampleFrequency );
-
-				// reset the index in the external buffer
-				_fftw_in_time_index = 0;
-
-				// compute the autocorrelation and find the best matching frequency
-				double estimatedFrequency = fftw_pitchDetectionAlgorithm( );
-				emit updateEstimatedFrequency( estimatedFrequency );
-
-				// extract autocorrelation samples for the oscilloscope view in the range [40, 1000] Hz --> [0, 25] msec
-				unsigned int fftw_out_downsampleFactor;
-				if ( _sampleFrequency == 44100.0 ) {
-					fftw_out_downsampleFactor = 2 * ZERO_PADDING_FACTOR;
-				} else if ( _sampleFrequency == 22050.0 ) {
-					fftw_out_downsampleFactor = 1 * ZERO_PADDING_FACTOR;
-				}
-
-				for ( unsigned int k = 0 ; k < _plotData_size ; ++k ) {
-					Q_ASSERT( (k * fftw_out_downsampleFactor) < (ZERO_PADDING_FACTOR * _fftw_in_time_size) );
-					_plotAutoCorr[k] = _fftw_in_time[k * fftw_out_downsampleFactor];
-				}
-				emit updatePlotAutoCorr( _plotAutoCorr, estimatedFrequency );
-			}
-		}
+void QPitchCore::setPlotWidth( unsigned int columnCount )
+{
+	// ** PUBLISH THE WIDTH TO THE ANALYSIS, WHICH MAY BE RUNNING ** //
+	_plotWidth.storeRelaxed( qBound( 1u, columnCount, qMax( _plotData_size, 1u ) ) );
+}
 
-		// manage the visualization status
-		if ( _visualizationStatus == STOP_REQUEST ) {
-			emit updateSignalPresence( false );
-			_visualizationStatus = STOPPED;
-		} else if ( _visualizationStatus == START_REQUEST ) {
-			emit updateSignalPresence( true );
-			_visualizationStatus = RUNNING;
-		}
 
-		// release the buffer and wait
-		_waitCond->wait( _mutex );
-		_mutex->unlock( );
-	}
+unsigned int QPitchCore::plotWidth( ) const
+{
+	return _plotWidth.loadRelaxed( );
 }
 
 
-double QPitchCore::fftw_pitchDetectionAlgorithm( )
+void QPitchCore::getSoundInputInfo( QString& device ) const
 {
-	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
-	Q_ASSERT( _fftw_plan_FFT	!= NULL );
-	Q_ASSERT( _fftw_plan_IFFT 	!= NULL );
-	Q_ASSERT( _fftw_in_time		!= NULL );
-	Q_ASSERT( _fftw_out_freq	!= NULL );
+	// ** ENSURE THAT THE STREAM IS STARTED ** //
+	Q_ASSERT( _streamOpen == true );
 
-	// ** COMPUTE THE AUTOCORRELATION ** //
-	// compute the FFT of the input signal
-	fftw_execute( _fftw_plan_FFT );
+	// ** RETRIEVE STREAM PROPERTIES ** //
+	device = _soundInput->description( );
+}
 
-	/*
-	 * compute the transform of the autocorrelation given in time domain by
-	 *
-	 *        k=-N
-	 * r[t] = sum( x[k] * x[t-k] )
-	 *         N
-	 *
-	 * or in the frequency domain (for a real signal) by
-	 *
-	 * R[f] = X[f] * X[f]' = |X[f]|^2 = Re(X[f])^2 + Im(X[f])^2
-	 *
-	 * when computing the FFT with fftw_plan_dft_r2c_1d there are only N/2
-	 * significant samples so we only need to compute the |.|^2 for
-	 * _fftw_in_time_Size/2 samples
-	 */
 
-	// compute |.|^2 of the signal
-	for( unsigned int k = 0 ; k < (_fftw_in_time_size / 2 + 1) ; ++k ) {
-		_fftw_out_freq[k][0] = (_fftw_out_freq[k][0] * _fftw_out_freq[k][0]) + (_fftw_out_freq[k][1] * _fftw_out_freq[k][1]);
-		_fftw_out_freq[k][1] = 0.0;
+unsigned int QPitchCore::soundInputCallback( const short int* input, unsigned int frameCount, void* userData )
+{
+	Q_ASSERT( input		!= NULL );
+	Q_ASSERT( userData	!= NULL );
+
+    return( static_cast<QPitchCore*>( userData )->storeInputBufferCallback( input, frameCount ) );
+}
+
+unsigned int QPitchCore::storeInputBufferCallback( const short int* input, unsigned int frameCount )
+{
+	// ** COPY BUFFER ** //
+	unsigned int storedSamples = storeFrames( input, frameCount );
+
+	// ** KEEP TRACK OF THE DROPPED SAMPLES ** //
+	// a sound input that is not real-time delivers the samples again
+	if ( _realTimeInput && (storedSamples < frameCount) ) {
+		for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+			_channels[c]->addDroppedSamples( frameCount - storedSamples );
+		}
 	}
 
-	// pad the FFT with zeros to increase resolution
-	memset( &(_fftw_out_freq[_fftw_in_time_size/ 2 + 1][0]), 0, ( (ZERO_PADDING_FACTOR - 1) * _fftw_in_time_size + _fftw_in_time_size/ 2 - 1) * sizeof(fftw_complex) );
+	// ** SCHEDULE THE ANALYSIS OF THE CHANNELS ** //
+	// the engine never blocks the callback (the tasks are pushed on a lock-free list and an idle
+	// worker is woken up without taking any lock), and a channel already scheduled is not queued again
+	for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+		_engine->schedule( _channels[c] );
+	}
 
-	// compute the IFFT to obtain the autocorrelation in time domain
-	fftw_execute( _fftw_plan_IFFT );
+	return storedSamples;
+}
 
-	// find the maximum of the autocorrelation (rejecting the first peak)
-	/*
-	 * the main problem with autocorrelation techniques is that a peak may also
-	 * occur at sub-harmonics or harmonics, but right now I can't come up with
-	 * anything better =(
-	 */
 
-	// search for a minimum in the autocorrelation to reject the peak centered around 0
-	unsigned int l;
-    for ( l = 0 ; (l < ( (ZERO_PADDING_FACTOR / 2) * _fftw_in_time_size + 1)) && ( (_fftw_in_time[l+1] < _fftw_in_time[l]) || (_fftw_in_time[l+1] > 0.0) ) ; ++l ) {};
-
-	// search for the maximum
-	double 			maxAutoCorrelation			= 0.0;
-	unsigned int	maxAutoCorrelation_index	= 0;
-	for (  ; l < ( (ZERO_PADDING_FACTOR / 2) * _fftw_in_time_size + 1) ; ++l ) {
-		if ( _fftw_in_time[l] > maxAutoCorrelation ) {
-			maxAutoCorrelation			= _fftw_in_time[l];
-			maxAutoCorrelation_index	= l;
-		}
+unsigned int QPitchCore::storeFrames( const short int* input, const unsigned int frameCount )
+{
+	// ** STORE THE SAME FRAMES IN EVERY CHANNEL ** //
+	// the space is checked first, so that the channels stay aligned when a ring buffer is full
+	unsigned int storedFrames = frameCount;
+	for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+		storedFrames = qMin( storedFrames, _channels[c]->writeAvailable( ) );
 	}
 
-	// compute the frequency of the maximum considering the padding factor
-	return ( (ZERO_PADDING_FACTOR / 2) * (2.0 * _sampleFrequency) / (double) maxAutoCorrelation_index );
+	for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+		_channels[c]->store( input, storedFrames, _channelCount );
+	}
+
+	return storedFrames;
 }
 
+
+void QPitchCore::processChannels( )
+{
+	// ** HAND THE OTHER CHANNELS TO THE ENGINE ** //
+	for ( int c = 1 ; c < _channels.size( ) ; ++c ) {
+		_engine->schedule( _channels[c] );
+	}
+
+	// ** ANALYSE THE FIRST CHANNEL IN THE CALLING THREAD ** //
+	_channels[0]->run( );
+
+	// ** WAIT FOR THE CHANNELS ANALYSED BY THE ENGINE ** //
+	for ( int c = 1 ; c < _channels.size( ) ; ++c ) {
+		_engine->waitForTask( _channels[c] );
+	}
+}
@@ -23,140 +23,308 @@
 #ifndef __QPITCHCORE_H_
 #define __QPITCHCORE_H_
 
-//! Definition used to feed the application with a reference squarewave
-//#define _REFERENCE_SQUAREWAVE_INPUT
-
 #include <cstring>
 #include <iostream>
-#include <stdexcept>
-
-#include <fftw3.h>
-#include <portaudio.h>
-
-#include <QMessageBox>
-#include <QThread>
-
-class QMutex;
-class QWaitCondition;
-
 
-//! An exception thrown when a PortAudio error occurs
-class QPaSoundInputException : public std::runtime_error {
+#include <QAtomicInteger>
+#include <QObject>
+#include <QVector>
 
-public: /* methods */
-	//! Default constructor.
-	/*!
-	 * \param[in] msg the error message to display
-	 */
-	QPaSoundInputException( const std::string& msg ) : std::runtime_error( msg ) {
-		return;
-	};
+#include "qfftw.h"
+#include "qframesnapshot.h"
+#include "qsoundinput.h"
 
-	//! Report exception.
-	void report( ) {
-		QMessageBox::critical( NULL, "QPitch", QString( "PortAudio error: %1." ).arg( this->what( ) ) );
-		std::cerr << "PortAudio error: " << this->what( ) << "\n";
-	};
-};
+class QPitchChannel;
+class QPitchEngine;
 
 
-//! Working thread for the QPitch application.
+//! Pitch detection session of the QPitch application.
 /*!
- * This class implements the main working thread for the QPitch
- * application.
- * The audio stream is acquired through the PortAudio library
- * (cross-platform) using a callback function. The size of the internal
- * buffer is set to the size suggested for robust non-interactive
- * application, since the latency is not an issue in this application.
- * In the current version the default audio input stream is used,
- * thus the selection of the audio input is performed using the control
- * panel of the operating system.
- * The pitch detection algorithm is based on the identification of the
- * first peak in the autocorrelation of the signal, which is computed
- * as the inverse FFT of the power spectral density of the signal
- * (the squared module of the signal FFT). The FFT is computed using
- * the FFTW3 library and prior to the inverse transform the signal is
- * zero-padded to increase the resolution of the autocorrelation in
- * order to have a better frequency identification.
+ * This class implements the pitch detection of one audio stream for the
+ * QPitch application.
+ * The audio stream is acquired from a QSoundInput (the PortAudio library
+ * in the application, but also a file, the standard input, a pipe, a
+ * synthesizer or any source delivering the samples from its own thread,
+ * e.g. a network socket) which delivers the samples through a callback
+ * function. The callback never blocks: the samples are pushed into a
+ * lock-free ring buffer, sized to several callback periods, which is
+ * drained by a task scheduled on a QPitchEngine.
+ * The pitch of each frame is estimated by a QPitchEstimator: the
+ * identification of the first peak in the autocorrelation of the signal
+ * (computed as the inverse FFT of the power spectral density of the
+ * signal), the YIN algorithm or the McLeod pitch method (both based on
+ * the difference function, computed with the same transforms). The FFT
+ * is computed using the FFTW3 library (the plans are shared through a
+ * process-wide cache, and the whole analysis can be built in single
+ * precision).
+ * The input samples are collected in a sliding window of fftFrameSize
+ * samples and a new estimate is computed each time hopSize new samples
+ * have been received, so that the update rate of the estimate does not
+ * depend on the length of the frame.
+ * The frame spans a few periods of the lowest frequency analysed at the
+ * full rate (40 Hz). When a lower note is requested (down to the low B
+ * flat of a contrabassoon), each channel decimates the stream by a power
+ * of two before the sliding window, so that the frame keeps the same
+ * number of periods of the lowest note while the size of the FFT, and
+ * the cost of each estimate, do not change.
+ * By default the frame size is only the largest one: the size of each
+ * frame is chosen from the previous estimate so that it spans a fixed
+ * number of periods, thus the high notes are estimated from short frames
+ * at a faster rate, while the low notes keep the accuracy of the long
+ * ones (see QPitchChannel).
+ * For the finest tuning (e.g. the regulation of a piano or a harp) a
+ * strobe note can be requested, usually the note identified by the
+ * tuner: once the estimates of the first channel settle on the note, the
+ * pitch estimator is replaced by a strobe (a QStrobeBank) that follows
+ * the phase of the partials of the note, which gives a continuous
+ * readout to a fraction of a cent at a lower cost and latency, until
+ * the note is left.
+ * A stream with several channels (e.g. a multi-input interface used to
+ * tune an ensemble) is deinterleaved by the callback into one ring
+ * buffer for each channel, and each channel is analysed by its own
+ * independent pipeline (a QPitchChannel), which is the task scheduled
+ * on the engine.
+ * The session does not own any thread: the engine is shared by all the
+ * sessions of the process (by default), so that hundreds of streams can
+ * be analysed concurrently by one thread for each core, sharing the
+ * FFTW plans, and a session only costs its buffers.
  */
 
-class QPitchCore : public QThread {
+class QPitchCore : public QObject {
 	Q_OBJECT
 
 
-#ifdef _REFERENCE_SQUAREWAVE_INPUT
-public: /* members */
-	short int			_referenceSineWave[4410];				//!< Artificial sine-wave used for debug
-	unsigned int		_referenceSineWave_index;				//!< Index incremented after each step to simulate time
+public: /* enumerations */
+	//! Method used to locate the peak of the autocorrelation.
+	enum PeakEstimation {
+		PEAK_ZERO_PADDING,									//!< IFFT zero-padded ZERO_PADDING_FACTOR times, peak at the closest padded sample
+		PEAK_INTERPOLATION									//!< IFFT at native size, peak interpolated with sub-sample accuracy
+	};
+
+	//! Algorithm used to estimate the pitch of a frame.
+	enum PitchEstimator {
+		ESTIMATOR_AUTOCORRELATION,							//!< First peak of the autocorrelation
+		ESTIMATOR_YIN,										//!< First dip of the cumulative mean normalized difference function (YIN)
+		ESTIMATOR_NSDF										//!< First key maximum of the normalized square difference function (McLeod)
+	};
+
+#ifdef QPITCH_STAGE_TIMING
+	//! Stages of the pitch detection algorithm timed by the benchmark.
+	enum AlgorithmStage {
+		STAGE_FFT,											//!< Forward FFT of the frame (and of the window for the difference function)
+		STAGE_POWER_SPECTRUM,								//!< Computation of |X|^2 (or of the cross spectrum)
+		STAGE_PADDING,										//!< Zero-padding (or copy of the power spectrum for the interpolation)
+		STAGE_IFFT,											//!< IFFT of the power spectrum
+		STAGE_MINIMUM_SEARCH,								//!< Search of the minimum that rejects the peak around 0 (or normalization of the difference function)
+		STAGE_MAXIMUM_SEARCH,								//!< Search (and refinement) of the maximum
+		STAGE_COUNT											//!< Number of stages
+	};
 #endif
 
 
+public: /* structures */
+	//! Latest state of the analysis of a channel, read by the views at their own pace (see latestState).
+	struct ChannelState {
+		bool					signalPresent;				//!< Current signal presence of the channel
+		double					streamTime;					//!< Time of the last sample of the last frame, measured from the start of the stream (in seconds)
+		double					estimatedFrequency;			//!< Last estimated frequency (0 without signal)
+		double					peakLevel;					//!< Peak level of the last block of samples (relative to the full scale)
+		double					rmsLevel;					//!< Root mean square level of the last block of samples (relative to the full scale)
+		double					strobeNote;					//!< Frequency of the note followed by the strobe (0 while it is not locked)
+		double					strobeFrequency;			//!< Frequency estimated while a strobe note is requested (0 without strobe note)
+		double					strobePhase;				//!< Phase of the strobe (in cycles of the note, in the range [0, 1))
+		QFrameSnapshotPointer	frame;						//!< Last snapshot of the plotted frame (first channel only, NULL before the first frame)
+
+		//! Default constructor.
+		ChannelState( ) : signalPresent( false ), streamTime( 0.0 ), estimatedFrequency( 0.0 ), peakLevel( 0.0 ), rmsLevel( 0.0 ),
+			strobeNote( 0.0 ), strobeFrequency( 0.0 ), strobePhase( 0.0 ) {
+			return;
+		};
+	};
+
+
 public: /* methods */
 	//! Default constructor.
 	/*!
-	 * \param[in] plotPlot_size the number of sample in the buffer used for visualization
+	 * \param[in] soundInput the source of the audio stream (the ownership is transferred to the session)
+	 * \param[in] plotPlot_size the largest number of columns of the envelopes used for visualization
+	 * \param[in] engine the engine that analyses the stream (default NULL, the engine shared by the process)
 	 * \param[in] parent a QObject* with the handle of the parent
 	 */
-	QPitchCore( const unsigned int plotPlot_size = 512, QObject* parent = 0 );
+	QPitchCore( QSoundInput* soundInput, const unsigned int plotPlot_size = 512, QPitchEngine* engine = NULL, QObject* parent = 0 );
 
 	//! Default destructor.
 	~QPitchCore( );
 
 	//! Start an input audio stream with the given properties.
 	/*!
-	 * \param[in] sampleFrequency the sample rate of the input stream (default 44100)
+	 * If the sound input cannot be started, the stream is closed again
+	 * before the exception is thrown.
+	 * \param[in] sampleFrequency the sample rate of the input stream, unless imposed by the sound input (default 44100)
 	 * \param[in] fftFrameSize the size of the frame used to compute the FFT and the note pitch (default 4096)
+	 * \param[in] hopSize the number of new samples between two consecutive estimates (default 0, no overlap between frames)
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation (default PEAK_INTERPOLATION)
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch (default ESTIMATOR_AUTOCORRELATION)
+	 * \param[in] channelCount the number of channels analysed, unless imposed by the sound input (default 1)
+	 * \param[in] lowestFrequency the lowest frequency that must be estimated (default 40.0)
 	 */
-	void startStream( const unsigned int sampleFrequency = 44100, const unsigned int fftFrameSize = 4096 );
+	void startStream( const unsigned int sampleFrequency = 44100, const unsigned int fftFrameSize = 4096,
+		const unsigned int hopSize = 0, const PeakEstimation peakEstimation = PEAK_INTERPOLATION,
+		const PitchEstimator pitchEstimator = ESTIMATOR_AUTOCORRELATION, const unsigned int channelCount = 1,
+		const double lowestFrequency = 40.0 );
+
+	//! Check whether the input audio stream has been started.
+	/*!
+	 * \return true between a successful startStream and the following stopStream
+	 */
+	bool isStreamStarted( ) const;
 
 	//! Stop the input audio stream.
+	/*!
+	 * The samples already stored in the ring buffers are analysed before
+	 * the function returns, so no signal is emitted after the return.
+	 * Since nothing is scheduled anymore, the workers of the engine then
+	 * sleep with no timeout till the stream is started again.
+	 */
 	void stopStream( );
 
-	//! Retrieve the device parameters.
+	//! Analyse a whole audio stream in the calling thread.
+	/*!
+	 * The samples are pulled from the sound input (which must be a
+	 * QStreamSoundInput, e.g. a WAV file) as fast as they are processed,
+	 * and the first channel is analysed in the calling thread, so that
+	 * its signals are emitted from the calling thread, while the other
+	 * channels are analysed by the engine. Thus several instances can
+	 * analyse different files concurrently, each one with its own buffers.
+	 * \param[in] sampleFrequency the sample rate of the input stream, unless imposed by the sound input (default 44100)
+	 * \param[in] fftFrameSize the size of the frame used to compute the FFT and the note pitch (default 4096)
+	 * \param[in] hopSize the number of new samples between two consecutive estimates (default 0, no overlap between frames)
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation (default PEAK_INTERPOLATION)
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch (default ESTIMATOR_AUTOCORRELATION)
+	 * \param[in] channelCount the number of channels analysed, unless imposed by the sound input (default 1)
+	 * \param[in] lowestFrequency the lowest frequency that must be estimated (default 40.0)
+	 * \throw QSoundInputException if the sound input cannot be read in the calling thread or cannot be opened
+	 */
+	void analyseStream( const unsigned int sampleFrequency = 44100, const unsigned int fftFrameSize = 4096,
+		const unsigned int hopSize = 0, const PeakEstimation peakEstimation = PEAK_INTERPOLATION,
+		const PitchEstimator pitchEstimator = ESTIMATOR_AUTOCORRELATION, const unsigned int channelCount = 1,
+		const double lowestFrequency = 40.0 );
+
+	//! Enable or disable the adaptive frame size for the next streams.
+	/*!
+	 * \param[in] enabled true to choose the size of each frame from the previous estimate (default), false to always use fftFrameSize
+	 */
+	void setAdaptiveFrame( const bool enabled );
+
+	//! Retrieve the frequency of the note requested to the strobe.
+	/*!
+	 * \return the frequency of the note (0 when the strobe is disabled)
+	 */
+	double strobeNote( ) const;
+
+	//! Retrieve the number of columns of the envelopes requested for visualization.
+	/*!
+	 * \return the number of columns (at least 1 and at most the size given to the constructor)
+	 */
+	unsigned int plotWidth( ) const;
+
+	//! Retrieve the description of the sound input.
 	/*!
-	 * \param[out] device the name of the device used by PortAudio plus the name of the API used by PortAudio
+	 * \param[out] device the description of the source of the audio stream
 	 */
-	void getPortAudioInfo( QString& device ) const;
+	void getSoundInputInfo( QString& device ) const;
 
 	//! Retrieve the audio stream parameters.
 	/*!
 	 * \param[out] sampleFrequency the sample rate of the input stream
 	 * \param[out] fftBufferSize the size of the frame used to compute the FFT and the note pitch
+	 * \param[out] hopSize the number of new samples between two consecutive estimates
+	 * \param[out] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[out] pitchEstimator the algorithm used to estimate the pitch
+	 * \param[out] channelCount the number of channels analysed
+	 * \param[out] lowestFrequency the lowest frequency that must be estimated
 	 */
-	void getStreamParameters( unsigned int& sampleFrequency, unsigned int& fftBufferSize ) const;
-	//	double& ) const;
+	void getStreamParameters( unsigned int& sampleFrequency, unsigned int& fftBufferSize, unsigned int& hopSize,
+		PeakEstimation& peakEstimation, PitchEstimator& pitchEstimator, unsigned int& channelCount, double& lowestFrequency ) const;
+
+	//! Retrieve the position reached in the audio stream.
+	/*!
+	 * The position is read without synchronization, thus it is exact only
+	 * when the stream is not being analysed (e.g. after stopStream).
+	 * \return the duration of the samples received since the start of the stream, dropped ones included (in seconds)
+	 */
+	double getStreamTime( ) const;
+
+	//! Retrieve the latest state of the analysis of a channel.
+	/*!
+	 * The state is published by the analysis once for each block of
+	 * samples and replaced by the next one, whether it has been read or
+	 * not, so a reader polling it at a fixed rate (e.g. the repaint timer
+	 * of the views) costs the same whatever the rate of the estimates,
+	 * while the signals are emitted for each estimate.
+	 * It must be called by a single thread (the reader), and it returns
+	 * false without any state while the stream is closed.
+	 * \param[in] channel the index of the channel in the frames of the stream
+	 * \param[out] state the latest state of the channel
+	 * \return true if the state has been updated since the previous call for the same channel
+	 */
+	bool latestState( const unsigned int channel, ChannelState& state );
+
+#ifdef QPITCH_STAGE_TIMING
+	//! Retrieve the time spent in each stage of the pitch detection algorithm since the start of the stream.
+	/*!
+	 * The times are updated without synchronization, thus they are exact only
+	 * when the stream is not being analysed (e.g. after analyseStream).
+	 * \param[out] stageTime the time spent in each stage (in nanoseconds)
+	 * \param[out] estimateCount the number of estimates computed
+	 */
+	void getStageTimings( qint64 stageTime[STAGE_COUNT], unsigned int& estimateCount ) const;
+#endif
 
     /*! \brief Dummy callback function to call the real non-static callback that does the work.
      *  \param[in] input Pointer to the interleaved input samples.
-     *  \param[out] output Pointer to the interleaved output samples.
-     *  \param[in] frameCount Number of sample frames to be processed.
-     *  \param[in] timeInfo Time when the buffer is processed.
-     *  \param[in] statusFlags Whether underflow or overflow occurred.
+     *  \param[in] frameCount Number of frames to be processed.
      *  \param[in] userData Pointer to user data.
+     *  \return Number of frames stored in the ring buffers.
      */
-    static int paCallback( const void* input, void* output, unsigned long frameCount,
-        const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void* userData );
+    static unsigned int soundInputCallback( const short int* input, unsigned int frameCount, void* userData );
 
-    /*! \brief Play the selected WAV file through the selected PortAudio device.
+    /*! \brief Store the input samples in the ring buffers of the channels and schedule their analysis.
      *  \param[in] input Pointer to the interleaved input samples.
-     *  \param[in] frameCount Number of sample frames to be processed.
+     *  \param[in] frameCount Number of frames to be processed.
+     *  \return Number of frames stored in the ring buffers.
      */
-    int paStoreInputBufferCallback( const short int* output, unsigned long frameCount );
+    unsigned int storeInputBufferCallback( const short int* input, unsigned int frameCount );
 
-signals:
-	//! Request an update in the audio stream signal graph.
+public slots:
+	//! Request the strobe of the first channel to follow a note.
 	/*!
-	 * \param[in] osziSample the array with the new samples of the input signal to display
-	 * \param[in] osziSample_timeRange the time range used to place the tick marks on the x-axis
+	 * The request is taken by the analysis at its next estimate, thus it
+	 * can be changed at any time (e.g. for each note identified by the
+	 * tuner) from any thread.
+	 * \param[in] noteFrequency the frequency of the note (0 to disable the strobe)
 	 */
-	void updatePlotSamples( const double* osziSample, double osziSample_timeRange );
+	void setStrobeNote( double noteFrequency );
 
-	//! Request an update in the autocorrelation graph.
+	//! Request the envelopes of the next snapshots to have a column for each pixel of the plot area.
+	/*!
+	 * As the note of the strobe, the request is taken by the analysis at
+	 * its next frame (e.g. when the view displaying the snapshots is resized).
+	 * \param[in] columnCount the width of the plot area in pixels (limited to the size given to the constructor)
+	 */
+	void setPlotWidth( unsigned int columnCount );
+
+signals:
+	//! Request an update in the graphs of the audio stream signal and of the autocorrelation.
 	/*!
-	 * \param[in] osziAutoCorr the array with the new samples of the autocorrelation to display
- 	 * \param[in] estimatedFrequency the value of the signal frequency estimated as the maximum of the autocorrelation
+	 * The snapshot is immutable and shared, so the receivers can keep it
+	 * (e.g. until the next one) without copying it, even across a queued
+	 * connection. Its autocorrelation is not filled while the strobe
+	 * follows the note, and the frames are skipped while the receivers
+	 * hold all the snapshots of the pool.
+	 * \param[in] frame the snapshot with the samples, the autocorrelation and the estimate of the first channel
 	 */
-	void updatePlotAutoCorr( const double* osziAutoCorr, double estimatedFrequency );
+	void updatePlotFrame( const QFrameSnapshotPointer& frame );
 
 	//! Request an update in the displayed value of the estimated frequency.
 	/*!
@@ -170,59 +338,138 @@ signals:
 	 */
 	void updateSignalPresence( bool signalPresent );
 
+	//! Signal a new estimate together with its position in the audio stream.
+	/*!
+	 * The signal is emitted for each estimate and once when the signal
+	 * falls below the threshold, so that a client without a GUI can log
+	 * the estimates without keeping track of the signal presence.
+	 * \param[in] streamTime the time of the last sample of the frame, measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the signal frequency estimated as the maximum of the autocorrelation (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence
+	 */
+	void updateTimedEstimate( double streamTime, double estimatedFrequency, bool signalPresent );
+
+	//! Signal a new estimate of one channel of the audio stream.
+	/*!
+	 * The signal is emitted for each estimate of every channel and once
+	 * when the signal of the channel falls below the threshold, while the
+	 * other signals only report the first channel. Like the other signals,
+	 * it is emitted by the thread of the engine that analyses the channel,
+	 * thus the slots of a direct connection may be called concurrently
+	 * for different channels (and for different sessions).
+	 * \param[in] channel the index of the channel in the frames of the stream
+	 * \param[in] streamTime the time of the last sample of the frame, measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the signal frequency estimated by the pitch detection algorithm (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence of the channel
+	 */
+	void updateChannelEstimate( unsigned int channel, double streamTime, double estimatedFrequency, bool signalPresent );
+
+	//! Signal that the signal of one channel of the audio stream has crossed the threshold.
+	/*!
+	 * The signal is emitted only when the presence changes, after the
+	 * state returned by latestState has been updated, so a reader that
+	 * polls the state only while a signal is present can use it to know
+	 * when to start polling again.
+	 * \param[in] channel the index of the channel in the frames of the stream
+	 * \param[in] signalPresent flag with the new signal presence of the channel
+	 */
+	void updateChannelPresence( unsigned int channel, bool signalPresent );
 
-protected:
-	//! Main loop of the thread.
-	virtual void run( );
+	//! Signal the level of a block of samples of one channel of the audio stream, to drive a level meter.
+	/*!
+	 * The signal is emitted for every block extracted from the ring buffer
+	 * of each channel (one callback period, after the decimation), whether
+	 * the signal is above the threshold or not.
+	 * \param[in] channel the index of the channel in the frames of the stream
+	 * \param[in] peakLevel the largest absolute value of the samples of the block (relative to the full scale)
+	 * \param[in] rmsLevel the root mean square value of the samples of the block (relative to the full scale)
+	 */
+	void updateChannelLevel( unsigned int channel, double peakLevel, double rmsLevel );
 
+	//! Signal a new estimate of the first channel while a strobe note is requested.
+	/*!
+	 * \param[in] noteFrequency the frequency of the note followed by the strobe (0 until the note is locked)
+	 * \param[in] estimatedFrequency the value of the signal frequency estimated by the strobe (or by the pitch detection algorithm until the note is locked)
+	 * \param[in] phase the phase of the strobe, the drift of the note accumulated since the lock (in cycles of the note, in the range [0, 1))
+	 */
+	void updateStrobe( double noteFrequency, double estimatedFrequency, double phase );
 
-private: /* enumerations */
-	//! Status of the visualization used to handle silence in the input stream.
-	enum VisualizationStatus {
-		STOPPED,
-		STOP_REQUEST,
-		START_REQUEST,
-		RUNNING
-		};
 
 private: /* static constants */
-	static const int	ZERO_PADDING_FACTOR;					//!< Number of times that the FFT is zero-padded to increase frequency resolution
-	static const int 	SIGNAL_THRESHOLD_ON;					//!< Value of the threshold above which the processing is activated
-	static const int 	SIGNAL_THRESHOLD_OFF;					//!< Value of the threshold below which the input audio signal is deactivated
+	static const int	RING_BUFFER_PERIODS;					//!< Number of callback periods that can be stored in the ring buffers
+	static const double	FULL_RATE_LOWEST_FREQUENCY;				//!< Lowest frequency analysed without decimating the audio stream
+	static const double	MIN_DECIMATED_FREQUENCY;				//!< Lowest sample rate of the analysis after the decimation
 
 
 private: /* members */
-	// ** PORTAUDIO STREAM ** //
-	PaStreamParameters	_inputParameters;						//!< Parameters of the input audio stream
-	PaStream*			_stream;								//!< Handle to the PortAudio stream
-	double				_sampleFrequency;						//!< PortAudio stream
-	short int*			_buffer;								//!< Internal buffer to store the input samples read in the callback
-	unsigned int		_buffer_size;							//!< Size of the internal buffer
-
-	// ** FFTW STRUCTURES ** //
-	fftw_plan			_fftw_plan_FFT;							//!< Plan to compute the FFT of a given signal
-	fftw_plan			_fftw_plan_IFFT;						//!< Plan to compute the IFFT of a given signal (with additional zero-padding
-	double*				_fftw_in_time;							//!< External buffer used to store signals in the time domain (first the input signal and then its autocorrelation)
-	unsigned int		_fftw_in_time_size;						//!< Size of the external buffer
-	unsigned int		_fftw_in_time_index;					//!< Index in the external buffer
-	fftw_complex*		_fftw_out_freq;							//!< Buffer used to store signals in the frequency domain (first the FFT of the input signal and later the FFT of its autocorrelation)
+	// ** SOUND INPUT ** //
+	QSoundInput*		_soundInput;							//!< Source of the audio stream
+	bool				_streamOpen;							//!< True when the stream of the sound input is open
+	bool				_realTimeInput;							//!< True when the samples not stored in the ring buffers are lost
+	double				_sampleFrequency;						//!< Sample rate of the audio stream
+	unsigned int		_channelCount;							//!< Number of interleaved channels of the audio stream
+	short int*			_buffer;								//!< Internal buffer to store the interleaved frames pulled from the sound input (offline analysis)
+	unsigned int		_buffer_size;							//!< Number of frames in the internal buffer (one callback period)
+	double				_streamTime;							//!< Duration of the samples received until the stream was closed, dropped ones included (in seconds)
+
+	// ** PITCH DETECTION ** //
+	QVector<QPitchChannel*>	_channels;							//!< Independent pipeline analysing each channel, owning its ring buffer and estimator
+	PitchEstimator		_pitchEstimator;						//!< Algorithm used to estimate the pitch
+	PeakEstimation		_peakEstimation;						//!< Method used to locate the peak of the autocorrelation
+	unsigned int		_frame_size;							//!< Size of the sliding window (size of the frame used to compute the FFT)
+	unsigned int		_hopSize;								//!< Number of new samples between two consecutive estimates
+	double				_lowestFrequency;						//!< Lowest frequency that must be estimated
+	unsigned int		_decimationFactor;						//!< Number of samples of the audio stream for each analysed sample
+	bool				_adaptiveFrame;							//!< True when the size of each frame is chosen from the previous estimate
+	QAtomicInteger<quint64>	_strobeNote;						//!< Frequency of the note requested to the strobe, stored as the bits of a double (0 when disabled)
+
+#ifdef QPITCH_STAGE_TIMING
+	// ** BENCHMARK ** //
+	qint64				_stageTime[STAGE_COUNT];				//!< Time spent in each stage of the pitch detection algorithm (in nanoseconds)
+	unsigned int		_estimateCount;							//!< Number of estimates computed since the start of the stream
+#endif
+
 	// ** THREAD HANDLING ** //
-	bool				_running;								//!< True when the thread is running
-	QMutex*				_mutex;									//!< Mutex used by the wait condition
-	QWaitCondition*		_waitCond;								//!< Wait condition used to put the thread to sleep while waiting for audio samples
+	QPitchEngine*		_engine;								//!< Engine whose threads analyse the channels
+	bool				_running;								//!< True when the stream is being analysed
 
-	// ** TEMPORARY BUFFERS USED FOR VISUALIZATION ** //
-	double*				_plotSample;							//!< Buffer used to store time samples used for visualization
-	double*				_plotAutoCorr;							//!< Buffer used to store autocorrelation samples used for visualization
-	unsigned int		_plotData_size;							//!< Total number of samples used for visualization
-	VisualizationStatus	_visualizationStatus;					//!< Visualization status used to handle silence
+	// ** VISUALIZATION ** //
+	unsigned int		_plotData_size;							//!< Largest number of columns of the envelopes used for visualization
+	QAtomicInteger<unsigned int>	_plotWidth;					//!< Number of columns of the envelopes requested for visualization
 
 private: /* methods */
-	//! Estimate the pitch of the input signal finding the first peak of the autocorrelation.
+	//! Open the sound input and allocate the buffers used by the analysis.
+	/*!
+	 * \param[in] sampleFrequency the sample rate of the input stream, unless imposed by the sound input
+	 * \param[in] fftFrameSize the size of the frame used to compute the FFT and the note pitch
+	 * \param[in] hopSize the number of new samples between two consecutive estimates
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch
+	 * \param[in] channelCount the number of channels analysed, unless imposed by the sound input
+	 * \param[in] lowestFrequency the lowest frequency that must be estimated
+	 */
+	void openStream( const unsigned int sampleFrequency, const unsigned int fftFrameSize, const unsigned int hopSize,
+		const PeakEstimation peakEstimation, const PitchEstimator pitchEstimator, const unsigned int channelCount,
+		const double lowestFrequency );
+
+	//! Close the sound input and release the buffers used by the analysis.
+	void closeStream( );
+
+	//! Store the frames in the ring buffers of the channels, never blocking.
+	/*!
+	 * \param[in] input the array with the interleaved frames
+	 * \param[in] frameCount the number of frames in the array
+	 * \return the number of frames stored in all the ring buffers
+	 */
+	unsigned int storeFrames( const short int* input, const unsigned int frameCount );
+
+	//! Analyse the samples waiting in the ring buffers of all the channels.
 	/*!
-	 * \return the frequency value corresponding to the maximum of the autocorrelation
+	 * The first channel is analysed by the calling thread and the other
+	 * ones by the engine; the function returns when all the ring buffers
+	 * have been drained.
 	 */
-	double fftw_pitchDetectionAlgorithm( );
+	void processChannels( );
 };
 #endif
 
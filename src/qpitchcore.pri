@@ -0,0 +1,57 @@
+# .pri file with the analysis and the sound inputs, which only depend on
+# QtCore and are shared by the application, the command line version and
+# the benchmark
+
+
+## FILES AND DIRECTORIES ##
+HEADERS			+=	\
+					qautocorrelationestimator.h \
+					qdecimator.h \
+					qdifferenceestimator.h \
+					qfftw.h \
+					qfftwplancache.h \
+					qframesnapshot.h \
+					qlatestvalue.h \
+					qnsdfestimator.h \
+					qpasoundinput.h \
+					qpitchchannel.h \
+					qpitchcore.h \
+					qpitchengine.h \
+					qpitchestimator.h \
+					qplotenvelope.h \
+					qrawsoundinput.h \
+					qringbuffer.h \
+					qsamplescanner.h \
+					qsoundinput.h \
+					qsoundinputfactory.h \
+					qstreamsoundinput.h \
+					qstrobebank.h \
+					qsynthsoundinput.h \
+					qtuningscale.h \
+					qwakeup.h \
+					qwavsoundinput.h \
+					qyinestimator.h
+
+SOURCES			+=	\
+					qautocorrelationestimator.cpp \
+					qdecimator.cpp \
+					qdifferenceestimator.cpp \
+					qfftwplancache.cpp \
+					qframesnapshot.cpp \
+					qnsdfestimator.cpp \
+					qpasoundinput.cpp \
+					qpitchchannel.cpp \
+					qpitchcore.cpp \
+					qpitchengine.cpp \
+					qpitchestimator.cpp \
+					qplotenvelope.cpp \
+					qrawsoundinput.cpp \
+					qsamplescanner.cpp \
+					qsoundinputfactory.cpp \
+					qstreamsoundinput.cpp \
+					qstrobebank.cpp \
+					qsynthsoundinput.cpp \
+					qtuningscale.cpp \
+					qwakeup.cpp \
+					qwavsoundinput.cpp \
+					qyinestimator.cpp
@@ -0,0 +1,257 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchengine.h"
+#include "qwakeup.h"
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+
+//! Worker thread of the QPitchEngine.
+class QPitchEngineWorker : public QThread {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] engine the engine that owns the worker
+	 * \param[in] worker the index of the worker
+	 */
+	QPitchEngineWorker( QPitchEngine* engine, const int worker ) : QThread( ), _engine( engine ), _worker( worker ) {
+		return;
+	};
+
+protected:
+	//! Main loop of the thread.
+	virtual void run( ) {
+		_engine->runWorker( _worker );
+	};
+
+private: /* members */
+	QPitchEngine*		_engine;								//!< Engine that owns the worker
+	int					_worker;								//!< Index of the worker
+};
+
+
+QPitchEngine* QPitchEngine::instance( )
+{
+	// ** CREATE THE ENGINE THE FIRST TIME IT IS USED ** //
+	static QPitchEngine engine;
+	return &engine;
+}
+
+
+QPitchEngine::QPitchEngine( const int threadCount )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_pendingTasks.storeRelaxed( NULL );
+	_stopping.storeRelaxed( 0 );
+	_wakeup			= new QWakeup( );
+	_idleMutex		= new QMutex( );
+	_idleCond		= new QWaitCondition( );
+
+	// ** INITIALIZE THE QUEUES OF THE WORKERS ** //
+	// the queues are allocated before starting any thread, since the workers steal from each other
+	const int workerCount = ( threadCount > 0 ) ? threadCount : qMax( QThread::idealThreadCount( ), 1 );
+	_queues.resize( workerCount );
+	for ( int w = 0 ; w < workerCount ; ++w ) {
+		_queues[w].mutex = new QMutex( );
+	}
+
+	// ** START THE WORKER THREADS ** //
+	for ( int w = 0 ; w < workerCount ; ++w ) {
+		_workers.append( new QPitchEngineWorker( this, w ) );
+		_workers[w]->start( QThread::HighPriority );
+	}
+}
+
+
+QPitchEngine::~QPitchEngine( )
+{
+	// ** ENSURE THAT NO TASK IS WAITING ** //
+	Q_ASSERT( _pendingTasks.loadAcquire( ) == NULL );
+
+	// ** STOP THE WORKER THREADS ** //
+	_stopping.storeRelease( 1 );
+	_wakeup->wakeAll( );
+	for ( int w = 0 ; w < _workers.size( ) ; ++w ) {
+		_workers[w]->wait( );
+	}
+
+	// ** RELEASE RESOURCES ** //
+	qDeleteAll( _workers );
+	for ( int w = 0 ; w < _queues.size( ) ; ++w ) {
+		Q_ASSERT( _queues[w].tasks.isEmpty( ) );
+		delete _queues[w].mutex;
+	}
+	delete		_wakeup;
+	delete		_idleMutex;
+	delete		_idleCond;
+}
+
+
+void QPitchEngine::schedule( QPitchTask* task )
+{
+	Q_ASSERT( task != NULL );
+
+	// ** QUEUE THE TASK ONLY IF IT IS IDLE ** //
+	// otherwise the worker running it sees the new request and runs it again
+	if ( task->_requests.fetchAndAddOrdered( 1 ) != 0 ) {
+		return;
+	}
+
+	// ** PUSH THE TASK ON THE LIST OF PENDING TASKS ** //
+	// the list is only emptied at once by the workers, so the push cannot suffer from the ABA problem
+	QPitchTask* head;
+	do {
+		head = _pendingTasks.loadAcquire( );
+		task->_nextPending = head;
+	} while ( ! _pendingTasks.testAndSetOrdered( head, task ) );
+
+	// ** WAKE UP AN IDLE WORKER ** //
+	// the wake up takes no lock, and the busy workers find the list anyway when they look for their next task
+	_wakeup->wakeOne( );
+}
+
+
+void QPitchEngine::waitForTask( QPitchTask* task )
+{
+	Q_ASSERT( task != NULL );
+
+	// ** WAIT TILL THE TASK HAS SERVED ALL THE REQUESTS ** //
+	// the worker locks the mutex after releasing the task, so the wake up cannot be lost
+	_idleMutex->lock( );
+	while ( task->_requests.loadAcquire( ) != 0 ) {
+		_idleCond->wait( _idleMutex );
+	}
+	_idleMutex->unlock( );
+}
+
+
+void QPitchEngine::runWorker( const int worker )
+{
+	forever {
+		// ** FIND A TASK ** //
+		// the wake ups are counted before looking for a task, so a task scheduled meanwhile cannot be missed
+		const int wakeups = _wakeup->count( );
+		QPitchTask* task = takeTask( worker );
+		if ( task == NULL ) {
+			if ( _stopping.loadAcquire( ) != 0 ) {
+				return;
+			}
+
+			// ** SLEEP TILL A TASK IS SCHEDULED ** //
+			// there is no timeout, so the idle workers do not run at all while no session is running
+			_wakeup->wait( wakeups );
+			continue;
+		}
+
+		// ** RUN THE TASK ** //
+		runTask( task, worker );
+	}
+}
+
+
+QPitchTask* QPitchEngine::takeTask( const int worker )
+{
+	QPitchTask* task = NULL;
+
+	// ** TAKE THE OLDEST TASK OF THE OWN QUEUE ** //
+	_queues[worker].mutex->lock( );
+	if ( ! _queues[worker].tasks.isEmpty( ) ) {
+		task = _queues[worker].tasks.takeFirst( );
+	}
+	_queues[worker].mutex->unlock( );
+
+	if ( task != NULL ) {
+		return task;
+	}
+
+	// ** TAKE ALL THE TASKS SCHEDULED FROM OUTSIDE THE ENGINE ** //
+	QPitchTask* pendingTasks = _pendingTasks.fetchAndStoreAcquire( NULL );
+	if ( pendingTasks != NULL ) {
+		// the list is in reverse order of scheduling
+		QList<QPitchTask*> tasks;
+		for ( QPitchTask* t = pendingTasks ; t != NULL ; t = t->_nextPending ) {
+			tasks.prepend( t );
+		}
+
+		task = tasks.takeFirst( );
+		if ( ! tasks.isEmpty( ) ) {
+			_queues[worker].mutex->lock( );
+			_queues[worker].tasks.append( tasks );
+			_queues[worker].mutex->unlock( );
+
+			// let an idle worker steal the other tasks
+			_wakeup->wakeOne( );
+		}
+		return task;
+	}
+
+	// ** STEAL THE MOST RECENT TASK OF ANOTHER WORKER ** //
+	for ( int w = 1 ; w < _queues.size( ) ; ++w ) {
+		WorkerQueue& queue = _queues[(worker + w) % _queues.size( )];
+		bool moreTasks = false;
+		queue.mutex->lock( );
+		if ( ! queue.tasks.isEmpty( ) ) {
+			task = queue.tasks.takeLast( );
+			moreTasks = ! queue.tasks.isEmpty( );
+		}
+		queue.mutex->unlock( );
+
+		if ( task != NULL ) {
+			// the idle workers are woken up one at a time, so the next one is woken up while tasks are left
+			if ( moreTasks ) {
+				_wakeup->wakeOne( );
+			}
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+
+void QPitchEngine::runTask( QPitchTask* task, const int worker )
+{
+	// ** RUN THE TASK ** //
+	// the requests received so far are all served by this run
+	const int requests = task->_requests.loadAcquire( );
+	Q_ASSERT( requests > 0 );
+	task->run( );
+
+	if ( task->_requests.fetchAndAddOrdered( -requests ) != requests ) {
+		// ** SCHEDULED AGAIN DURING THE RUN ** //
+		// the task is queued behind the others, so that a busy session cannot starve the other ones
+		_queues[worker].mutex->lock( );
+		_queues[worker].tasks.append( task );
+		_queues[worker].mutex->unlock( );
+	} else {
+		// ** SIGNAL THAT THE TASK IS IDLE ** //
+		// the task may be deleted as soon as the counter is zero, so it is not used anymore
+		_idleMutex->lock( );
+		_idleCond->wakeAll( );
+		_idleMutex->unlock( );
+	}
+}
+
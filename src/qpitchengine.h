@@ -0,0 +1,181 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHENGINE_H_
+#define __QPITCHENGINE_H_
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QList>
+#include <QVector>
+
+class QMutex;
+class QPitchEngineWorker;
+class QWaitCondition;
+class QWakeup;
+
+
+//! Unit of work scheduled on a QPitchEngine.
+/*!
+ * A task is scheduled each time new work is available (e.g. each time
+ * the callback of a sound input stores new samples in a ring buffer) and
+ * run( ) must process all the work available when it is called.
+ * The engine guarantees that a task is never run by two threads at the
+ * same time and that it is run again when it has been scheduled during
+ * the previous run, so a task can be scheduled any number of times
+ * without losing work and without being queued more than once.
+ */
+
+class QPitchTask {
+	friend class QPitchEngine;
+
+public: /* methods */
+	//! Default constructor.
+	QPitchTask( ) : _requests( 0 ), _nextPending( NULL ) {
+		return;
+	};
+
+	//! Default destructor (the task must not be scheduled).
+	virtual ~QPitchTask( ) {
+		return;
+	};
+
+	//! Process all the work available.
+	virtual void run( ) = 0;
+
+
+private: /* members */
+	QAtomicInt			_requests;								//!< Number of schedule requests not served yet (0 when the task is idle)
+	QPitchTask*			_nextPending;							//!< Next task in the list of the tasks scheduled from outside the engine
+
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QPitchTask( const QPitchTask& );
+
+	//! Disabled assignment operator.
+	QPitchTask& operator=( const QPitchTask& );
+};
+
+
+//! Work-stealing thread pool shared by many pitch detection sessions.
+/*!
+ * This class runs the tasks of any number of independent sessions (the
+ * channels of the audio streams analysed by each QPitchCore) on a fixed
+ * set of worker threads, one for each core by default, so that the
+ * number of threads does not grow with the number of sessions and the
+ * FFTW plans are shared through the plan cache.
+ * The tasks scheduled from outside the engine (e.g. by the callback of
+ * a sound input) are pushed on a lock-free list, and an idle worker is
+ * woken up through a QWakeup, which takes no lock on Linux; the worker
+ * takes the list whole, appends it to its own queue and wakes up another
+ * idle worker if more than one task was waiting.
+ * The idle workers sleep with no timeout, so the engine uses no CPU
+ * while no session is running.
+ * Each worker runs the tasks of its own queue in order and, when the
+ * queue is empty, steals the most recent tasks from the queues of the
+ * other workers.
+ */
+
+class QPitchEngine {
+	friend class QPitchEngineWorker;
+
+public: /* methods */
+	//! Retrieve the engine shared by the whole process.
+	static QPitchEngine* instance( );
+
+	//! Default constructor.
+	/*!
+	 * \param[in] threadCount the number of worker threads (default 0, one for each core)
+	 */
+	QPitchEngine( const int threadCount = 0 );
+
+	//! Default destructor (no task may be scheduled).
+	~QPitchEngine( );
+
+	//! Retrieve the number of worker threads.
+	int threadCount( ) const { return _workers.size( ); };
+
+	//! Request the execution of a task.
+	/*!
+	 * The function only pushes the task on a lock-free list and wakes up
+	 * an idle worker without blocking, thus it can be called from a
+	 * real-time thread. A task that is already scheduled is run again
+	 * after the current run.
+	 * \param[in] task the task to run
+	 */
+	void schedule( QPitchTask* task );
+
+	//! Wait till a task has served all its schedule requests.
+	/*!
+	 * \param[in] task the task to wait for (it can be deleted after the return, unless scheduled again)
+	 */
+	void waitForTask( QPitchTask* task );
+
+
+private: /* structures */
+	//! Queue of the tasks ready to be run by a worker.
+	struct WorkerQueue {
+		QMutex*				mutex;								//!< Mutex protecting the queue (locked by the owner and by the thieves)
+		QList<QPitchTask*>	tasks;								//!< Tasks in the order of execution
+	};
+
+
+private: /* members */
+	QVector<QPitchEngineWorker*>	_workers;					//!< Worker threads
+	QVector<WorkerQueue>			_queues;					//!< Queue of each worker
+	QAtomicPointer<QPitchTask>		_pendingTasks;				//!< Lock-free list of the tasks scheduled from outside the engine (most recent first)
+	QWakeup*						_wakeup;					//!< Wake up of the idle workers (it never blocks the callers)
+	QAtomicInt						_stopping;					//!< Non-zero when the workers must terminate
+	QMutex*							_idleMutex;					//!< Mutex used by the wait condition of the idle tasks
+	QWaitCondition*					_idleCond;					//!< Wait condition used to signal that a task has become idle
+
+
+private: /* methods */
+	//! Main loop of a worker thread.
+	/*!
+	 * \param[in] worker the index of the worker
+	 */
+	void runWorker( const int worker );
+
+	//! Find the next task to run by a worker.
+	/*!
+	 * \param[in] worker the index of the worker
+	 * \return the task to run (NULL if no task is ready)
+	 */
+	QPitchTask* takeTask( const int worker );
+
+	//! Run a task and queue it again if it has been scheduled in the meantime.
+	/*!
+	 * \param[in] task the task to run
+	 * \param[in] worker the index of the worker
+	 */
+	void runTask( QPitchTask* task, const int worker );
+
+	//! Disabled copy constructor.
+	QPitchEngine( const QPitchEngine& );
+
+	//! Disabled assignment operator.
+	QPitchEngine& operator=( const QPitchEngine& );
+};
+
+#endif /* __QPITCHENGINE_H_ */
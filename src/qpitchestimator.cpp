@@ -0,0 +1,88 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchestimator.h"
+#include "qautocorrelationestimator.h"
+#include "qfftwplancache.h"
+#include "qnsdfestimator.h"
+#include "qyinestimator.h"
+
+
+QPitchEstimator* QPitchEstimator::create( const QPitchCore::PitchEstimator pitchEstimator, const QPitchCore::PeakEstimation peakEstimation,
+	const unsigned int frameSize, const double sampleFrequency )
+{
+	switch ( pitchEstimator ) {
+		case QPitchCore::ESTIMATOR_YIN:
+			return new QYinEstimator( frameSize, sampleFrequency );
+
+		case QPitchCore::ESTIMATOR_NSDF:
+			return new QNsdfEstimator( frameSize, sampleFrequency );
+
+		default:
+		case QPitchCore::ESTIMATOR_AUTOCORRELATION:
+			return new QAutoCorrelationEstimator( frameSize, peakEstimation, sampleFrequency );
+	}
+}
+
+
+QPitchEstimator::QPitchEstimator( const unsigned int frameSize, const unsigned int zeroPaddingFactor, const double sampleFrequency )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_fftw_in_time_size	= frameSize;
+	_zeroPaddingFactor	= zeroPaddingFactor;
+	_sampleFrequency	= sampleFrequency;
+#ifdef QPITCH_STAGE_TIMING
+	_stageTime			= NULL;
+#endif
+
+	// ** INITIALIZE FFT STRUCTURES ** //
+	_fftw_in_time	= (qfftw_real*) QFFTW( malloc )( _zeroPaddingFactor * sizeof(qfftw_real) * _fftw_in_time_size );
+	_fftw_out_freq	= (qfftw_complex*) QFFTW( malloc )( _zeroPaddingFactor * sizeof(qfftw_complex) * _fftw_in_time_size );
+	_fftw_plans		= QFftwPlanCache::instance( )->plans( _fftw_in_time_size, _zeroPaddingFactor );		// FFT and IFFT (zero-padded if required)
+}
+
+
+QPitchEstimator::~QPitchEstimator( )
+{
+	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
+	Q_ASSERT( _fftw_in_time		!= NULL );
+	Q_ASSERT( _fftw_out_freq	!= NULL );
+
+	// ** DESTROY FFTW STRUCTURES ** //
+	// the plans are kept by the plan cache for the next stream
+	QFFTW( free )( _fftw_in_time );
+	QFFTW( free )( _fftw_out_freq );
+}
+
+
+void QPitchEstimator::fftw_frame( const qfftw_real* frame, qfftw_complex* freq ) const
+{
+	// ** ENSURE THAT FFTW STRUCTURES ARE VALID ** //
+	Q_ASSERT( _fftw_plans	!= NULL );
+	Q_ASSERT( frame			!= NULL );
+
+	// ** COMPUTE THE FFT OF THE FRAME IN PLACE ** //
+	// the execute functions do not modify an out-of-place real input, but they are not declared const
+	qfftw_real* in_time = const_cast<qfftw_real*>( frame );
+	const qfftw_plan fft = ( QFFTW( alignment_of )( in_time ) == 0 ) ? _fftw_plans->fft( ) : _fftw_plans->fftUnaligned( );
+	QFFTW( execute_dft_r2c )( fft, in_time, freq );
+}
@@ -0,0 +1,144 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHESTIMATOR_H_
+#define __QPITCHESTIMATOR_H_
+
+#include "qfftw.h"
+#include "qpitchcore.h"
+
+class QFftwPlans;
+
+// ** TIMING OF THE STAGES OF THE PITCH DETECTION ALGORITHM (BENCHMARK ONLY) ** //
+#ifdef QPITCH_STAGE_TIMING
+#include <QElapsedTimer>
+#define QPITCH_STAGE_BEGIN( )			QElapsedTimer stageTimer; stageTimer.start( )
+#define QPITCH_STAGE_END( stage )		_stageTime[QPitchCore::stage] += stageTimer.nsecsElapsed( ); stageTimer.start( )
+#else
+#define QPITCH_STAGE_BEGIN( )
+#define QPITCH_STAGE_END( stage )
+#endif
+
+
+//! Base class of the pitch detection algorithms used by QPitchCore.
+/*!
+ * This class defines the interface of the estimators of the pitch of a
+ * frame, so that the working thread does not depend on the algorithm.
+ * The FFT reads the frame in place, wherever it lies in the sliding
+ * window of the caller, and the frame is never modified. The estimator
+ * owns the other FFTW buffers, among which the function of the lag (the
+ * autocorrelation or its normalized counterpart) which is displayed by
+ * the oscilloscope view.
+ * The plans are shared by all the estimators through the plan cache and
+ * executed with the new-array execute functions.
+ */
+
+class QPitchEstimator {
+
+public: /* methods */
+	//! Create the estimator implementing a pitch detection algorithm.
+	/*!
+	 * \param[in] pitchEstimator the pitch detection algorithm
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation (autocorrelation only)
+	 * \param[in] frameSize the size of the frame used to compute the FFT and the note pitch
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 * \return the estimator (owned by the caller)
+	 */
+	static QPitchEstimator* create( const QPitchCore::PitchEstimator pitchEstimator, const QPitchCore::PeakEstimation peakEstimation,
+		const unsigned int frameSize, const double sampleFrequency );
+
+	//! Default destructor.
+	virtual ~QPitchEstimator( );
+
+	//! Retrieve the size of the frame.
+	unsigned int frameSize( ) const {
+		return _fftw_in_time_size;
+	};
+
+	//! Estimate the pitch of a frame.
+	/*!
+	 * \param[in] frame the frameSize samples to analyse (read in place, with any alignment)
+	 * \return the estimated frequency (0 if the frame does not show any periodicity)
+	 */
+	virtual double estimate( const qfftw_real* frame ) = 0;
+
+	//! Retrieve the function of the lag computed by the last estimate.
+	/*!
+	 * The function has lagOversampling( ) samples for each sample of the
+	 * frame and it is normalized so that the estimated period is a peak.
+	 * \return the buffer with the function of the lag
+	 */
+	const qfftw_real* lagFunction( ) const {
+		return _fftw_in_time;
+	};
+
+	//! Retrieve the number of samples of the function of the lag for each sample of the frame.
+	unsigned int lagOversampling( ) const {
+		return _zeroPaddingFactor;
+	};
+
+#ifdef QPITCH_STAGE_TIMING
+	//! Set the array where the time spent in each stage of the algorithm is accumulated.
+	/*!
+	 * \param[in] stageTime the array with the time spent in each stage (in nanoseconds)
+	 */
+	void setStageTimings( qint64* stageTime ) {
+		_stageTime = stageTime;
+	};
+#endif
+
+
+protected: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] frameSize the size of the frame used to compute the FFT
+	 * \param[in] zeroPaddingFactor the number of times that the IFFT is zero-padded
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 */
+	QPitchEstimator( const unsigned int frameSize, const unsigned int zeroPaddingFactor, const double sampleFrequency );
+
+	//! Compute the FFT of a frame read in place.
+	/*!
+	 * The plan for an unaligned input is used only when the frame does
+	 * not have the alignment of the buffers allocated with fftw_malloc.
+	 * The out-of-place real-to-complex transform preserves its input.
+	 * \param[in] frame the frameSize samples of the frame
+	 * \param[out] freq the frameSize / 2 + 1 samples of the FFT
+	 */
+	void fftw_frame( const qfftw_real* frame, qfftw_complex* freq ) const;
+
+
+protected: /* members */
+	// ** FFTW STRUCTURES ** //
+	const QFftwPlans*	_fftw_plans;							//!< Plans to compute the FFT and the (zero-padded) IFFT of a given signal, owned by the plan cache
+	qfftw_real*			_fftw_in_time;							//!< Buffer used to store signals in the time domain (the function of the lag)
+	unsigned int		_fftw_in_time_size;						//!< Size of the frame
+	qfftw_complex*		_fftw_out_freq;							//!< Buffer used to store signals in the frequency domain
+	unsigned int		_zeroPaddingFactor;						//!< Number of times that the IFFT is zero-padded
+	double				_sampleFrequency;						//!< Sample rate of the audio stream
+
+#ifdef QPITCH_STAGE_TIMING
+	qint64*				_stageTime;								//!< Time spent in each stage of the algorithm (in nanoseconds), owned by QPitchCore
+#endif
+};
+
+#endif /* __QPITCHESTIMATOR_H_ */
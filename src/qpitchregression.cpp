@@ -0,0 +1,203 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qpitchregression.h"
+#include "qbenchsoundinput.h"
+
+#include <QtNumeric>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+/*
+ * the tolerances are given for each method (autocorrelation with zero-padding,
+ * autocorrelation with interpolation, YIN, NSDF) about 10 percent above the
+ * error measured in double and single precision, and never below 1 cent.
+ * The autocorrelation is biased: each lag is summed over N - lag samples,
+ * so its peaks are tilted toward the shorter lags, and a pure tone with only
+ * a few periods in the frame (the lowest ones) is estimated sharp by up to
+ * 75 cents with both peak estimations, which refine the position of the same
+ * tilted peak. This is the long-standing behaviour of the autocorrelation
+ * method, kept for compatibility: the harmonics of real instruments have
+ * narrower peaks (see the strings), and YIN and NSDF, which normalise the
+ * lags, are the accurate methods for the lowest notes, so their tolerances
+ * are tight and catch any regression of the pure tones
+ */
+const QPitchRegressionCase QPitchRegression::CASES[] = {
+	// pure tones (the biased autocorrelation pulls the peak of the lowest ones toward shorter lags)
+	{ "sine-E1",			QSynthSoundInput::WAVE_SINE,		41.20,		0.0,	{ 83.0, 83.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sine-E2",			QSynthSoundInput::WAVE_SINE,		82.41,		0.0,	{ 51.5, 52.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sine-A3",			QSynthSoundInput::WAVE_SINE,		220.00,		0.0,	{ 4.0, 4.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sine-A4",			QSynthSoundInput::WAVE_SINE,		440.00,		0.0,	{ 7.5, 6.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sine-A5",			QSynthSoundInput::WAVE_SINE,		880.00,		0.0,	{ 5.0, 6.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sine-B6",			QSynthSoundInput::WAVE_SINE,		1975.53,	0.0,	{ 7.0, 6.0, 2.0, 1.0 },	0.0,	40.0,	0.0 },
+	// square and sawtooth waves
+	{ "square-A1",			QSynthSoundInput::WAVE_SQUARE,		55.00,		0.0,	{ 1.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "square-G3",			QSynthSoundInput::WAVE_SQUARE,		196.00,		0.0,	{ 1.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "square-C6",			QSynthSoundInput::WAVE_SQUARE,		1046.50,	0.0,	{ 1.5, 1.5, 2.0, 1.5 },	0.0,	40.0,	0.0 },
+	{ "sawtooth-D2",		QSynthSoundInput::WAVE_SAWTOOTH,	73.42,		0.0,	{ 1.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sawtooth-B3",		QSynthSoundInput::WAVE_SAWTOOTH,	246.94,		0.0,	{ 1.5, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "sawtooth-E6",		QSynthSoundInput::WAVE_SAWTOOTH,	1318.51,	0.0,	{ 5.0, 1.5, 2.0, 1.5 },	0.0,	40.0,	0.0 },
+	// harmonic-rich strings with a weak fundamental
+	{ "string-E1",			QSynthSoundInput::WAVE_STRING,		41.20,		0.0,	{ 13.0, 13.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "string-E2",			QSynthSoundInput::WAVE_STRING,		82.41,		0.0,	{ 5.5, 5.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "string-A2",			QSynthSoundInput::WAVE_STRING,		110.00,		0.0,	{ 1.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "string-D3",			QSynthSoundInput::WAVE_STRING,		146.83,		0.0,	{ 3.5, 3.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "string-G3",			QSynthSoundInput::WAVE_STRING,		196.00,		0.0,	{ 1.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	// detuned notes
+	{ "detuned-A4+23",		QSynthSoundInput::WAVE_HARMONICS,	445.89,		0.0,	{ 1.5, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "detuned-A4-23",		QSynthSoundInput::WAVE_HARMONICS,	434.18,		0.0,	{ 2.0, 1.0, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "detuned-E4+37",		QSynthSoundInput::WAVE_HARMONICS,	336.78,		0.0,	{ 1.5, 1.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	{ "detuned-A2-45",		QSynthSoundInput::WAVE_HARMONICS,	107.19,		0.0,	{ 7.5, 7.5, 1.0, 1.0 },	0.0,	40.0,	0.0 },
+	// noisy signals
+	{ "noisy-sine-A4",		QSynthSoundInput::WAVE_SINE,		440.00,		0.5,	{ 10.5, 12.0, 16.0, 10.0 },	0.05,	40.0,	0.0 },
+	{ "noisy-harmonics-A3",	QSynthSoundInput::WAVE_HARMONICS,	220.00,		0.3,	{ 5.0, 6.5, 10.5, 5.5 },	0.05,	40.0,	0.0 },
+	{ "noisy-string-E2",	QSynthSoundInput::WAVE_STRING,		82.41,		0.2,	{ 4.5, 4.5, 8.0, 3.5 },	0.05,	40.0,	0.0 },
+	// notes below 40 Hz (and the notes above them) analysed at a decimated rate
+	{ "sine-B0",			QSynthSoundInput::WAVE_SINE,		30.87,		0.0,	{ 72.0, 72.0, 1.0, 1.0 },	0.0,	30.0,	0.0 },
+	{ "string-B0",			QSynthSoundInput::WAVE_STRING,		30.87,		0.0,	{ 3.5, 3.5, 1.0, 1.0 },	0.0,	30.0,	0.0 },
+	{ "harmonics-Bb0",		QSynthSoundInput::WAVE_HARMONICS,	29.14,		0.0,	{ 2.0, 2.0, 1.0, 1.0 },	0.0,	25.0,	0.0 },
+	{ "string-E1-low",		QSynthSoundInput::WAVE_STRING,		41.20,		0.0,	{ 6.0, 5.5, 1.0, 1.0 },	0.0,	20.0,	0.0 },
+	{ "harmonics-A4-low",	QSynthSoundInput::WAVE_HARMONICS,	440.00,		0.0,	{ 1.0, 2.0, 1.0, 1.0 },	0.0,	20.0,	0.0 },
+	{ "noisy-string-B0",	QSynthSoundInput::WAVE_STRING,		30.87,		0.2,	{ 4.5, 4.5, 3.5, 3.5 },	0.05,	30.0,	0.0 },
+	// notes followed by the strobe once locked (the first estimates still come from the pitch estimator)
+	{ "strobe-sine-A4",		QSynthSoundInput::WAVE_SINE,		440.00,		0.0,	{ 0.5, 0.5, 0.5, 0.5 },	0.0,	40.0,	440.00 },
+	{ "strobe-detuned-A4+23",	QSynthSoundInput::WAVE_HARMONICS,	445.89,		0.0,	{ 0.5, 0.5, 0.5, 0.5 },	0.0,	40.0,	440.00 },
+	{ "strobe-string-A2",	QSynthSoundInput::WAVE_STRING,		110.00,		0.0,	{ 0.5, 0.5, 0.5, 0.5 },	0.0,	40.0,	110.00 },
+	{ "strobe-string-B0",	QSynthSoundInput::WAVE_STRING,		30.87,		0.0,	{ 0.5, 0.5, 0.5, 0.5 },	0.0,	30.0,	30.87 },
+	{ "strobe-noisy-harmonics-A3",	QSynthSoundInput::WAVE_HARMONICS,	220.00,		0.3,	{ 2.0, 2.0, 2.0, 2.0 },	0.05,	40.0,	220.00 }
+};
+const int			QPitchRegression::CASE_COUNT		= sizeof( CASES ) / sizeof( CASES[0] );
+const unsigned int	QPitchRegression::SAMPLE_FREQUENCY	= 44100;
+const unsigned int	QPitchRegression::FFT_FRAME_SIZE	= 4096;
+const unsigned int	QPitchRegression::HOP_SIZE			= 1024;
+const double		QPitchRegression::DURATION			= 2.0;
+
+
+QPitchRegression::QPitchRegression( const QPitchCore::PitchEstimator pitchEstimator, const QPitchCore::PeakEstimation peakEstimation,
+	const double maxLoad, QObject* parent ) :
+	QObject( parent )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_pitchEstimator	= pitchEstimator;
+	_peakEstimation	= peakEstimation;
+	_maxLoad		= maxLoad;
+}
+
+
+int QPitchRegression::run( )
+{
+	static const char* const estimatorName[] = { "acf", "yin", "nsdf" };
+	const QString methodName = (_pitchEstimator != QPitchCore::ESTIMATOR_AUTOCORRELATION) ? QString( estimatorName[_pitchEstimator] ) :
+		QString( "acf-%1" ).arg( (_peakEstimation == QPitchCore::PEAK_ZERO_PADDING) ? "zero-padding" : "interpolation" );
+	const int methodIndex = (_pitchEstimator != QPitchCore::ESTIMATOR_AUTOCORRELATION) ? (int) _pitchEstimator + 1 :
+		((_peakEstimation == QPitchCore::PEAK_ZERO_PADDING) ? 0 : 1);
+	const double hopDuration = (double) HOP_SIZE / SAMPLE_FREQUENCY;
+	int failedCount = 0;
+
+	for ( int c = 0 ; c < CASE_COUNT ; ++c ) {
+		const QPitchRegressionCase& testCase = CASES[c];
+
+		// ** ANALYSE THE SYNTHETIC SIGNAL ** //
+		QBenchSoundInput* soundInput = new QBenchSoundInput( testCase.waveform, testCase.frequency, DURATION );
+		soundInput->setHarmonicCount( 8 );
+		soundInput->setNoiseLevel( testCase.noiseLevel );
+
+		QPitchCore core( soundInput );
+		core.setStrobeNote( testCase.strobeNote );
+		connect( &core, SIGNAL( updateTimedEstimate(double, double, bool) ),
+			this, SLOT( collectEstimate(double, double, bool) ), Qt::DirectConnection );
+
+		_estimates.clear( );
+		qint64			stageTime[QPitchCore::STAGE_COUNT];
+		unsigned int	estimateCount;
+		try {
+			core.analyseStream( SAMPLE_FREQUENCY, FFT_FRAME_SIZE, HOP_SIZE, _peakEstimation, _pitchEstimator, 1, testCase.lowestFrequency );
+		} catch ( QSoundInputException& e ) {
+			std::cerr << e.what( ) << "\n";
+			return CASE_COUNT;
+		}
+		core.getStageTimings( stageTime, estimateCount );
+
+		// ** COMPUTE THE ERRORS ** //
+		// an octave error is an estimate closer to a multiple or a submultiple of the frequency than to the frequency itself,
+		// a frame without a peak (estimate not finite or not positive) counts as an octave error and has no error in cents
+		QVector<double> centsError;
+		int octaveErrors = 0;
+		for ( int k = 0 ; k < _estimates.size( ) ; ++k ) {
+			if ( (! qIsFinite( _estimates[k] )) || (_estimates[k] <= 0.0) ) {
+				++octaveErrors;
+				continue;
+			}
+
+			const double cents = 1200.0 * log( _estimates[k] / testCase.frequency ) / log( 2.0 );
+			if ( fabs( cents ) > 600.0 ) {
+				++octaveErrors;
+			}
+			centsError.append( fabs( cents ) );
+		}
+
+		double medianCentsError = 0.0;
+		if ( ! centsError.isEmpty( ) ) {
+			std::sort( centsError.begin( ), centsError.end( ) );
+			medianCentsError = centsError[centsError.size( ) / 2];
+		}
+
+		double frameTime = 0.0;
+		for ( int s = 0 ; s < QPitchCore::STAGE_COUNT ; ++s ) {
+			frameTime += stageTime[s];
+		}
+		frameTime *= 1e-9 / qMax( estimateCount, 1u );
+
+		// ** CHECK THE RESULTS ** //
+		const double octaveErrorRate = (double) octaveErrors / qMax( _estimates.size( ), 1 );
+		const double load = frameTime / hopDuration;
+		const bool passed = (! _estimates.isEmpty( )) && (medianCentsError <= testCase.maxCentsError[methodIndex]) &&
+			(octaveErrorRate <= testCase.maxOctaveErrors) && ((_maxLoad <= 0.0) || (load <= _maxLoad));
+		if ( ! passed ) {
+			++failedCount;
+		}
+
+		std::cout << QString( "{\"case\":\"%1\",\"estimator\":\"%2\",\"frequency\":%3,\"estimates\":%4," )
+			.arg( testCase.name ).arg( methodName ).arg( testCase.frequency, 0, 'f', 2 ).arg( _estimates.size( ) ).toLocal8Bit( ).constData( )
+			<< QString( "\"cents\":%1,\"octaveErrors\":%2,\"frame_us\":%3,\"load\":%4,\"passed\":%5}" )
+			.arg( medianCentsError, 0, 'f', 2 ).arg( octaveErrorRate, 0, 'f', 3 ).arg( frameTime * 1e6, 0, 'f', 3 )
+			.arg( load, 0, 'f', 4 ).arg( passed ? "true" : "false" ).toLocal8Bit( ).constData( ) << std::endl;
+	}
+
+	std::cerr << QString( "QPitch: %1 of %2 regression cases passed (%3)\n" )
+		.arg( CASE_COUNT - failedCount ).arg( CASE_COUNT ).arg( methodName ).toLocal8Bit( ).constData( );
+
+	return failedCount;
+}
+
+
+void QPitchRegression::collectEstimate( double /* streamTime */, double estimatedFrequency, bool signalPresent )
+{
+	// ** STORE THE ESTIMATES OF THE SIGNAL ABOVE THE THRESHOLD ** //
+	if ( signalPresent ) {
+		_estimates.append( estimatedFrequency );
+	}
+}
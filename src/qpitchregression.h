@@ -0,0 +1,107 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPITCHREGRESSION_H_
+#define __QPITCHREGRESSION_H_
+
+#include <QObject>
+#include <QVector>
+
+#include "qpitchcore.h"
+#include "qsynthsoundinput.h"
+
+
+//! Structure describing a case of the regression suite
+struct QPitchRegressionCase {
+	const char*						name;				//!< Name of the case
+	QSynthSoundInput::Waveform		waveform;			//!< Waveform of the synthetic signal
+	double							frequency;			//!< Frequency of the fundamental (in Hz)
+	double							noiseLevel;			//!< Relative level of the noise added to the signal
+	double							maxCentsError[4];	//!< Largest accepted median of the absolute error (in cents) for each method: autocorrelation with zero-padding, autocorrelation with interpolation, YIN, NSDF
+	double							maxOctaveErrors;	//!< Largest accepted fraction of estimates one or more octaves away
+	double							lowestFrequency;	//!< Lowest frequency requested to the analysis (in Hz)
+	double							strobeNote;			//!< Note requested to the strobe (in Hz, 0 without the strobe)
+};
+
+
+//! Accuracy and speed regression suite of the pitch detection algorithm.
+/*!
+ * This class drives QPitchCore with synthetic signals (pure tones, square
+ * and sawtooth waves, harmonic-rich strings with a weak fundamental,
+ * detuned notes and noisy signals in the range [40, 2000] Hz, the notes
+ * below 40 Hz analysed at a decimated rate and the notes followed by the
+ * strobe once locked) through
+ * QPitchCore::analyseStream, and checks for each case the median error
+ * in cents, the fraction of octave errors and the mean time spent in the
+ * pitch detection algorithm for each frame, which must stay a small
+ * fraction of the time between two frames.
+ */
+
+class QPitchRegression : public QObject {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] pitchEstimator the algorithm used to estimate the pitch
+	 * \param[in] peakEstimation the method used to locate the peak of the autocorrelation
+	 * \param[in] maxLoad the largest accepted ratio between the time spent for a frame and the time between two frames (0 to only report it)
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QPitchRegression( const QPitchCore::PitchEstimator pitchEstimator, const QPitchCore::PeakEstimation peakEstimation,
+		const double maxLoad, QObject* parent = 0 );
+
+	//! Run all the cases and write one JSON line for each case.
+	/*!
+	 * \return the number of failed cases
+	 */
+	int run( );
+
+
+public slots:
+	//! Collect a new estimate of the current case.
+	/*!
+	 * \param[in] streamTime the time of the estimate measured from the start of the stream (in seconds)
+	 * \param[in] estimatedFrequency the value of the estimated frequency (0 without signal)
+	 * \param[in] signalPresent flag with the current signal presence
+	 */
+	void collectEstimate( double streamTime, double estimatedFrequency, bool signalPresent );
+
+
+private: /* static constants */
+	static const QPitchRegressionCase	CASES[];				//!< Cases of the regression suite
+	static const int					CASE_COUNT;				//!< Number of cases
+	static const unsigned int			SAMPLE_FREQUENCY;		//!< Sample rate of the synthetic signals
+	static const unsigned int			FFT_FRAME_SIZE;			//!< Size of the frame used to compute the FFT
+	static const unsigned int			HOP_SIZE;				//!< Number of new samples between two consecutive estimates
+	static const double					DURATION;				//!< Duration of the synthetic signal of each case (in seconds)
+
+
+private: /* members */
+	QPitchCore::PitchEstimator	_pitchEstimator;				//!< Algorithm used to estimate the pitch
+	QPitchCore::PeakEstimation	_peakEstimation;				//!< Method used to locate the peak of the autocorrelation
+	double						_maxLoad;						//!< Largest accepted ratio between the time of a frame and the hop duration (0 to only report it)
+	QVector<double>				_estimates;						//!< Estimated frequencies of the current case
+};
+
+#endif /* __QPITCHREGRESSION_H_ */
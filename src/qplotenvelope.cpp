@@ -0,0 +1,231 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qplotenvelope.h"
+
+/*
+ * The SIMD kernels are compiled for their own instruction set with the
+ * target attribute of GCC and Clang, as the kernels of QSampleScanner.
+ */
+#if (defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))) || defined( _M_X64 )
+#define QPITCH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))
+#define QPITCH_SIMD_AVX
+#include <immintrin.h>
+#define QPITCH_TARGET( isa )	__attribute__(( target( isa ) ))
+#else
+#define QPITCH_TARGET( isa )
+#endif
+
+
+//! Build the entries of a level left by a SIMD kernel (or the whole level).
+/*!
+ * \param[in] lowerMinimum the smallest samples of the previous level
+ * \param[in] lowerMaximum the largest samples of the previous level
+ * \param[in] span the number of samples covered by each entry of the previous level
+ * \param[in] start the index of the first entry not built yet
+ * \param[in] entryCount the number of entries of the level
+ * \param[out] minimum the smallest samples of the level
+ * \param[out] maximum the largest samples of the level
+ */
+static void doubleSpanTail( const qfftw_real* lowerMinimum, const qfftw_real* lowerMaximum, const unsigned int span,
+	const unsigned int start, const unsigned int entryCount, qfftw_real* minimum, qfftw_real* maximum )
+{
+	for ( unsigned int k = start ; k < entryCount ; ++k ) {
+		minimum[k] = qMin( lowerMinimum[k], lowerMinimum[k + span] );
+		maximum[k] = qMax( lowerMaximum[k], lowerMaximum[k + span] );
+	}
+}
+
+
+//! Build a level of the sparse table one entry at a time.
+static void doubleSpanScalar( const qfftw_real* lowerMinimum, const qfftw_real* lowerMaximum, const unsigned int span,
+	const unsigned int entryCount, qfftw_real* minimum, qfftw_real* maximum )
+{
+	doubleSpanTail( lowerMinimum, lowerMaximum, span, 0, entryCount, minimum, maximum );
+}
+
+
+#ifdef QPITCH_SIMD_SSE2
+//! Build a level of the sparse table 16 bytes at a time with SSE2.
+QPITCH_TARGET( "sse2" )
+static void doubleSpanSse2( const qfftw_real* lowerMinimum, const qfftw_real* lowerMaximum, const unsigned int span,
+	const unsigned int entryCount, qfftw_real* minimum, qfftw_real* maximum )
+{
+	unsigned int k = 0;
+#ifdef QPITCH_FFTW_FLOAT
+	for (  ; k + 4 <= entryCount ; k += 4 ) {
+		_mm_storeu_ps( minimum + k, _mm_min_ps( _mm_loadu_ps( lowerMinimum + k ), _mm_loadu_ps( lowerMinimum + k + span ) ) );
+		_mm_storeu_ps( maximum + k, _mm_max_ps( _mm_loadu_ps( lowerMaximum + k ), _mm_loadu_ps( lowerMaximum + k + span ) ) );
+	}
+#else
+	for (  ; k + 2 <= entryCount ; k += 2 ) {
+		_mm_storeu_pd( minimum + k, _mm_min_pd( _mm_loadu_pd( lowerMinimum + k ), _mm_loadu_pd( lowerMinimum + k + span ) ) );
+		_mm_storeu_pd( maximum + k, _mm_max_pd( _mm_loadu_pd( lowerMaximum + k ), _mm_loadu_pd( lowerMaximum + k + span ) ) );
+	}
+#endif
+
+	doubleSpanTail( lowerMinimum, lowerMaximum, span, k, entryCount, minimum, maximum );
+}
+#endif
+
+
+#ifdef QPITCH_SIMD_AVX
+//! Build a level of the sparse table 32 bytes at a time with AVX.
+QPITCH_TARGET( "avx" )
+static void doubleSpanAvx( const qfftw_real* lowerMinimum, const qfftw_real* lowerMaximum, const unsigned int span,
+	const unsigned int entryCount, qfftw_real* minimum, qfftw_real* maximum )
+{
+	unsigned int k = 0;
+#ifdef QPITCH_FFTW_FLOAT
+	for (  ; k + 8 <= entryCount ; k += 8 ) {
+		_mm256_storeu_ps( minimum + k, _mm256_min_ps( _mm256_loadu_ps( lowerMinimum + k ), _mm256_loadu_ps( lowerMinimum + k + span ) ) );
+		_mm256_storeu_ps( maximum + k, _mm256_max_ps( _mm256_loadu_ps( lowerMaximum + k ), _mm256_loadu_ps( lowerMaximum + k + span ) ) );
+	}
+#else
+	for (  ; k + 4 <= entryCount ; k += 4 ) {
+		_mm256_storeu_pd( minimum + k, _mm256_min_pd( _mm256_loadu_pd( lowerMinimum + k ), _mm256_loadu_pd( lowerMinimum + k + span ) ) );
+		_mm256_storeu_pd( maximum + k, _mm256_max_pd( _mm256_loadu_pd( lowerMaximum + k ), _mm256_loadu_pd( lowerMaximum + k + span ) ) );
+	}
+#endif
+
+	doubleSpanTail( lowerMinimum, lowerMaximum, span, k, entryCount, minimum, maximum );
+}
+#endif
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const QPlotEnvelope::Kernel QPlotEnvelope::KERNEL = QPlotEnvelope::selectKernel( );
+
+
+QPlotEnvelope::QPlotEnvelope( const unsigned int maxSampleCount )
+{
+	// ** ENSURE THAT THE SIZE IS VALID ** //
+	Q_ASSERT( maxSampleCount > 0 );
+
+	// ** ALLOCATE THE LEVELS OF THE SPARSE TABLE ** //
+	// (the samples themselves are the level of a single sample, so they are not copied)
+	_maxSampleCount	= maxSampleCount;
+	_levelCount		= 0;
+	for ( unsigned int span = 2 ; span <= _maxSampleCount ; span *= 2 ) {
+		++_levelCount;
+	}
+
+	_levelMinimum	= new qfftw_real*[qMax( _levelCount, 1u )];
+	_levelMaximum	= new qfftw_real*[qMax( _levelCount, 1u )];
+	for ( unsigned int j = 0 ; j < _levelCount ; ++j ) {
+		_levelMinimum[j] = new qfftw_real[_maxSampleCount];
+		_levelMaximum[j] = new qfftw_real[_maxSampleCount];
+	}
+}
+
+
+QPlotEnvelope::~QPlotEnvelope( )
+{
+	// ** RELEASE RESOURCES ** //
+	for ( unsigned int j = 0 ; j < _levelCount ; ++j ) {
+		delete[]	_levelMinimum[j];
+		delete[]	_levelMaximum[j];
+	}
+	delete[]	_levelMinimum;
+	delete[]	_levelMaximum;
+}
+
+
+void QPlotEnvelope::reduce( const qfftw_real* input, const unsigned int sampleCount, const unsigned int columnCount,
+	qfftw_real* minimum, qfftw_real* maximum )
+{
+	// ** ENSURE THAT THE PARAMETERS ARE VALID ** //
+	Q_ASSERT( input != NULL );
+	Q_ASSERT( (sampleCount > 0) && (sampleCount <= _maxSampleCount) );
+	Q_ASSERT( columnCount > 0 );
+
+	// ** BUILD THE LEVELS REQUIRED BY THE WIDEST COLUMN ** //
+	// (its own samples and the first one of the next column)
+	const unsigned int maxWidth = qMin( (sampleCount + columnCount - 1) / columnCount + 1, sampleCount );
+
+	unsigned int levels = 0;
+	for ( unsigned int span = 1 ; 2 * span <= maxWidth ; span *= 2 ) {
+		Q_ASSERT( levels < _levelCount );
+		const qfftw_real* lowerMinimum = (levels == 0) ? input : _levelMinimum[levels - 1];
+		const qfftw_real* lowerMaximum = (levels == 0) ? input : _levelMaximum[levels - 1];
+
+		// the entries spanning 2 * span samples end before the last sample
+		KERNEL.doubleSpan( lowerMinimum, lowerMaximum, span, sampleCount - 2 * span + 1, _levelMinimum[levels], _levelMaximum[levels] );
+		++levels;
+	}
+
+	// ** LOOK UP THE RANGE OF EACH COLUMN ** //
+	// two overlapping entries of the largest span that fits the column cover all of its samples
+	for ( unsigned int c = 0 ; c < columnCount ; ++c ) {
+		const unsigned int columnStart	= (unsigned int) ( (quint64) c * sampleCount / columnCount );
+		const unsigned int columnEnd	= qMin( (unsigned int) ( (quint64) (c + 1) * sampleCount / columnCount ) + 1, sampleCount );
+
+		unsigned int level = 0;
+		while ( (2u << level) <= columnEnd - columnStart ) {
+			++level;
+		}
+		const unsigned int lastEntry = columnEnd - (1u << level);
+
+		if ( level == 0 ) {
+			minimum[c] = qMin( input[columnStart], input[lastEntry] );
+			maximum[c] = qMax( input[columnStart], input[lastEntry] );
+		} else {
+			minimum[c] = qMin( _levelMinimum[level - 1][columnStart], _levelMinimum[level - 1][lastEntry] );
+			maximum[c] = qMax( _levelMaximum[level - 1][columnStart], _levelMaximum[level - 1][lastEntry] );
+		}
+	}
+}
+
+
+const char* QPlotEnvelope::instructionSet( )
+{
+	return KERNEL.instructionSet;
+}
+
+
+QPlotEnvelope::Kernel QPlotEnvelope::selectKernel( )
+{
+	// ** QUERY THE PROCESSOR (THE FEATURES ARE NOT INITIALIZED YET WHILE LOADING THE PROGRAM) ** //
+#if defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))
+	__builtin_cpu_init( );
+#ifdef QPITCH_SIMD_AVX
+	if ( __builtin_cpu_supports( "avx" ) ) {
+		Kernel kernel = { doubleSpanAvx, "avx" };
+		return kernel;
+	}
+#endif
+	if ( __builtin_cpu_supports( "sse2" ) ) {
+		Kernel kernel = { doubleSpanSse2, "sse2" };
+		return kernel;
+	}
+#elif defined( QPITCH_SIMD_SSE2 )
+	Kernel kernel = { doubleSpanSse2, "sse2" };
+	return kernel;
+#endif
+
+	Kernel kernel = { doubleSpanScalar, "scalar" };
+	return kernel;
+}
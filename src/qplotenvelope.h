@@ -0,0 +1,109 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QPLOTENVELOPE_H_
+#define __QPLOTENVELOPE_H_
+
+#include <QtGlobal>
+
+#include "qfftw.h"
+
+
+//! Reduction of a curve to the envelope displayed by each pixel column.
+/*!
+ * The oscilloscope view spans a few thousands of samples with a few
+ * hundreds of pixels: taking one sample every few ones aliases the
+ * high frequencies of the signal, while the range of the samples of
+ * each column is the exact picture of the curve at any width of the
+ * widget. Each column covers its own samples and the first one of the
+ * next column, so that the ranges of two neighbouring columns always
+ * overlap and the envelope is drawn as a connected shape.
+ * The columns are only a few samples wide, so the ranges are taken
+ * from a sparse table: level j holds the range of the 2^j samples
+ * starting from each sample, and it is built from level j-1 with a
+ * single pass of SIMD kernels selected at run time (AVX, SSE2, or a
+ * scalar fallback on the other architectures and compilers). The range
+ * of any column is then found with two lookups in the table.
+ */
+
+class QPlotEnvelope {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] maxSampleCount the largest number of samples reduced at once
+	 */
+	QPlotEnvelope( const unsigned int maxSampleCount );
+
+	//! Default destructor.
+	~QPlotEnvelope( );
+
+	//! Reduce a curve to the range of the samples of each column.
+	/*!
+	 * \param[in] input the array with the samples of the curve
+	 * \param[in] sampleCount the number of samples (at least 1 and at most maxSampleCount)
+	 * \param[in] columnCount the number of columns of the envelope (at least 1)
+	 * \param[out] minimum the array receiving the smallest sample of each column
+	 * \param[out] maximum the array receiving the largest sample of each column
+	 */
+	void reduce( const qfftw_real* input, const unsigned int sampleCount, const unsigned int columnCount,
+		qfftw_real* minimum, qfftw_real* maximum );
+
+	//! Retrieve the name of the instruction set of the kernel selected for this processor.
+	static const char* instructionSet( );
+
+
+private: /* types */
+	//! Kernel building a level of the sparse table from the previous one.
+	typedef void (*DoubleFunction)( const qfftw_real* lowerMinimum, const qfftw_real* lowerMaximum, const unsigned int span,
+		const unsigned int sampleCount, qfftw_real* minimum, qfftw_real* maximum );
+
+	//! Kernel selected for the processor.
+	struct Kernel {
+		DoubleFunction	doubleSpan;								//!< Function building a level of the sparse table
+		const char*		instructionSet;							//!< Name of the instruction set of the function
+	};
+
+
+private: /* static constants */
+	static const Kernel	KERNEL;									//!< Kernel selected for this processor when the program is loaded
+
+
+private: /* members */
+	unsigned int		_maxSampleCount;						//!< Largest number of samples reduced at once
+	unsigned int		_levelCount;							//!< Number of levels of the sparse table above the samples
+	qfftw_real**		_levelMinimum;							//!< Smallest sample of the 2^(j+1) samples starting from each sample, for each level j
+	qfftw_real**		_levelMaximum;							//!< Largest sample of the 2^(j+1) samples starting from each sample, for each level j
+
+
+private: /* methods */
+	//! Select the fastest kernel supported by the processor.
+	static Kernel selectKernel( );
+
+	//! Disabled copy constructor.
+	QPlotEnvelope( const QPlotEnvelope& );
+
+	//! Disabled assignment operator.
+	QPlotEnvelope& operator=( const QPlotEnvelope& );
+};
+
+#endif /* __QPLOTENVELOPE_H_ */
@@ -0,0 +1,93 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qrawsoundinput.h"
+
+#include <cstdio>
+
+#include <QtEndian>
+
+
+QRawSoundInput::QRawSoundInput( QObject* parent ) : QStreamSoundInput( parent )
+{
+	// ** DELIVER THE SAMPLES AT THE PACE OF THE WRITER ** //
+	setRealTime( false );
+}
+
+
+QRawSoundInput::~QRawSoundInput( )
+{
+	// ** ENSURE THAT THE STANDARD INPUT IS RELEASED ** //
+	Q_ASSERT( ! _file.isOpen( ) );
+}
+
+
+QString QRawSoundInput::description( ) const
+{
+	if ( _channelCount == 1 ) {
+		return QString( "Standard input: raw PCM, 16 bit, mono" );
+	}
+	return QString( "Standard input: raw PCM, 16 bit, %1 channels" ).arg( _channelCount );
+}
+
+
+unsigned int QRawSoundInput::openSource( const unsigned int sampleFrequency )
+{
+	// ** OPEN THE STANDARD INPUT (IT IS NOT CLOSED BY QFILE) ** //
+	if ( ! _file.open( stdin, QIODevice::ReadOnly | QIODevice::Unbuffered ) ) {
+		throw QSoundInputException( QString( "Cannot read the standard input: %1" ).arg( _file.errorString( ) ).toLocal8Bit( ).constData( ) );
+	}
+
+	return sampleFrequency;
+}
+
+
+void QRawSoundInput::closeSource( )
+{
+	_file.close( );
+}
+
+
+unsigned int QRawSoundInput::readSource( short int* buffer, const unsigned int frameCount )
+{
+	// ** READ WHOLE FRAMES ** //
+	// a pipe may return a partial read, so keep reading till the buffer is full or the pipe is closed
+	char* data = (char*) buffer;
+	qint64 size = frameCount * _channelCount * sizeof( short int );
+	qint64 readSize = 0;
+	while ( readSize < size ) {
+		qint64 count = _file.read( data + readSize, size - readSize );
+		if ( count <= 0 ) {
+			break;
+		}
+		readSize += count;
+	}
+
+	// ** CONVERT FROM LITTLE ENDIAN ** //
+	// (a truncated frame at the end of the stream is dropped)
+	const unsigned int readFrames = (unsigned int)( readSize / (_channelCount * sizeof( short int )) );
+	for ( unsigned int k = 0 ; k < readFrames * _channelCount ; ++k ) {
+		buffer[k] = qFromLittleEndian<qint16>( (const uchar*) &buffer[k] );
+	}
+
+	return readFrames;
+}
@@ -0,0 +1,85 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QRAWSOUNDINPUT_H_
+#define __QRAWSOUNDINPUT_H_
+
+#include "qstreamsoundinput.h"
+
+#include <QFile>
+
+
+//! Sound input read as raw PCM samples from the standard input.
+/*!
+ * This class reads the audio stream from the standard input as raw mono
+ * 16 bit little endian samples (e.g. "arecord -f S16_LE -c 1" or "sox
+ * ... -t raw -e signed -b 16 -c 1 -"), at the requested sample rate.
+ * When several channels are requested the samples are read as
+ * interleaved frames with that number of channels (e.g. "-c 4").
+ * The stream is terminated when the standard input is closed. Since the
+ * pace is usually given by the writer, the samples are delivered as fast
+ * as the receiver can store them unless setRealTime is called.
+ */
+
+class QRawSoundInput : public QStreamSoundInput {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QRawSoundInput( QObject* parent = 0 );
+
+	//! Default destructor.
+	~QRawSoundInput( );
+
+	//! Retrieve the description of the source.
+	virtual QString description( ) const;
+
+
+protected: /* methods */
+	//! Open the standard input.
+	/*!
+	 * \param[in] sampleFrequency the sample rate of the samples written to the standard input
+	 * \return the requested sample rate
+	 */
+	virtual unsigned int openSource( const unsigned int sampleFrequency );
+
+	//! Release the standard input.
+	virtual void closeSource( );
+
+	//! Read the next samples from the standard input.
+	/*!
+	 * \param[out] buffer the array used to store the samples
+	 * \param[in] frameCount the size of the array
+	 * \return the number of samples read (0 when the standard input is closed)
+	 */
+	virtual unsigned int readSource( short int* buffer, const unsigned int frameCount );
+
+
+private: /* members */
+	QFile				_file;									//!< The standard input
+};
+
+#endif /* __QRAWSOUNDINPUT_H_ */
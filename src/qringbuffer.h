@@ -0,0 +1,272 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QRINGBUFFER_H_
+#define __QRINGBUFFER_H_
+
+#include <cstring>
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+
+
+//! Wait-free single-producer/single-consumer ring buffer.
+/*!
+ * This class implements a ring buffer used to transfer samples from the
+ * audio callback (the only producer) to the working thread (the only
+ * consumer) without locks, so that the callback never blocks.
+ * The capacity is rounded up to the next power of two and the read and
+ * write indices are free running counters, thus the number of stored
+ * elements is always given by their difference (modulo 2^32).
+ * Each index is written only by its owner and published with release
+ * semantic, while the other side reads it with acquire semantic.
+ * The consumer may also access the stored elements in place with peek,
+ * releasing them with skip once they are processed, to avoid a copy.
+ */
+
+template <typename T>
+class QRingBuffer {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] capacity the minimum number of elements that the buffer can store
+	 */
+	QRingBuffer( const unsigned int capacity );
+
+	//! Default destructor.
+	~QRingBuffer( );
+
+	//! Store new elements in the buffer (producer side).
+	/*!
+	 * \param[in] data the array with the elements to store
+	 * \param[in] count the number of elements in the array
+	 * \return the number of elements actually stored (less than count when the buffer is full)
+	 */
+	unsigned int write( const T* data, const unsigned int count );
+
+	//! Store new elements taken from an interleaved array (producer side).
+	/*!
+	 * \param[in] data the pointer to the first element to store
+	 * \param[in] count the number of elements to store
+	 * \param[in] stride the distance between two consecutive elements in the array
+	 * \return the number of elements actually stored (less than count when the buffer is full)
+	 */
+	unsigned int write( const T* data, const unsigned int count, const unsigned int stride );
+
+	//! Extract the oldest elements from the buffer (consumer side).
+	/*!
+	 * \param[out] data the array where the elements are copied
+	 * \param[in] count the maximum number of elements to extract
+	 * \return the number of elements actually extracted
+	 */
+	unsigned int read( T* data, const unsigned int count );
+
+	//! Access the oldest elements in place, without extracting them (consumer side).
+	/*!
+	 * The elements stay in the buffer, so the producer cannot overwrite
+	 * them, until they are released with skip.
+	 * \param[out] first the pointer to the oldest element
+	 * \param[out] firstCount the number of contiguous elements starting at first
+	 * \param[out] second the pointer to the elements following the wrap around (the start of the storage)
+	 * \param[in] count the maximum number of elements to access
+	 * \return the number of elements accessed (the elements after firstCount start at second)
+	 */
+	unsigned int peek( const T*& first, unsigned int& firstCount, const T*& second, const unsigned int count ) const;
+
+	//! Release the oldest elements accessed with peek (consumer side).
+	/*!
+	 * \param[in] count the number of elements to release (at most the number of elements accessed)
+	 */
+	void skip( const unsigned int count );
+
+	//! Number of elements that can be extracted (consumer side).
+	unsigned int readAvailable( ) const;
+
+	//! Number of elements that can be stored (producer side).
+	unsigned int writeAvailable( ) const;
+
+	//! Capacity of the buffer.
+	unsigned int capacity( ) const;
+
+
+private: /* members */
+	T*							_buffer;					//!< Storage of the elements
+	unsigned int				_capacity;					//!< Size of the storage (a power of two)
+	unsigned int				_mask;						//!< Mask used to wrap the indices into the storage
+	QAtomicInteger<unsigned int>	_writeIndex;			//!< Total number of elements written (owned by the producer)
+	QAtomicInteger<unsigned int>	_readIndex;				//!< Total number of elements read (owned by the consumer)
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QRingBuffer( const QRingBuffer& );
+
+	//! Disabled assignment operator.
+	QRingBuffer& operator=( const QRingBuffer& );
+};
+
+
+template <typename T>
+QRingBuffer<T>::QRingBuffer( const unsigned int capacity ) : _writeIndex( 0 ), _readIndex( 0 )
+{
+	// ** ROUND THE CAPACITY TO THE NEXT POWER OF TWO ** //
+	_capacity = 1;
+	while ( _capacity < capacity ) {
+		_capacity <<= 1;
+	}
+	_mask	= _capacity - 1;
+	_buffer	= new T[_capacity];
+}
+
+
+template <typename T>
+QRingBuffer<T>::~QRingBuffer( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[] _buffer;
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::write( const T* data, const unsigned int count )
+{
+	const unsigned int writeIndex	= _writeIndex.loadRelaxed( );
+	const unsigned int readIndex	= _readIndex.loadAcquire( );
+
+	// ** STORE AS MANY ELEMENTS AS POSSIBLE ** //
+	const unsigned int n		= qMin( count, _capacity - (writeIndex - readIndex) );
+	const unsigned int offset	= writeIndex & _mask;
+	const unsigned int n1		= qMin( n, _capacity - offset );
+
+	// copy the data in (at most) two chunks to handle the wrap around
+	memcpy( _buffer + offset, data, n1 * sizeof( T ) );
+	memcpy( _buffer, data + n1, (n - n1) * sizeof( T ) );
+
+	// publish the new elements to the consumer
+	_writeIndex.storeRelease( writeIndex + n );
+	return n;
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::write( const T* data, const unsigned int count, const unsigned int stride )
+{
+	// ** USE THE PLAIN COPY FOR CONTIGUOUS ELEMENTS ** //
+	if ( stride == 1 ) {
+		return write( data, count );
+	}
+
+	const unsigned int writeIndex	= _writeIndex.loadRelaxed( );
+	const unsigned int readIndex	= _readIndex.loadAcquire( );
+
+	// ** STORE AS MANY ELEMENTS AS POSSIBLE ** //
+	const unsigned int n		= qMin( count, _capacity - (writeIndex - readIndex) );
+	const unsigned int offset	= writeIndex & _mask;
+	const unsigned int n1		= qMin( n, _capacity - offset );
+
+	// gather the data in (at most) two chunks to handle the wrap around
+	for ( unsigned int k = 0 ; k < n1 ; ++k ) {
+		_buffer[offset + k] = data[k * stride];
+	}
+	for ( unsigned int k = n1 ; k < n ; ++k ) {
+		_buffer[k - n1] = data[k * stride];
+	}
+
+	// publish the new elements to the consumer
+	_writeIndex.storeRelease( writeIndex + n );
+	return n;
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::read( T* data, const unsigned int count )
+{
+	const unsigned int readIndex	= _readIndex.loadRelaxed( );
+	const unsigned int writeIndex	= _writeIndex.loadAcquire( );
+
+	// ** EXTRACT AS MANY ELEMENTS AS AVAILABLE ** //
+	const unsigned int n		= qMin( count, writeIndex - readIndex );
+	const unsigned int offset	= readIndex & _mask;
+	const unsigned int n1		= qMin( n, _capacity - offset );
+
+	// copy the data in (at most) two chunks to handle the wrap around
+	memcpy( data, _buffer + offset, n1 * sizeof( T ) );
+	memcpy( data + n1, _buffer, (n - n1) * sizeof( T ) );
+
+	// release the space to the producer
+	_readIndex.storeRelease( readIndex + n );
+	return n;
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::peek( const T*& first, unsigned int& firstCount, const T*& second, const unsigned int count ) const
+{
+	const unsigned int readIndex	= _readIndex.loadRelaxed( );
+	const unsigned int writeIndex	= _writeIndex.loadAcquire( );
+
+	// ** ACCESS AS MANY ELEMENTS AS AVAILABLE ** //
+	const unsigned int n		= qMin( count, writeIndex - readIndex );
+	const unsigned int offset	= readIndex & _mask;
+
+	// the elements are split in (at most) two chunks by the wrap around
+	first		= _buffer + offset;
+	firstCount	= qMin( n, _capacity - offset );
+	second		= _buffer;
+	return n;
+}
+
+
+template <typename T>
+void QRingBuffer<T>::skip( const unsigned int count )
+{
+	const unsigned int readIndex = _readIndex.loadRelaxed( );
+
+	// ** ENSURE THAT THE ELEMENTS ARE STORED ** //
+	Q_ASSERT( count <= _writeIndex.loadAcquire( ) - readIndex );
+
+	// release the space to the producer
+	_readIndex.storeRelease( readIndex + count );
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::readAvailable( ) const
+{
+	return ( _writeIndex.loadAcquire( ) - _readIndex.loadRelaxed( ) );
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::writeAvailable( ) const
+{
+	return ( _capacity - (_writeIndex.loadRelaxed( ) - _readIndex.loadAcquire( )) );
+}
+
+
+template <typename T>
+unsigned int QRingBuffer<T>::capacity( ) const
+{
+	return _capacity;
+}
+
+#endif /* __QRINGBUFFER_H_ */
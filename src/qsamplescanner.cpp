@@ -0,0 +1,308 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qsamplescanner.h"
+
+/*
+ * The SIMD kernels are compiled for their own instruction set with the
+ * target attribute of GCC and Clang, so that the rest of the program
+ * keeps the baseline of the build and the kernel is chosen at run time.
+ * Other compilers get the SSE2 kernel on x86-64, where it is the
+ * baseline, and the scalar kernel elsewhere.
+ */
+#if (defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))) || defined( _M_X64 )
+#define QPITCH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))
+#define QPITCH_SIMD_AVX2
+#include <immintrin.h>
+#define QPITCH_TARGET( isa )	__attribute__(( target( isa ) ))
+#else
+#define QPITCH_TARGET( isa )
+#endif
+
+
+//! Scan the samples left by a SIMD kernel (or the whole block), then store the level of the block.
+/*!
+ * \param[in] input the array with the input samples
+ * \param[in] start the index of the first sample not converted yet
+ * \param[in] triggerStart the index of the first sample not searched for a rising edge yet
+ * \param[in] sampleCount the number of input samples
+ * \param[out] output the array receiving the converted samples
+ * \param[in] maxValue the largest sample before start
+ * \param[in] minValue the smallest sample before start
+ * \param[in] energy the sum of the squared samples before start
+ * \param[in] trigger the index of the rising edge found before triggerStart (sampleCount if none)
+ * \param[out] level the level and the trigger of the block
+ */
+static void scanTail( const short int* input, const unsigned int start, const unsigned int triggerStart, const unsigned int sampleCount,
+	qfftw_real* output, int maxValue, int minValue, quint64 energy, unsigned int trigger, QSampleScanner::BlockLevel& level )
+{
+	for ( unsigned int k = start ; k < sampleCount ; ++k ) {
+		const int x	= input[k];
+		maxValue	= qMax( maxValue, x );
+		minValue	= qMin( minValue, x );
+		energy		+= x * x;
+		output[k]	= x;
+	}
+
+	for ( unsigned int k = triggerStart ; (trigger == sampleCount) && (k + 1 < sampleCount) ; ++k ) {
+		if ( (input[k] < 0) && (input[k+1] >= 0) ) {
+			trigger = k;
+		}
+	}
+
+	// the sliding window starts from the last sample when the block has no rising edge
+	level.peak		= qMax( maxValue, - minValue );
+	level.energy	= energy;
+	level.trigger	= (trigger < sampleCount) ? trigger : sampleCount - 1;
+}
+
+
+//! Scan a block of samples one sample at a time.
+static void scanScalar( const short int* input, const unsigned int sampleCount, qfftw_real* output, QSampleScanner::BlockLevel& level )
+{
+	scanTail( input, 0, 0, sampleCount, output, 0, 0, 0, sampleCount, level );
+}
+
+
+//! Retrieve the index of the first sample flagged by the byte mask of a comparison of 16 bit samples.
+static unsigned int firstFlaggedSample( unsigned int mask )
+{
+	unsigned int k = 0;
+	for (  ; (mask & 0x3) == 0 ; mask >>= 2 ) {
+		++k;
+	}
+	return k;
+}
+
+
+#ifdef QPITCH_SIMD_SSE2
+//! Scan a block of samples 8 samples at a time with SSE2.
+QPITCH_TARGET( "sse2" )
+static void scanSse2( const short int* input, const unsigned int sampleCount, qfftw_real* output, QSampleScanner::BlockLevel& level )
+{
+	const __m128i zero = _mm_setzero_si128( );
+	__m128i maxValue	= zero;
+	__m128i minValue	= zero;
+	__m128i energy		= zero;
+	unsigned int trigger		= sampleCount;
+	unsigned int triggerStart	= 0;
+
+	unsigned int k = 0;
+	for (  ; k + 8 <= sampleCount ; k += 8 ) {
+		const __m128i x = _mm_loadu_si128( (const __m128i*) (input + k) );
+
+		// ** LEVEL ** //
+		// a pair of squares fits an unsigned 32 bit integer, which is widened before the accumulation
+		maxValue	= _mm_max_epi16( maxValue, x );
+		minValue	= _mm_min_epi16( minValue, x );
+		const __m128i squares = _mm_madd_epi16( x, x );
+		energy		= _mm_add_epi64( energy, _mm_unpacklo_epi32( squares, zero ) );
+		energy		= _mm_add_epi64( energy, _mm_unpackhi_epi32( squares, zero ) );
+
+		// ** RISING EDGE ** //
+		// (each sample is compared with the next one, so the last vector is left to the tail)
+		if ( (trigger == sampleCount) && (k + 8 < sampleCount) ) {
+			const __m128i next = _mm_loadu_si128( (const __m128i*) (input + k + 1) );
+			const unsigned int mask = _mm_movemask_epi8( _mm_andnot_si128( _mm_cmplt_epi16( next, zero ), _mm_cmplt_epi16( x, zero ) ) );
+			if ( mask != 0 ) {
+				trigger = k + firstFlaggedSample( mask );
+			}
+			triggerStart = k + 8;
+		}
+
+		// ** CONVERSION ** //
+		// the sign is extended shifting the samples to the upper half of 32 bit integers
+		const __m128i low	= _mm_srai_epi32( _mm_unpacklo_epi16( x, x ), 16 );
+		const __m128i high	= _mm_srai_epi32( _mm_unpackhi_epi16( x, x ), 16 );
+#ifdef QPITCH_FFTW_FLOAT
+		_mm_storeu_ps( output + k,		_mm_cvtepi32_ps( low ) );
+		_mm_storeu_ps( output + k + 4,	_mm_cvtepi32_ps( high ) );
+#else
+		_mm_storeu_pd( output + k,		_mm_cvtepi32_pd( low ) );
+		_mm_storeu_pd( output + k + 2,	_mm_cvtepi32_pd( _mm_unpackhi_epi64( low, low ) ) );
+		_mm_storeu_pd( output + k + 4,	_mm_cvtepi32_pd( high ) );
+		_mm_storeu_pd( output + k + 6,	_mm_cvtepi32_pd( _mm_unpackhi_epi64( high, high ) ) );
+#endif
+	}
+
+	// ** REDUCE THE LANES ** //
+	short int	maxLanes[8];
+	short int	minLanes[8];
+	quint64		energyLanes[2];
+	_mm_storeu_si128( (__m128i*) maxLanes, maxValue );
+	_mm_storeu_si128( (__m128i*) minLanes, minValue );
+	_mm_storeu_si128( (__m128i*) energyLanes, energy );
+
+	int maxSample = 0;
+	int minSample = 0;
+	for ( int l = 0 ; l < 8 ; ++l ) {
+		maxSample = qMax( maxSample, (int) maxLanes[l] );
+		minSample = qMin( minSample, (int) minLanes[l] );
+	}
+
+	scanTail( input, k, triggerStart, sampleCount, output, maxSample, minSample, energyLanes[0] + energyLanes[1], trigger, level );
+}
+#endif
+
+
+#ifdef QPITCH_SIMD_AVX2
+//! Scan a block of samples 16 samples at a time with AVX2.
+QPITCH_TARGET( "avx2" )
+static void scanAvx2( const short int* input, const unsigned int sampleCount, qfftw_real* output, QSampleScanner::BlockLevel& level )
+{
+	const __m256i zero = _mm256_setzero_si256( );
+	__m256i maxValue	= zero;
+	__m256i minValue	= zero;
+	__m256i energy		= zero;
+	unsigned int trigger		= sampleCount;
+	unsigned int triggerStart	= 0;
+
+	unsigned int k = 0;
+	for (  ; k + 16 <= sampleCount ; k += 16 ) {
+		const __m256i x = _mm256_loadu_si256( (const __m256i*) (input + k) );
+
+		// ** LEVEL ** //
+		// a pair of squares fits an unsigned 32 bit integer, which is widened before the accumulation
+		maxValue	= _mm256_max_epi16( maxValue, x );
+		minValue	= _mm256_min_epi16( minValue, x );
+		const __m256i squares = _mm256_madd_epi16( x, x );
+		energy		= _mm256_add_epi64( energy, _mm256_unpacklo_epi32( squares, zero ) );
+		energy		= _mm256_add_epi64( energy, _mm256_unpackhi_epi32( squares, zero ) );
+
+		// ** RISING EDGE ** //
+		// (each sample is compared with the next one, so the last vector is left to the tail)
+		if ( (trigger == sampleCount) && (k + 16 < sampleCount) ) {
+			const __m256i next = _mm256_loadu_si256( (const __m256i*) (input + k + 1) );
+			const unsigned int mask = _mm256_movemask_epi8( _mm256_andnot_si256( _mm256_cmpgt_epi16( zero, next ), _mm256_cmpgt_epi16( zero, x ) ) );
+			if ( mask != 0 ) {
+				trigger = k + firstFlaggedSample( mask );
+			}
+			triggerStart = k + 16;
+		}
+
+		// ** CONVERSION ** //
+		const __m256i low	= _mm256_cvtepi16_epi32( _mm256_castsi256_si128( x ) );
+		const __m256i high	= _mm256_cvtepi16_epi32( _mm256_extracti128_si256( x, 1 ) );
+#ifdef QPITCH_FFTW_FLOAT
+		_mm256_storeu_ps( output + k,		_mm256_cvtepi32_ps( low ) );
+		_mm256_storeu_ps( output + k + 8,	_mm256_cvtepi32_ps( high ) );
+#else
+		_mm256_storeu_pd( output + k,		_mm256_cvtepi32_pd( _mm256_castsi256_si128( low ) ) );
+		_mm256_storeu_pd( output + k + 4,	_mm256_cvtepi32_pd( _mm256_extracti128_si256( low, 1 ) ) );
+		_mm256_storeu_pd( output + k + 8,	_mm256_cvtepi32_pd( _mm256_castsi256_si128( high ) ) );
+		_mm256_storeu_pd( output + k + 12,	_mm256_cvtepi32_pd( _mm256_extracti128_si256( high, 1 ) ) );
+#endif
+	}
+
+	// ** REDUCE THE LANES ** //
+	short int	maxLanes[16];
+	short int	minLanes[16];
+	quint64		energyLanes[4];
+	_mm256_storeu_si256( (__m256i*) maxLanes, maxValue );
+	_mm256_storeu_si256( (__m256i*) minLanes, minValue );
+	_mm256_storeu_si256( (__m256i*) energyLanes, energy );
+
+	int maxSample = 0;
+	int minSample = 0;
+	for ( int l = 0 ; l < 16 ; ++l ) {
+		maxSample = qMax( maxSample, (int) maxLanes[l] );
+		minSample = qMin( minSample, (int) minLanes[l] );
+	}
+
+	scanTail( input, k, triggerStart, sampleCount, output, maxSample, minSample,
+		energyLanes[0] + energyLanes[1] + energyLanes[2] + energyLanes[3], trigger, level );
+}
+#endif
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const QSampleScanner::Kernel QSampleScanner::KERNEL = QSampleScanner::selectKernel( );
+
+
+void QSampleScanner::scan( const short int* input, const unsigned int sampleCount, qfftw_real* output, BlockLevel& level )
+{
+	// ** ENSURE THAT THE BLOCK IS NOT EMPTY ** //
+	Q_ASSERT( sampleCount > 0 );
+
+	KERNEL.scan( input, sampleCount, output, level );
+}
+
+
+void QSampleScanner::scan( const short int* first, const unsigned int firstCount, const short int* second, const unsigned int secondCount,
+	qfftw_real* output, BlockLevel& level )
+{
+	// ** SCAN A CONTIGUOUS BLOCK AT ONCE ** //
+	if ( secondCount == 0 ) {
+		scan( first, firstCount, output, level );
+		return;
+	} else if ( firstCount == 0 ) {
+		scan( second, secondCount, output, level );
+		return;
+	}
+
+	BlockLevel secondLevel;
+	KERNEL.scan( first, firstCount, output, level );
+	KERNEL.scan( second, secondCount, output + firstCount, secondLevel );
+
+	// ** MERGE THE LEVELS OF THE TWO CHUNKS ** //
+	// a rising edge is never found on the last sample of a chunk, so it means that the first chunk has none but across the split
+	if ( (level.trigger == firstCount - 1) && ( (first[firstCount - 1] >= 0) || (second[0] < 0) ) ) {
+		level.trigger = firstCount + secondLevel.trigger;
+	}
+	level.peak		= qMax( level.peak, secondLevel.peak );
+	level.energy	+= secondLevel.energy;
+}
+
+
+const char* QSampleScanner::instructionSet( )
+{
+	return KERNEL.instructionSet;
+}
+
+
+QSampleScanner::Kernel QSampleScanner::selectKernel( )
+{
+	// ** QUERY THE PROCESSOR (THE FEATURES ARE NOT INITIALIZED YET WHILE LOADING THE PROGRAM) ** //
+#if defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __i386__ ))
+	__builtin_cpu_init( );
+#ifdef QPITCH_SIMD_AVX2
+	if ( __builtin_cpu_supports( "avx2" ) ) {
+		Kernel kernel = { scanAvx2, "avx2" };
+		return kernel;
+	}
+#endif
+	if ( __builtin_cpu_supports( "sse2" ) ) {
+		Kernel kernel = { scanSse2, "sse2" };
+		return kernel;
+	}
+#elif defined( QPITCH_SIMD_SSE2 )
+	Kernel kernel = { scanSse2, "sse2" };
+	return kernel;
+#endif
+
+	Kernel kernel = { scanScalar, "scalar" };
+	return kernel;
+}
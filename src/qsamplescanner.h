@@ -0,0 +1,102 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSAMPLESCANNER_H_
+#define __QSAMPLESCANNER_H_
+
+#include <QtGlobal>
+
+#include "qfftw.h"
+
+
+//! Vectorized first pass over the samples extracted from a ring buffer.
+/*!
+ * Each block of input samples must be converted to the type of the
+ * analysis, measured against the thresholds of the signal gate and
+ * searched for the first rising edge across zero, which starts the
+ * sliding window after a silence. The scanner does all of them in a
+ * single pass over the block, with SIMD kernels selected at run time
+ * (AVX2, SSE2, or a scalar fallback on the other architectures and
+ * compilers), so that the branches of the gate are taken once for each
+ * block instead of once for each sample.
+ * The level of the block (its peak and its energy) is exact, thus the
+ * kernels are interchangeable bit for bit.
+ */
+
+class QSampleScanner {
+
+public: /* structures */
+	//! Level and trigger of a block of samples.
+	struct BlockLevel {
+		int				peak;									//!< Largest absolute value of the samples (32768 at most)
+		double			energy;									//!< Sum of the squared samples
+		unsigned int	trigger;								//!< Index of the first negative sample followed by a non-negative one (the last sample if none)
+	};
+
+
+public: /* methods */
+	//! Convert a block of samples, measuring its level and searching its first rising edge.
+	/*!
+	 * \param[in] input the array with the input samples
+	 * \param[in] sampleCount the number of input samples (at least 1)
+	 * \param[out] output the array receiving the converted samples
+	 * \param[out] level the level and the trigger of the block
+	 */
+	static void scan( const short int* input, const unsigned int sampleCount, qfftw_real* output, BlockLevel& level );
+
+	//! Convert a block of samples split in two chunks (e.g. by the wrap around of a ring buffer) to a contiguous array.
+	/*!
+	 * \param[in] first the array with the first input samples
+	 * \param[in] firstCount the number of samples in the first array
+	 * \param[in] second the array with the input samples following the first ones
+	 * \param[in] secondCount the number of samples in the second array
+	 * \param[out] output the array receiving all the converted samples
+	 * \param[out] level the level and the trigger of the whole block, as if it was contiguous
+	 */
+	static void scan( const short int* first, const unsigned int firstCount, const short int* second, const unsigned int secondCount,
+		qfftw_real* output, BlockLevel& level );
+
+	//! Retrieve the name of the instruction set of the kernel selected for this processor.
+	static const char* instructionSet( );
+
+
+private: /* types */
+	//! Kernel scanning a block of samples.
+	typedef void (*ScanFunction)( const short int* input, const unsigned int sampleCount, qfftw_real* output, BlockLevel& level );
+
+	//! Kernel selected for the processor.
+	struct Kernel {
+		ScanFunction	scan;									//!< Function scanning a block of samples
+		const char*		instructionSet;							//!< Name of the instruction set of the function
+	};
+
+
+private: /* static constants */
+	static const Kernel	KERNEL;									//!< Kernel selected for this processor when the program is loaded
+
+
+private: /* methods */
+	//! Select the fastest kernel supported by the processor.
+	static Kernel selectKernel( );
+};
+
+#endif /* __QSAMPLESCANNER_H_ */
@@ -37,19 +37,24 @@ QSettingsDlg::QSettingsDlg( const QPitchParameters& qPitchParameters, QWidget* p
 	// ** INITIALIZE WIDGETS ** //
 	_sd.comboBox_sampleFrequency->setCurrentIndex( _sd.comboBox_sampleFrequency->findText( QString::number( qPitchParameters.sampleFrequency ) ) );
 	_sd.comboBox_frameSize->setCurrentIndex( _sd.comboBox_frameSize->findText( QString::number( qPitchParameters.fftFrameSize ) ) );
+	_sd.comboBox_hopSize->setCurrentIndex( _sd.comboBox_hopSize->findText( QString::number( qPitchParameters.hopSize ) ) );
+	_sd.comboBox_peakEstimation->setCurrentIndex( qPitchParameters.peakEstimation );
+	_sd.comboBox_pitchEstimator->setCurrentIndex( qPitchParameters.pitchEstimator );
+	_sd.spinBox_channelCount->setValue( qPitchParameters.channelCount );
+	_sd.doubleSpinBox_lowestFrequency->setValue( qPitchParameters.lowestFrequency );
 	_sd.doubleSpinBox_fundamentalFrequency->setValue( qPitchParameters.fundamentalFrequency );
 
 	switch( qPitchParameters.tuningNotation ) {
 		default:
-		case QLogView::NOTATION_US:
+		case QTuningScale::NOTATION_US:
 			_sd.radioButton_scaleUs->setChecked( true );
 			break;
 
-		case QLogView::NOTATION_FRENCH:
+		case QTuningScale::NOTATION_FRENCH:
 			_sd.radioButton_scaleFrench->setChecked( true );
 			break;
 
-		case QLogView::NOTATION_GERMAN:
+		case QTuningScale::NOTATION_GERMAN:
 			_sd.radioButton_scaleGerman->setChecked( true );
 			break;
 
@@ -60,17 +65,19 @@ QSettingsDlg::QSettingsDlg( const QPitchParameters& qPitchParameters, QWidget* p
 void QSettingsDlg::acceptSettings( )
 {
 	// ** UPDATE THE APPLICATION SETTINGS ** //
-	QLogView::TuningNotation tuningNotation = QLogView::NOTATION_US;
+	QTuningScale::TuningNotation tuningNotation = QTuningScale::NOTATION_US;
 
 	if ( _sd.radioButton_scaleUs->isChecked( ) ) {
-		tuningNotation = QLogView::NOTATION_US;
+		tuningNotation = QTuningScale::NOTATION_US;
 	} else if ( _sd.radioButton_scaleFrench->isChecked( ) ) {
-		tuningNotation = QLogView::NOTATION_FRENCH;
+		tuningNotation = QTuningScale::NOTATION_FRENCH;
 	} else if ( _sd.radioButton_scaleGerman->isChecked( ) ) {
-		tuningNotation = QLogView::NOTATION_GERMAN;
+		tuningNotation = QTuningScale::NOTATION_GERMAN;
 	}
 
 	emit updateApplicationSettings( _sd.comboBox_sampleFrequency->currentText( ).toUInt( ), _sd.comboBox_frameSize->currentText( ).toUInt( ),
+		_sd.comboBox_hopSize->currentText( ).toUInt( ), _sd.comboBox_peakEstimation->currentIndex( ),
+		_sd.comboBox_pitchEstimator->currentIndex( ), _sd.spinBox_channelCount->value( ), _sd.doubleSpinBox_lowestFrequency->value( ),
 		_sd.doubleSpinBox_fundamentalFrequency->value( ), (const unsigned int) tuningNotation );
 }
 
@@ -80,6 +87,11 @@ void QSettingsDlg::restoreDefaultSettings( )
 	// ** RESTORE THE PROPERTIES OF THE AUDIO STREAM TO THE INITIAL VALUE ** //
 	_sd.comboBox_sampleFrequency->setCurrentIndex( 0 );				// 44100 Hz
 	_sd.comboBox_frameSize->setCurrentIndex( 1 );					// 4096 samples
+	_sd.comboBox_hopSize->setCurrentIndex( 2 );						// 1024 samples
+	_sd.comboBox_peakEstimation->setCurrentIndex( QPitchCore::PEAK_INTERPOLATION );
+	_sd.comboBox_pitchEstimator->setCurrentIndex( QPitchCore::ESTIMATOR_AUTOCORRELATION );
+	_sd.spinBox_channelCount->setValue( 1 );						// mono input
+	_sd.doubleSpinBox_lowestFrequency->setValue( QTuningScale::MIN_FREQUENCY );	// 40 Hz, analysed at the full rate
 	_sd.doubleSpinBox_fundamentalFrequency->setValue( 440.0 );		// A4 = 440 Hz for standard pitch
 	_sd.radioButton_scaleUs->setChecked( true );					// US notation
 }
@@ -25,15 +25,21 @@
 
 #include "ui_qsettingsdlg.h"
 
-#include "qlogview.h"
+#include "qtuningscale.h"
+#include "qpitchcore.h"
 
 
 //! Structure holding the application settings
 struct QPitchParameters {
 	unsigned int				sampleFrequency;		//!< Current sample rate
 	unsigned int				fftFrameSize;			//!< Current size of the buffer used to compute the FFT
+	unsigned int				hopSize;				//!< Current number of new samples between two consecutive estimates
+	QPitchCore::PeakEstimation	peakEstimation;			//!< Current method used to locate the peak of the autocorrelation
+	QPitchCore::PitchEstimator	pitchEstimator;			//!< Current algorithm used to estimate the pitch
+	unsigned int				channelCount;			//!< Current number of input channels analysed
+	double						lowestFrequency;		//!< Current lowest frequency identified as a note
 	double						fundamentalFrequency;	//!< The reference frequency of A4 used to estimate the pitch
-	QLogView::TuningNotation	tuningNotation;			//!< Current tuning notation
+	QTuningScale::TuningNotation	tuningNotation;			//!< Current tuning notation
 };
 
 
@@ -43,8 +49,11 @@ struct QPitchParameters {
  * the audio stream and the parameters of the pitch detection
  * algorithm.
  * The configuration of the audio stream includes the selection
- * of the sample frequency and of the size of the frame used to
- * compute the FFT.
+ * of the sample frequency, of the size of the frame used to
+ * compute the FFT and of the hop size between two estimates, the
+ * method used to locate the peak of the autocorrelation, the
+ * pitch detection algorithm, the number of input channels and
+ * the lowest frequency identified as a note.
  * The configuration of the pitch detection algorithm includes
  * the selection of the fundamental frequency (A4 = 440Hz as the
  * default) used to build the note scale and the selection of the
@@ -77,10 +86,16 @@ signals:
 	/*!
 	 * \param[in] sampleFrequency requested sample frequency
 	 * \param[in] fftFrameSize requested size of the buffer used to compute the FFT
+	 * \param[in] hopSize requested number of new samples between two consecutive estimates
+	 * \param[in] peakEstimation requested method used to locate the peak of the autocorrelation
+	 * \param[in] pitchEstimator requested algorithm used to estimate the pitch
+	 * \param[in] channelCount requested number of input channels
+	 * \param[in] lowestFrequency requested lowest frequency identified as a note
 	 * \param[in] fundamentalFrequency requested fundamental frequency of the note A4
 	 * \param[in] tuningNotation requested tuning notation
 	 */
-	void updateApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize,
+	void updateApplicationSettings( unsigned int sampleFrequency, unsigned int fftFrameSize, unsigned int hopSize,
+		unsigned int peakEstimation, unsigned int pitchEstimator, unsigned int channelCount, double lowestFrequency,
 		double fundamentalFrequency, unsigned int tuningNotation );
 
 
@@ -0,0 +1,143 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSOUNDINPUT_H_
+#define __QSOUNDINPUT_H_
+
+#include <stdexcept>
+
+#include <QString>
+
+
+//! An exception thrown when a sound input cannot be opened or controlled.
+class QSoundInputException : public std::runtime_error {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] msg the error message to display
+	 */
+	QSoundInputException( const std::string& msg ) : std::runtime_error( msg ) {
+		return;
+	};
+};
+
+
+//! Function called by a sound input to deliver a new buffer of samples.
+/*!
+ * The function may be called from a real-time thread (e.g. the PortAudio
+ * callback), thus it must never block. The samples that are not stored
+ * are lost if the sound input is a real-time one, otherwise the sound
+ * input delivers them again later.
+ * \param[in] input the array with the 16 bit samples, interleaved when the stream has several channels
+ * \param[in] frameCount the number of frames in the array (one sample for each channel)
+ * \param[in] userData the pointer given when the stream has been opened
+ * \return the number of frames actually stored by the receiver
+ */
+typedef unsigned int (*QSoundInputCallback)( const short int* input, unsigned int frameCount, void* userData );
+
+
+//! Source of the audio stream analysed by QPitchCore.
+/*!
+ * This class defines the interface of the sources of the audio stream,
+ * so that the working thread does not depend on the way the samples are
+ * acquired. The samples are always delivered as 16 bit integers, in
+ * buffers of framesPerBuffer frames (the last one may be shorter),
+ * through the callback given when the stream is opened. A frame holds
+ * one sample for each channel of the stream, and the number of channels
+ * is requested when the stream is opened (a source may impose its own,
+ * e.g. a mono synthesizer).
+ * The stream is opened and started by the working thread, which also
+ * takes the ownership of the source.
+ */
+
+class QSoundInput {
+
+public: /* methods */
+	//! Default constructor.
+	QSoundInput( ) : _sampleFrequency( 0 ), _channelCount( 1 ), _framesPerBuffer( 0 ), _callback( NULL ), _userData( NULL ) {
+		return;
+	};
+
+	//! Default destructor.
+	virtual ~QSoundInput( ) {
+		return;
+	};
+
+	//! Open the audio stream.
+	/*!
+	 * \param[in] sampleFrequency the requested sample rate (a source may impose its own rate)
+	 * \param[in] channelCount the requested number of channels (a source may impose its own number)
+	 * \param[in] callback the function called to deliver the samples
+	 * \param[in] userData the pointer passed to the callback
+	 */
+	virtual void openStream( const unsigned int sampleFrequency, const unsigned int channelCount, QSoundInputCallback callback,
+		void* userData ) = 0;
+
+	//! Close the audio stream (it must be stopped).
+	virtual void closeStream( ) = 0;
+
+	//! Start the delivery of the samples.
+	virtual void startStream( ) = 0;
+
+	//! Stop the delivery of the samples (the callback is not called anymore after the return).
+	virtual void stopStream( ) = 0;
+
+	//! Retrieve a description of the source.
+	/*!
+	 * \return a string with the name of the source to display
+	 */
+	virtual QString description( ) const = 0;
+
+	//! Check if the samples are acquired in real-time.
+	/*!
+	 * \return true if the samples that are not stored by the callback are lost (default true)
+	 */
+	virtual bool isRealTime( ) const { return true; };
+
+	//! Retrieve the actual sample rate of the opened stream.
+	unsigned int sampleFrequency( ) const { return _sampleFrequency; };
+
+	//! Retrieve the actual number of channels of the opened stream.
+	unsigned int channelCount( ) const { return _channelCount; };
+
+	//! Retrieve the number of frames delivered with each call of the callback.
+	unsigned int framesPerBuffer( ) const { return _framesPerBuffer; };
+
+
+protected: /* members */
+	unsigned int		_sampleFrequency;						//!< Actual sample rate of the stream
+	unsigned int		_channelCount;							//!< Number of interleaved channels of the stream
+	unsigned int		_framesPerBuffer;						//!< Number of frames delivered with each call of the callback
+	QSoundInputCallback	_callback;								//!< Function called to deliver the samples
+	void*				_userData;								//!< Pointer passed to the callback
+
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QSoundInput( const QSoundInput& );
+
+	//! Disabled assignment operator.
+	QSoundInput& operator=( const QSoundInput& );
+};
+
+#endif /* __QSOUNDINPUT_H_ */
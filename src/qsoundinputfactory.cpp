@@ -0,0 +1,72 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qsoundinputfactory.h"
+#include "qrawsoundinput.h"
+#include "qsynthsoundinput.h"
+#include "qwavsoundinput.h"
+
+#include <QCommandLineParser>
+#include <QStringList>
+
+
+void QSoundInputFactory::addOptions( QCommandLineParser& parser )
+{
+	// ** SOURCES ** //
+	parser.addOption( QCommandLineOption( "wav", "Read the audio stream from a WAV <file>.", "file" ) );
+	parser.addOption( QCommandLineOption( "loop", "Restart the WAV file when its end is reached." ) );
+	parser.addOption( QCommandLineOption( "stdin", "Read raw mono 16 bit little endian samples from the standard input." ) );
+	parser.addOption( QCommandLineOption( "synth", "Generate a <waveform>: sine, square, harmonics, noise, sawtooth or string.", "waveform" ) );
+	parser.addOption( QCommandLineOption( "synth-frequency", "Frequency of the generated waveform (default 440 Hz).", "Hz", "440" ) );
+	parser.addOption( QCommandLineOption( "synth-noise", "Relative level of the noise added to the generated waveform (default 0).", "level", "0" ) );
+
+	// ** PACE OF THE DELIVERY ** //
+	parser.addOption( QCommandLineOption( "fast", "Deliver the samples of the WAV file or of the synthesizer as fast as they are analysed." ) );
+}
+
+
+QSoundInput* QSoundInputFactory::create( const QCommandLineParser& parser )
+{
+	// ** CREATE THE SOUND INPUT (NULL TO USE PORTAUDIO) ** //
+	QStreamSoundInput* soundInput = NULL;
+	if ( parser.isSet( "wav" ) ) {
+		soundInput = new QWavSoundInput( parser.value( "wav" ), parser.isSet( "loop" ) );
+	} else if ( parser.isSet( "stdin" ) ) {
+		soundInput = new QRawSoundInput( );
+	} else if ( parser.isSet( "synth" ) ) {
+		const QStringList waveformName = QStringList( ) << "sine" << "square" << "harmonics" << "noise" << "sawtooth" << "string";
+		const int waveform = waveformName.indexOf( parser.value( "synth" ) );
+		if ( waveform < 0 ) {
+			throw QSoundInputException( QString( "Unknown waveform: %1" ).arg( parser.value( "synth" ) ).toLocal8Bit( ).constData( ) );
+		}
+		QSynthSoundInput* synth = new QSynthSoundInput( (QSynthSoundInput::Waveform) waveform, parser.value( "synth-frequency" ).toDouble( ) );
+		synth->setNoiseLevel( parser.value( "synth-noise" ).toDouble( ) );
+		soundInput = synth;
+	}
+
+	// the standard input is already delivered as fast as possible, since its writer sets the pace
+	if ( (soundInput != NULL) && parser.isSet( "fast" ) ) {
+		soundInput->setRealTime( false );
+	}
+
+	return soundInput;
+}
@@ -0,0 +1,56 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSOUNDINPUTFACTORY_H_
+#define __QSOUNDINPUTFACTORY_H_
+
+#include "qsoundinput.h"
+
+class QCommandLineParser;
+
+
+//! Creation of the sound inputs selected on the command line.
+/*!
+ * This class collects the command line options shared by the
+ * applications to replace the sound card with a WAV file, the standard
+ * input or a synthesizer, and creates the corresponding sound input.
+ */
+
+class QSoundInputFactory {
+
+public: /* methods */
+	//! Add the options used to select the sound input.
+	/*!
+	 * \param[in,out] parser the parser of the command line
+	 */
+	static void addOptions( QCommandLineParser& parser );
+
+	//! Create the sound input selected by the options.
+	/*!
+	 * \param[in] parser the parser that has processed the command line
+	 * \return the sound input, or NULL if no option has been given (to use PortAudio)
+	 * \throw QSoundInputException if the options are not valid or the source cannot be opened
+	 */
+	static QSoundInput* create( const QCommandLineParser& parser );
+};
+
+#endif /* __QSOUNDINPUTFACTORY_H_ */
@@ -0,0 +1,183 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qstreamsoundinput.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const double QStreamSoundInput::PERIOD_DURATION	= 0.05;
+
+
+QStreamSoundInput::QStreamSoundInput( QObject* parent ) : QThread( parent ), QSoundInput( )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_realTime	= true;
+	_running	= false;
+	_mutex		= new QMutex( );
+	_waitCond	= new QWaitCondition( );
+}
+
+
+QStreamSoundInput::~QStreamSoundInput( )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( _running == false );
+	Q_ASSERT( ! this->isRunning( ) );
+
+	// ** RELEASE RESOURCES ** //
+	delete _mutex;
+	delete _waitCond;
+}
+
+
+void QStreamSoundInput::setRealTime( const bool realTime )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( ! this->isRunning( ) );
+
+	_realTime = realTime;
+}
+
+
+void QStreamSoundInput::openStream( const unsigned int sampleFrequency, const unsigned int channelCount, QSoundInputCallback callback,
+	void* userData )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( callback != NULL );
+	Q_ASSERT( channelCount > 0 );
+	Q_ASSERT( ! this->isRunning( ) );
+
+	// ** OPEN THE SOURCE ** //
+	_channelCount		= channelCount;
+	_sampleFrequency	= openSource( sampleFrequency );
+	_framesPerBuffer	= (unsigned int)( PERIOD_DURATION * _sampleFrequency );
+	_callback			= callback;
+	_userData			= userData;
+}
+
+
+void QStreamSoundInput::closeStream( )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( ! this->isRunning( ) );
+
+	// ** CLOSE THE SOURCE ** //
+	closeSource( );
+}
+
+
+void QStreamSoundInput::startStream( )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( _callback != NULL );
+	Q_ASSERT( ! this->isRunning( ) );
+
+	// ** START THE THREAD ** //
+	_running = true;
+	this->start( );
+}
+
+
+void QStreamSoundInput::stopStream( )
+{
+	// ** STOP THE THREAD ** //
+	_mutex->lock( );
+	_running = false;
+	_waitCond->wakeOne( );
+	_mutex->unlock( );
+
+	// ** WAIT FOR THE THREAD TO FINISH ** //
+	// a source blocked in a read (e.g. an idle standard input) is stopped only after the read returns
+	this->wait( );
+}
+
+
+unsigned int QStreamSoundInput::readStream( short int* buffer, const unsigned int frameCount )
+{
+	// ** ENSURE THAT THE THREAD IS NOT RUNNING ** //
+	Q_ASSERT( buffer != NULL );
+	Q_ASSERT( ! this->isRunning( ) );
+
+	return readSource( buffer, frameCount );
+}
+
+
+void QStreamSoundInput::run( )
+{
+	short int*		buffer				= new short int[_framesPerBuffer * _channelCount];
+	quint64			deliveredSamples	= 0;
+	bool			running				= true;
+	QElapsedTimer	timer;
+	timer.start( );
+
+	while ( running ) {
+		// ** READ THE NEXT BUFFER ** //
+		unsigned int frameCount = readSource( buffer, _framesPerBuffer );
+		if ( frameCount == 0 ) {
+			// end of the source
+			break;
+		}
+
+		if ( _realTime ) {
+			// ** WAIT TILL A SOUND CARD WOULD HAVE ACQUIRED THE BUFFER ** //
+			const qint64 deliveryTime = (qint64)( (deliveredSamples + frameCount) * 1000 / _sampleFrequency );
+			_mutex->lock( );
+			while ( _running && (timer.elapsed( ) < deliveryTime) ) {
+				_waitCond->wait( _mutex, (unsigned long)( deliveryTime - timer.elapsed( ) ) );
+			}
+			running = _running;
+			_mutex->unlock( );
+
+			// the samples that do not fit in the receiver are lost as with a sound card
+			if ( running ) {
+				_callback( buffer, frameCount, _userData );
+			}
+		} else {
+			// ** DELIVER THE WHOLE BUFFER WAITING FOR THE RECEIVER ** //
+			unsigned int storedSamples = _callback( buffer, frameCount, _userData );
+			while ( running && (storedSamples < frameCount) ) {
+				_mutex->lock( );
+				if ( _running ) {
+					_waitCond->wait( _mutex, 1 );
+				}
+				running = _running;
+				_mutex->unlock( );
+
+				if ( running ) {
+					storedSamples += _callback( buffer + storedSamples * _channelCount, frameCount - storedSamples, _userData );
+				}
+			}
+
+			_mutex->lock( );
+			running = _running;
+			_mutex->unlock( );
+		}
+
+		deliveredSamples += frameCount;
+	}
+
+	delete[] buffer;
+}
@@ -0,0 +1,141 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSTREAMSOUNDINPUT_H_
+#define __QSTREAMSOUNDINPUT_H_
+
+#include "qsoundinput.h"
+
+#include <QThread>
+
+class QMutex;
+class QWaitCondition;
+
+
+//! Base class of the sound inputs that do not require a sound card.
+/*!
+ * This class delivers the samples read from a generic source (a file,
+ * the standard input or a generator) from its own thread, so that the
+ * working thread receives them exactly as from the PortAudio callback.
+ * In real-time mode the buffers are delivered at the pace of the sample
+ * rate and the samples that cannot be stored by the receiver are lost,
+ * as with a sound card; otherwise the buffers are delivered as fast as
+ * the receiver can store them, which is useful to analyse a recording or
+ * to benchmark the analysis.
+ * The thread terminates (emitting QThread::finished) at the end of the
+ * source.
+ */
+
+class QStreamSoundInput : public QThread, public QSoundInput {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QStreamSoundInput( QObject* parent = 0 );
+
+	//! Default destructor.
+	virtual ~QStreamSoundInput( );
+
+	//! Select the pace of the delivery (it must be set before the stream is started).
+	/*!
+	 * \param[in] realTime true to deliver the samples at the pace of the sample rate, false to deliver them as fast as possible
+	 */
+	void setRealTime( const bool realTime );
+
+	//! Retrieve the pace of the delivery.
+	/*!
+	 * \return true if the samples are delivered at the pace of the sample rate and the samples not stored are lost
+	 */
+	virtual bool isRealTime( ) const { return _realTime; };
+
+	//! Open the source.
+	/*!
+	 * \param[in] sampleFrequency the requested sample rate (a source may impose its own rate)
+	 * \param[in] channelCount the requested number of channels (a source may impose its own number)
+	 * \param[in] callback the function called to deliver the samples
+	 * \param[in] userData the pointer passed to the callback
+	 */
+	virtual void openStream( const unsigned int sampleFrequency, const unsigned int channelCount, QSoundInputCallback callback,
+		void* userData );
+
+	//! Close the source.
+	virtual void closeStream( );
+
+	//! Start the thread that delivers the samples.
+	virtual void startStream( );
+
+	//! Stop the thread that delivers the samples.
+	virtual void stopStream( );
+
+	//! Read the next samples in the calling thread.
+	/*!
+	 * The samples are pulled from an open stream that has not been started,
+	 * so that a receiver can analyse a source as fast as it is able to
+	 * process the samples, without the thread that delivers them.
+	 * \param[out] buffer the array used to store the interleaved 16 bit samples
+	 * \param[in] frameCount the number of frames that fit in the array
+	 * \return the number of frames read (0 at the end of the source)
+	 */
+	unsigned int readStream( short int* buffer, const unsigned int frameCount );
+
+
+protected: /* methods */
+	//! Main loop of the thread.
+	virtual void run( );
+
+	//! Open the source of the samples.
+	/*!
+	 * The requested number of channels is stored in _channelCount, which
+	 * is changed by the sources that impose their own number.
+	 * \param[in] sampleFrequency the requested sample rate
+	 * \return the actual sample rate of the source
+	 */
+	virtual unsigned int openSource( const unsigned int sampleFrequency ) = 0;
+
+	//! Close the source of the samples.
+	virtual void closeSource( ) = 0;
+
+	//! Read the next samples from the source.
+	/*!
+	 * \param[out] buffer the array used to store the interleaved 16 bit samples
+	 * \param[in] frameCount the number of frames that fit in the array
+	 * \return the number of frames read (0 at the end of the source)
+	 */
+	virtual unsigned int readSource( short int* buffer, const unsigned int frameCount ) = 0;
+
+
+private: /* static constants */
+	static const double	PERIOD_DURATION;						//!< Duration of the buffers delivered to the receiver (in seconds)
+
+
+private: /* members */
+	bool				_realTime;								//!< True when the samples are delivered at the pace of the sample rate
+	bool				_running;								//!< True when the thread is running
+	QMutex*				_mutex;									//!< Mutex used by the wait condition
+	QWaitCondition*		_waitCond;								//!< Wait condition used to sleep between two buffers
+};
+
+#endif /* __QSTREAMSOUNDINPUT_H_ */
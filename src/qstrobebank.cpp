@@ -0,0 +1,231 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qstrobebank.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const unsigned int QStrobeBank::MAX_PARTIALS		= 8;
+const double QStrobeBank::MAX_PARTIAL_RATIO			= 0.45;
+const double QStrobeBank::BLOCK_PERIODS				= 4.0;
+const unsigned int QStrobeBank::MIN_BLOCK_SIZE		= 16;
+const double QStrobeBank::MIN_PARTIAL_POWER			= 0.25;
+const double QStrobeBank::MAX_DEVIATION				= 1.0 / 24.0;
+
+
+QStrobeBank::QStrobeBank( const double sampleFrequency )
+{
+	// ** ENSURE THAT THE PARAMETERS ARE VALID ** //
+	Q_ASSERT( sampleFrequency > 0.0 );
+
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	// the blocks are allocated by the first lock, since their size depends on the note
+	_sampleFrequency	= sampleFrequency;
+	_noteFrequency		= 0.0;
+	_block				= NULL;
+	_windowedBlock		= NULL;
+	_window				= NULL;
+	_windowSum			= 0.0;
+	_windowPower		= 0.0;
+	_block_size			= 0;
+	_hopSize			= 0;
+	reset( );
+}
+
+
+QStrobeBank::~QStrobeBank( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete[] _block;
+	delete[] _windowedBlock;
+	delete[] _window;
+}
+
+
+bool QStrobeBank::setNoteFrequency( const double noteFrequency )
+{
+	// ** ENSURE THAT THE PARAMETERS ARE VALID ** //
+	Q_ASSERT( noteFrequency > 0.0 );
+
+	// ** KEEP THE PARTIALS BELOW THE NYQUIST FREQUENCY ** //
+	const unsigned int partialCount = qMin( MAX_PARTIALS, (unsigned int) (MAX_PARTIAL_RATIO * _sampleFrequency / noteFrequency) );
+	if ( partialCount == 0 ) {
+		return false;
+	}
+
+	_noteFrequency = noteFrequency;
+	_partials.resize( partialCount );
+	for ( unsigned int p = 0 ; p < partialCount ; ++p ) {
+		// the oscillator rotates clockwise to bring the partial down to DC
+		_partials[p].omega			= 2.0 * M_PI * (p + 1) * _noteFrequency / _sampleFrequency;
+		_partials[p].rotation_re	= cos( _partials[p].omega );
+		_partials[p].rotation_im	= - sin( _partials[p].omega );
+	}
+
+	// ** SIZE THE BLOCKS ON THE PERIOD OF THE NOTE ** //
+	// (an even size, so that two blocks overlap by exactly a half)
+	const unsigned int blockSize = 2 * ((qMax( (unsigned int) qRound( BLOCK_PERIODS * _sampleFrequency / _noteFrequency ), MIN_BLOCK_SIZE ) + 1) / 2);
+	if ( blockSize != _block_size ) {
+		delete[] _block;
+		delete[] _windowedBlock;
+		delete[] _window;
+
+		_block_size		= blockSize;
+		_hopSize		= _block_size / 2;
+		_block			= new double[_block_size];
+		_windowedBlock	= new double[_block_size];
+		_window			= new double[_block_size];
+
+		_windowSum		= 0.0;
+		_windowPower	= 0.0;
+		for ( unsigned int n = 0 ; n < _block_size ; ++n ) {
+			_window[n]		= 0.5 - 0.5 * cos( 2.0 * M_PI * n / _block_size );
+			_windowSum		+= _window[n];
+			_windowPower	+= _window[n] * _window[n];
+		}
+	}
+
+	reset( );
+	return true;
+}
+
+
+void QStrobeBank::reset( )
+{
+	// ** THE PHASES OF THE PREVIOUS BLOCKS ARE UNRELATED TO THE NEXT ONES ** //
+	for ( int p = 0 ; p < _partials.size( ) ; ++p ) {
+		_partials[p].oscillatorPhase	= 0.0;
+		_partials[p].lastPhase			= 0.0;
+	}
+	_block_index		= 0;
+	_blockCount			= 0;
+
+	_offsetSum			= 0.0;
+	_weightSum			= 0.0;
+	_partialPowerSum	= 0.0;
+	_signalPowerSum		= 0.0;
+	_estimatedFrequency	= 0.0;
+	_locked				= true;
+	_phase				= 0.0;
+}
+
+
+void QStrobeBank::process( const qfftw_real* input, const unsigned int sampleCount )
+{
+	// ** ENSURE THAT THE BANK IS LOCKED TO A NOTE ** //
+	Q_ASSERT( _block_size > 0 );
+
+	unsigned int k = 0;
+	while ( k < sampleCount ) {
+		// fill the block, processing it every half block
+		for (  ; (k < sampleCount) && (_block_index < _block_size) ; ++k ) {
+			_block[_block_index++] = input[k];
+		}
+
+		if ( _block_index == _block_size ) {
+			processBlock( );
+			memmove( _block, _block + _hopSize, (_block_size - _hopSize) * sizeof( double ) );
+			_block_index = _block_size - _hopSize;
+		}
+	}
+}
+
+
+double QStrobeBank::estimate( )
+{
+	// ** AVERAGE THE OFFSETS OF THE BLOCKS COMPLETED SINCE THE LAST ESTIMATE ** //
+	if ( _weightSum > 0.0 ) {
+		_estimatedFrequency	= _noteFrequency + _offsetSum / _weightSum;
+		_locked				= (_partialPowerSum >= MIN_PARTIAL_POWER * _signalPowerSum) &&
+			(fabs( log2( _estimatedFrequency / _noteFrequency ) ) <= MAX_DEVIATION);
+
+		_offsetSum			= 0.0;
+		_weightSum			= 0.0;
+		_partialPowerSum	= 0.0;
+		_signalPowerSum		= 0.0;
+	}
+
+	return _estimatedFrequency;
+}
+
+
+void QStrobeBank::processBlock( )
+{
+	// ** APPLY THE WINDOW ** //
+	double signalPower = 0.0;
+	for ( unsigned int n = 0 ; n < _block_size ; ++n ) {
+		_windowedBlock[n]	= _window[n] * _block[n];
+		signalPower			+= _windowedBlock[n] * _windowedBlock[n];
+	}
+	signalPower /= _windowPower;
+
+	// ** DEMODULATE EACH PARTIAL ** //
+	double partialPower	= 0.0;
+	double offsetSum	= 0.0;
+	for ( int p = 0 ; p < _partials.size( ) ; ++p ) {
+		Partial& partial = _partials[p];
+
+		// the oscillator is referred to the start of the lock, so that the phase of a steady partial does not move
+		double oscillator_re	= cos( partial.oscillatorPhase );
+		double oscillator_im	= - sin( partial.oscillatorPhase );
+		double z_re				= 0.0;
+		double z_im				= 0.0;
+		for ( unsigned int n = 0 ; n < _block_size ; ++n ) {
+			z_re += _windowedBlock[n] * oscillator_re;
+			z_im += _windowedBlock[n] * oscillator_im;
+
+			const double rotated_re	= oscillator_re * partial.rotation_re - oscillator_im * partial.rotation_im;
+			oscillator_im			= oscillator_re * partial.rotation_im + oscillator_im * partial.rotation_re;
+			oscillator_re			= rotated_re;
+		}
+
+		// the amplitude of the partial is 2 |z| / sum(w), and its power half the squared amplitude
+		const double power = 2.0 * (z_re * z_re + z_im * z_im) / (_windowSum * _windowSum);
+		const double phase = atan2( z_im, z_re );
+		if ( _blockCount > 0 ) {
+			// the drift in half a block is the offset of the partial, divided by its order to refer it to the note
+			const double drift = remainder( phase - partial.lastPhase, 2.0 * M_PI );
+			offsetSum += power * drift * _sampleFrequency / (2.0 * M_PI * _hopSize * (p + 1));
+		}
+		partialPower			+= power;
+		partial.lastPhase		= phase;
+		partial.oscillatorPhase	= fmod( partial.oscillatorPhase + partial.omega * _hopSize, 2.0 * M_PI );
+	}
+
+	// ** ACCUMULATE THE OFFSET OF THE NOTE ** //
+	if ( (_blockCount > 0) && (partialPower > 0.0) ) {
+		_offsetSum	+= offsetSum;
+		_weightSum	+= partialPower;
+
+		// the strobe turns by the offset of the note times the duration of half a block
+		_phase		+= offsetSum / partialPower * _hopSize / _sampleFrequency;
+		_phase		-= floor( _phase );
+	}
+	_partialPowerSum	+= partialPower;
+	_signalPowerSum		+= signalPower;
+	++_blockCount;
+}
@@ -0,0 +1,161 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSTROBEBANK_H_
+#define __QSTROBEBANK_H_
+
+#include <QVector>
+
+#include "qfftw.h"
+
+
+//! Strobe tuner following the phase of the partials of a locked note.
+/*!
+ * Once the note is known, the pitch does not need to be searched anymore:
+ * it only has to be measured against the note, which is what a strobe
+ * tuner does. The bank demodulates the signal with a complex oscillator
+ * at the frequency of the note and of each of its partials (up to
+ * MAX_PARTIALS, below the Nyquist frequency), over Hann-windowed blocks
+ * spanning BLOCK_PERIODS periods of the note, overlapped by a half.
+ * The phase of each partial drifts between two blocks by the offset of
+ * its frequency from the oscillator, which gives the deviation of the
+ * note without any peak search, to a fraction of a cent. The offsets of
+ * the partials are divided by their order and averaged with the power
+ * of the partials as weights, so that a weak fundamental (e.g. the low
+ * strings of a piano) does not degrade the estimate.
+ * The half block between two blocks is two periods of the note, thus the
+ * drift of the highest partial is unambiguous up to half a semitone from
+ * the note, beyond which the note is considered lost, as well as when
+ * the partials carry less than MIN_PARTIAL_POWER of the signal.
+ * The cost is two multiply-accumulates for each partial and each sample,
+ * whatever the length of the frame of the pitch estimators.
+ */
+
+class QStrobeBank {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] sampleFrequency the sample rate of the analysed samples
+	 */
+	QStrobeBank( const double sampleFrequency );
+
+	//! Default destructor.
+	~QStrobeBank( );
+
+	//! Lock the bank to a note, restarting the tracking of the phases.
+	/*!
+	 * \param[in] noteFrequency the frequency of the note
+	 * \return false if the note is above the range of the analysis (the bank is left unchanged)
+	 */
+	bool setNoteFrequency( const double noteFrequency );
+
+	//! Retrieve the frequency of the locked note (0 before the first lock).
+	double noteFrequency( ) const { return _noteFrequency; };
+
+	//! Restart the tracking of the phases (e.g. after a discontinuity in the audio stream).
+	void reset( );
+
+	//! Demodulate a block of input samples.
+	/*!
+	 * The samples must be contiguous with the ones of the previous call,
+	 * which can be split anywhere.
+	 * \param[in] input the array with the input samples, converted for the analysis
+	 * \param[in] sampleCount the number of input samples
+	 */
+	void process( const qfftw_real* input, const unsigned int sampleCount );
+
+	//! Retrieve the frequency of the note averaged over the blocks completed since the previous call.
+	/*!
+	 * \return the estimated frequency (the previous one if no block has been completed, 0 before the first two blocks)
+	 */
+	double estimate( );
+
+	//! Check whether the note was still held during the blocks of the last estimate.
+	bool isLocked( ) const { return _locked; };
+
+	//! Retrieve the phase of the strobe, the drift of the note accumulated since the lock.
+	/*!
+	 * \return the phase in cycles of the note, in the range [0, 1)
+	 */
+	double phase( ) const { return _phase; };
+
+
+private: /* structures */
+	//! Demodulation state of a partial of the note.
+	struct Partial {
+		double			omega;									//!< Angular frequency of the partial (in radians per sample)
+		double			rotation_re;							//!< Real part of the rotation of the oscillator for each sample
+		double			rotation_im;							//!< Imaginary part of the rotation of the oscillator for each sample
+		double			oscillatorPhase;						//!< Phase of the oscillator at the start of the current block
+		double			lastPhase;								//!< Phase of the partial in the previous block
+	};
+
+
+private: /* static constants */
+	static const unsigned int	MAX_PARTIALS;					//!< Largest number of partials demodulated (the drift of the highest one must be unambiguous)
+	static const double			MAX_PARTIAL_RATIO;				//!< Highest partial frequency relative to the sample rate
+	static const double			BLOCK_PERIODS;					//!< Number of periods of the note spanned by a block
+	static const unsigned int	MIN_BLOCK_SIZE;					//!< Size of the shortest block
+	static const double			MIN_PARTIAL_POWER;				//!< Lowest fraction of the power of the signal carried by the partials of a held note
+	static const double			MAX_DEVIATION;					//!< Largest deviation of a held note (in octaves)
+
+
+private: /* members */
+	// ** NOTE ** //
+	double				_sampleFrequency;						//!< Sample rate of the analysed samples
+	double				_noteFrequency;							//!< Frequency of the locked note
+	QVector<Partial>	_partials;								//!< Demodulation state of each partial, from the fundamental up
+
+	// ** BLOCKS ** //
+	double*				_block;									//!< Most recent input samples
+	double*				_windowedBlock;							//!< Samples of the current block multiplied by the window
+	double*				_window;								//!< Hann window of the blocks
+	double				_windowSum;								//!< Sum of the samples of the window (the gain of a partial)
+	double				_windowPower;							//!< Sum of the squared samples of the window (the gain of the power of the signal)
+	unsigned int		_block_size;							//!< Number of samples of a block
+	unsigned int		_block_index;							//!< Index in the block
+	unsigned int		_hopSize;								//!< Number of new samples between two blocks (half a block)
+	unsigned int		_blockCount;							//!< Number of blocks completed since the lock
+
+	// ** ESTIMATE ** //
+	double				_offsetSum;								//!< Sum of the weighted frequency offsets since the last estimate
+	double				_weightSum;								//!< Sum of the weights of the offsets since the last estimate
+	double				_partialPowerSum;						//!< Power of the partials since the last estimate
+	double				_signalPowerSum;						//!< Power of the signal since the last estimate
+	double				_estimatedFrequency;					//!< Last estimated frequency of the note
+	bool				_locked;								//!< True when the note was held during the blocks of the last estimate
+	double				_phase;									//!< Phase of the strobe (in cycles of the note)
+
+
+private: /* methods */
+	//! Demodulate the current block and accumulate the drift of the partials.
+	void processBlock( );
+
+	//! Disabled copy constructor.
+	QStrobeBank( const QStrobeBank& );
+
+	//! Disabled assignment operator.
+	QStrobeBank& operator=( const QStrobeBank& );
+};
+
+#endif /* __QSTROBEBANK_H_ */
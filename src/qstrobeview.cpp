@@ -0,0 +1,119 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+#include "qstrobeview.h"
+
+#include <cmath>
+
+#include <QPainter>
+
+// ** WIDGET SIZES ** //
+const double	QStrobeView::SIDE_MARGIN		= 0.02;
+const double	QStrobeView::TOP_MARGIN			= 0.055;
+const int		QStrobeView::BAND_COUNT			= 4;
+const int		QStrobeView::BAND_SPACING		= 4;
+const int		QStrobeView::STRIPE_COUNT		= 4;
+const int		QStrobeView::LABEL_SPACING		= 8;
+
+
+QStrobeView::QStrobeView( QWidget* parent ) : QWidget( parent )
+{
+	// disable the stripes until a note is locked
+	_noteFrequency			= 0.0;
+	_estimatedFrequency		= 0.0;
+	_phase					= 0.0;
+	_drawForeground			= false;
+}
+
+
+void QStrobeView::setStrobe( double noteFrequency, double estimatedFrequency, double phase )
+{
+	// ** STORE THE STATE OF THE STROBE, REPAINTING ONLY IF IT CHANGES ** //
+	if ( (noteFrequency != _noteFrequency) || (estimatedFrequency != _estimatedFrequency) || (phase != _phase) ) {
+		_noteFrequency		= noteFrequency;
+		_estimatedFrequency	= estimatedFrequency;
+		_phase				= phase;
+		update( );
+	}
+}
+
+
+void QStrobeView::setPlotEnabled( bool enabled )
+{
+	// ** SET THE ACTIVAITON STATUS ** //
+	if ( enabled != _drawForeground ) {
+		_drawForeground = enabled;
+		update( );
+	}
+}
+
+
+void QStrobeView::paintEvent( QPaintEvent* /* event */ )
+{
+	// ** INITIALIZE PAINTER ** //
+	QPainter painter( this );
+	const bool locked = (_drawForeground == true) && (_noteFrequency > 0.0) && (_estimatedFrequency > 0.0);
+
+	// increase the font size
+	QFont font = painter.font( );
+	font.setPointSize( font.pointSize( ) + 2 );
+	painter.setFont( font );
+
+	// ** COMPUTE THE SIZE OF THE BANDS ** //
+	// the label of the deviation is below the bands
+	const int		bandArea_sideMargin	= (int)(width( ) * SIDE_MARGIN);
+	const int		bandArea_topMargin	= (int)(height( ) * TOP_MARGIN);
+	const int		bandArea_width		= width( ) - 2 * bandArea_sideMargin;
+	const int		labelHeight			= painter.fontMetrics( ).height( ) + 2 * LABEL_SPACING;
+	const double	bandHeight			= (height( ) - 2 * bandArea_topMargin - labelHeight - (BAND_COUNT - 1) * BAND_SPACING) / (double) BAND_COUNT;
+
+	// ** DRAW THE BANDS ** //
+	painter.translate( bandArea_sideMargin, bandArea_topMargin );
+	painter.setClipRect( 0, 0, bandArea_width, height( ) - 2 * bandArea_topMargin - labelHeight );
+	painter.setPen( Qt::NoPen );
+	painter.setBrush( locked ? QBrush( Qt::darkBlue ) : palette( ).mid( ) );
+
+	for ( int b = 0 ; b < BAND_COUNT ; ++b ) {
+		const double yBand = b * (bandHeight + BAND_SPACING);
+		painter.fillRect( QRectF( 0, yBand, bandArea_width, bandHeight ), palette( ).light( ) );
+
+		// every band scrolls by the same distance, which is a whole number of stripes of the denser ones
+		const double stripePeriod	= (double) bandArea_width / (STRIPE_COUNT << b);
+		const double xOffset		= fmod( _phase * bandArea_width / STRIPE_COUNT, stripePeriod );
+		for ( double xStripe = xOffset - stripePeriod ; xStripe < bandArea_width ; xStripe += stripePeriod ) {
+			painter.drawRect( QRectF( xStripe, yBand, stripePeriod / 2, bandHeight ) );
+		}
+	}
+
+	// ** DRAW THE DEVIATION FROM THE NOTE ** //
+	painter.setClipping( false );
+	painter.setPen( QPen( palette( ).text( ), 0, Qt::SolidLine ) );
+
+	QString label( "-" );
+	if ( locked ) {
+		const double deviation = 1200.0 * log( _estimatedFrequency / _noteFrequency ) / log( 2.0 );
+		label = QString( "%1%2 cents" ).arg( (deviation < 0.0) ? "" : "+" ).arg( deviation, 0, 'f', 1 );
+	}
+	painter.drawText( bandArea_width / 2 - painter.fontMetrics( ).horizontalAdvance( label ) / 2 + 1,
+		height( ) - 2 * bandArea_topMargin - LABEL_SPACING - painter.fontMetrics( ).descent( ), label );
+}
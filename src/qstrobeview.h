@@ -0,0 +1,94 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+//! Strobe visualization of the locked note.
+/*!
+ * This class implements the display of a strobe tuner: a few bands of
+ * stripes, each one twice as dense as the one above, scroll to the
+ * right when the note is sharp and to the left when it is flat, by the
+ * phase drift measured by the strobe of the pitch detector, and stand
+ * still when the note is in tune. The deviation from the note is
+ * displayed below the bands with a resolution of a tenth of a cent.
+ * The stripes are greyed out until the note is locked.
+ */
+
+#ifndef __QSTROBEVIEW_H_
+#define __QSTROBEVIEW_H_
+
+#include <QWidget>
+
+class QStrobeView : public QWidget {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] parent handle to the parent widget
+	 */
+	QStrobeView( QWidget* parent = 0 );
+
+
+public slots:
+	//! Set the state of the strobe.
+	/*!
+	 * \param[in] noteFrequency the frequency of the note followed by the strobe (0 until the note is locked)
+	 * \param[in] estimatedFrequency the frequency of the input signal estimated by the strobe
+	 * \param[in] phase the phase of the strobe (in cycles of the note, in the range [0, 1))
+	 */
+	void setStrobe( double noteFrequency, double estimatedFrequency, double phase );
+
+	//! Enable the visualization of the strobe.
+	/*!
+	 * \param[in] enabled the status of the strobe
+	 */
+	void setPlotEnabled( bool enabled );
+
+
+protected: /* methods */
+	//! Function called to handle a repaint request.
+	/*!
+	 * \param[in] event the details of the repaint event
+	 */
+	virtual void paintEvent( QPaintEvent* event );
+
+
+private: /* static constants */
+	static const double	SIDE_MARGIN;					//!< Percent width of the horizontal margin of the bands
+	static const double	TOP_MARGIN;						//!< Percent height of the vertical margin of the bands
+	static const int	BAND_COUNT;						//!< Number of bands of stripes
+	static const int	BAND_SPACING;					//!< Pixel distance between two bands
+	static const int	STRIPE_COUNT;					//!< Number of pairs of stripes in the first band
+	static const int	LABEL_SPACING;					//!< Pixel distance of the label from the bands
+
+
+private: /* members */
+	// ** STROBE ** //
+	double				_noteFrequency;					//!< Frequency of the note followed by the strobe (0 until the note is locked)
+	double				_estimatedFrequency;			//!< Frequency of the input signal estimated by the strobe
+	double				_phase;							//!< Phase of the strobe (in cycles of the note)
+
+	// ** REPAINT FLAG **//
+	bool				_drawForeground;				//!< Draw the moving stripes when true, otherwise draw the greyed out bands
+};
+
+#endif /* __QSTROBEVIEW_H_ */
@@ -0,0 +1,213 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qsynthsoundinput.h"
+
+#include <QMutex>
+
+#include <cmath>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const double QSynthSoundInput::STRING_FUNDAMENTAL	= 0.1;
+
+
+QSynthSoundInput::QSynthSoundInput( const Waveform waveform, const double frequency, QObject* parent ) : QStreamSoundInput( parent )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_parameterMutex	= new QMutex( );
+	_waveform		= waveform;
+	_frequency		= frequency;
+	_amplitude		= 10000.0;
+	_harmonicCount	= 5;
+	_noiseLevel		= 0.0;
+	_phase			= 0.0;
+	_noiseSeed		= 1;
+}
+
+
+QSynthSoundInput::~QSynthSoundInput( )
+{
+	// ** RELEASE RESOURCES ** //
+	delete _parameterMutex;
+}
+
+
+QString QSynthSoundInput::description( ) const
+{
+	QMutexLocker locker( _parameterMutex );
+
+	static const char* const waveformName[] = { "sine", "square", "harmonics", "noise", "sawtooth", "string" };
+	return QString( "Synthesizer: %1, %2 Hz" ).arg( waveformName[_waveform] ).arg( _frequency, 0, 'f', 2 );
+}
+
+
+void QSynthSoundInput::setWaveform( const Waveform waveform )
+{
+	QMutexLocker locker( _parameterMutex );
+	_waveform = waveform;
+}
+
+
+void QSynthSoundInput::setFrequency( const double frequency )
+{
+	QMutexLocker locker( _parameterMutex );
+	_frequency = frequency;
+}
+
+
+void QSynthSoundInput::setAmplitude( const double amplitude )
+{
+	QMutexLocker locker( _parameterMutex );
+	_amplitude = qBound( 0.0, amplitude, 32767.0 );
+}
+
+
+void QSynthSoundInput::setHarmonicCount( const unsigned int harmonicCount )
+{
+	QMutexLocker locker( _parameterMutex );
+	_harmonicCount = qMax( harmonicCount, 1u );
+}
+
+
+void QSynthSoundInput::setNoiseLevel( const double noiseLevel )
+{
+	QMutexLocker locker( _parameterMutex );
+	_noiseLevel = qMax( noiseLevel, 0.0 );
+}
+
+
+unsigned int QSynthSoundInput::openSource( const unsigned int sampleFrequency )
+{
+	// ** RESTART THE GENERATOR ** //
+	_phase			= 0.0;
+	_noiseSeed		= 1;
+	_channelCount	= 1;				// the generator is mono
+
+	return sampleFrequency;
+}
+
+
+void QSynthSoundInput::closeSource( )
+{
+	return;
+}
+
+
+unsigned int QSynthSoundInput::readSource( short int* buffer, const unsigned int frameCount )
+{
+	// ** READ THE PARAMETERS ONCE PER BUFFER ** //
+	_parameterMutex->lock( );
+	const Waveform		waveform		= _waveform;
+	const double		phaseStep		= 2.0 * M_PI * _frequency / _sampleFrequency;
+	const double		amplitude		= _amplitude;
+	const unsigned int	harmonicCount	= _harmonicCount;
+	const double		noiseLevel		= _noiseLevel;
+	_parameterMutex->unlock( );
+
+	// normalize the stack of harmonics to the requested peak amplitude
+	// (the string has a fundamental of 0.1 and harmonics decreasing as 1/(k-1) from the second one)
+	double harmonicGain = 0.0;
+	double stringGain	= STRING_FUNDAMENTAL;
+	for ( unsigned int h = 1 ; h <= harmonicCount ; ++h ) {
+		harmonicGain += 1.0 / h;
+		if ( h > 1 ) {
+			stringGain += 1.0 / (h - 1);
+		}
+	}
+
+	// ** GENERATE THE SAMPLES ** //
+	for ( unsigned int k = 0 ; k < frameCount ; ++k ) {
+		double value = 0.0;
+		switch ( waveform ) {
+			case WAVE_SINE:
+				value = sin( _phase );
+				break;
+			case WAVE_SQUARE:
+				// the steps fall between the samples: without the correction the sampled
+				// period is rounded to an integer number of samples and the wave aliases
+				value = (_phase < M_PI) ? 1.0 : -1.0;
+				value += polyBlep( _phase / (2.0 * M_PI), phaseStep / (2.0 * M_PI) );
+				value -= polyBlep( fmod( _phase / (2.0 * M_PI) + 0.5, 1.0 ), phaseStep / (2.0 * M_PI) );
+				break;
+			case WAVE_HARMONICS:
+				for ( unsigned int h = 1 ; h <= harmonicCount ; ++h ) {
+					value += sin( h * _phase ) / h;
+				}
+				value /= harmonicGain;
+				break;
+			case WAVE_NOISE:
+				value = noise( );
+				break;
+			case WAVE_SAWTOOTH:
+				value = _phase / M_PI - 1.0;
+				value -= polyBlep( _phase / (2.0 * M_PI), phaseStep / (2.0 * M_PI) );
+				break;
+			case WAVE_STRING:
+				value = STRING_FUNDAMENTAL * sin( _phase );
+				for ( unsigned int h = 2 ; h <= harmonicCount ; ++h ) {
+					value += sin( h * _phase ) / (h - 1);
+				}
+				value /= stringGain;
+				break;
+		}
+
+		if ( (noiseLevel > 0.0) && (waveform != WAVE_NOISE) ) {
+			value += noiseLevel * noise( );
+		}
+		buffer[k] = (short int) qBound( -32768.0, amplitude * value, 32767.0 );
+
+		// advance the phase keeping it in the range [0, 2*pi)
+		_phase += phaseStep;
+		if ( _phase >= 2.0 * M_PI ) {
+			_phase -= 2.0 * M_PI * floor( _phase / (2.0 * M_PI) );
+		}
+	}
+
+	return frameCount;
+}
+
+
+double QSynthSoundInput::noise( )
+{
+	// ** XORSHIFT PSEUDO-RANDOM GENERATOR ** //
+	_noiseSeed ^= _noiseSeed << 13;
+	_noiseSeed ^= _noiseSeed >> 17;
+	_noiseSeed ^= _noiseSeed << 5;
+
+	return (double) _noiseSeed / 2147483647.5 - 1.0;
+}
+
+
+double QSynthSoundInput::polyBlep( double t, const double dt )
+{
+	// ** TWO-SAMPLE POLYNOMIAL APPROXIMATION OF A BAND-LIMITED STEP ** //
+	if ( t < dt ) {
+		t /= dt;
+		return t + t - t * t - 1.0;
+	} else if ( t > 1.0 - dt ) {
+		t = (t - 1.0) / dt;
+		return t * t + t + t + 1.0;
+	}
+
+	return 0.0;
+}
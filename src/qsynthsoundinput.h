@@ -0,0 +1,159 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QSYNTHSOUNDINPUT_H_
+#define __QSYNTHSOUNDINPUT_H_
+
+#include "qstreamsoundinput.h"
+
+class QMutex;
+
+
+//! Sound input generated by a synthesizer.
+/*!
+ * This class generates a test signal, so that the analysis can be driven
+ * without a sound card. The waveform is a sine, a square wave, a stack of
+ * harmonics (with amplitudes decreasing as 1/k), white noise, a sawtooth
+ * or a string-like stack of harmonics with a weak fundamental, and some
+ * white noise may be added to the periodic waveforms.
+ * All the parameters may be changed while the stream is running: the new
+ * values are applied at the beginning of the next buffer and the phase of
+ * the waveform is kept continuous.
+ */
+
+class QSynthSoundInput : public QStreamSoundInput {
+	Q_OBJECT
+
+
+public: /* enumerations */
+	//! Waveform generated by the synthesizer.
+	enum Waveform {
+		WAVE_SINE,												//!< Sine wave
+		WAVE_SQUARE,											//!< Square wave (discontinuities smoothed with PolyBLEP)
+		WAVE_HARMONICS,											//!< Stack of harmonics with amplitudes decreasing as 1/k
+		WAVE_NOISE,												//!< White noise
+		WAVE_SAWTOOTH,											//!< Sawtooth wave (discontinuity smoothed with PolyBLEP)
+		WAVE_STRING												//!< Stack of harmonics with a fundamental 20 dB below the second harmonic
+	};
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] waveform the waveform to generate (default WAVE_SINE)
+	 * \param[in] frequency the frequency of the waveform in Hz (default 440.0)
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QSynthSoundInput( const Waveform waveform = WAVE_SINE, const double frequency = 440.0, QObject* parent = 0 );
+
+	//! Default destructor.
+	~QSynthSoundInput( );
+
+	//! Retrieve the description of the source.
+	virtual QString description( ) const;
+
+	//! Select the waveform.
+	/*!
+	 * \param[in] waveform the waveform to generate
+	 */
+	void setWaveform( const Waveform waveform );
+
+	//! Set the frequency of the waveform.
+	/*!
+	 * \param[in] frequency the frequency in Hz
+	 */
+	void setFrequency( const double frequency );
+
+	//! Set the amplitude of the waveform.
+	/*!
+	 * \param[in] amplitude the peak amplitude in the range [0, 32767] (default 10000)
+	 */
+	void setAmplitude( const double amplitude );
+
+	//! Set the number of harmonics of WAVE_HARMONICS and WAVE_STRING.
+	/*!
+	 * \param[in] harmonicCount the number of harmonics including the fundamental (default 5)
+	 */
+	void setHarmonicCount( const unsigned int harmonicCount );
+
+	//! Set the level of the white noise added to the periodic waveforms.
+	/*!
+	 * \param[in] noiseLevel the peak amplitude of the noise relative to the amplitude of the waveform (default 0)
+	 */
+	void setNoiseLevel( const double noiseLevel );
+
+
+protected: /* methods */
+	//! Reset the phase of the waveform.
+	/*!
+	 * \param[in] sampleFrequency the sample rate of the generated signal
+	 * \return the requested sample rate
+	 */
+	virtual unsigned int openSource( const unsigned int sampleFrequency );
+
+	//! Nothing to release.
+	virtual void closeSource( );
+
+	//! Generate the next samples.
+	/*!
+	 * \param[out] buffer the array used to store the samples
+	 * \param[in] frameCount the size of the array
+	 * \return the number of samples generated (always frameCount)
+	 */
+	virtual unsigned int readSource( short int* buffer, const unsigned int frameCount );
+
+
+private: /* static constants */
+	static const double	STRING_FUNDAMENTAL;						//!< Amplitude of the fundamental of WAVE_STRING relative to the second harmonic
+
+
+private: /* members */
+	// ** PARAMETERS ** //
+	QMutex*				_parameterMutex;						//!< Mutex protecting the parameters changed while the stream is running
+	Waveform			_waveform;								//!< Waveform to generate
+	double				_frequency;								//!< Frequency of the waveform
+	double				_amplitude;								//!< Peak amplitude of the waveform
+	unsigned int		_harmonicCount;							//!< Number of harmonics of WAVE_HARMONICS and WAVE_STRING
+	double				_noiseLevel;							//!< Relative level of the noise added to the periodic waveforms
+
+	// ** GENERATOR STATUS ** //
+	double				_phase;									//!< Phase of the fundamental in the range [0, 2*pi)
+	quint32				_noiseSeed;								//!< Status of the pseudo-random generator used for the noise
+
+
+private: /* methods */
+	//! Generate a uniformly distributed pseudo-random value.
+	/*!
+	 * \return a value in the range [-1, 1]
+	 */
+	double noise( );
+
+	//! Compute the PolyBLEP correction of a unit step at phase zero.
+	/*!
+	 * \param[in] t the normalized phase in the range [0, 1)
+	 * \param[in] dt the normalized phase step per sample
+	 * \return the residual to add to the naive waveform around the step
+	 */
+	static double polyBlep( double t, const double dt );
+};
+
+#endif /* __QSYNTHSOUNDINPUT_H_ */
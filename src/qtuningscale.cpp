@@ -0,0 +1,120 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qtuningscale.h"
+
+#include <cmath>
+
+// ** MUSICAL NOTATIONS ** //
+const QString QTuningScale::NoteLabel[6][12] = {
+	{  "A",  QString("A%1").arg(QChar(0x266F)),  "B",  "C",  QString("C%1").arg(QChar(0x266F)),  "D",  QString("D%1").arg(QChar(0x266F)),  "E",  "F",   QString("F%1").arg(QChar(0x266F)),   "G",   QString("G%1").arg(QChar(0x266F)) },	/* US  */
+	{  "A",  QString("B%1").arg(QChar(0x266D)),  "B",  "C",  QString("D%1").arg(QChar(0x266D)),  "D",  QString("E%1").arg(QChar(0x266D)),  "E",  "F",   QString("G%1").arg(QChar(0x266D)),   "G",   QString("A%1").arg(QChar(0x266D)) },	/* US alternate */
+	{ "La", QString("La%1").arg(QChar(0x266F)), "Si", "Do", QString("Do%1").arg(QChar(0x266F)), "Re", QString("Re%1").arg(QChar(0x266F)), "Mi", "Fa",  QString("Fa%1").arg(QChar(0x266F)), "Sol", QString("Sol%1").arg(QChar(0x266F)) },	/* French */
+	{ "La", QString("Si%1").arg(QChar(0x266D)), "Si", "Do", QString("Re%1").arg(QChar(0x266D)), "Re", QString("Mi%1").arg(QChar(0x266D)), "Mi", "Fa", QString("Sol%1").arg(QChar(0x266D)), "Sol",  QString("La%1").arg(QChar(0x266D)) },	/* French alternate */
+	{  "A",                                "B",  "H",  "C",  QString("C%1").arg(QChar(0x266F)),  "D",  QString("D%1").arg(QChar(0x266F)),  "E",  "F",   QString("F%1").arg(QChar(0x266F)),   "G",   QString("G%1").arg(QChar(0x266F)) },	/* German */
+	{  "A",                                "B",  "H",  "C",  QString("D%1").arg(QChar(0x266D)),  "D",  QString("E%1").arg(QChar(0x266D)),  "E",  "F",   QString("G%1").arg(QChar(0x266D)),   "G",   QString("A%1").arg(QChar(0x266D)) }		/* German alternate */
+};
+
+// ** RANGE OF THE SCALE ** //
+const double	QTuningScale::LOWEST_FREQUENCY	= 20.0;
+const double	QTuningScale::MIN_FREQUENCY		= 40.0;
+const double	QTuningScale::MAX_FREQUENCY		= 2000.0;
+
+
+QTuningScale::QTuningScale( const double fundamentalFrequency, const TuningNotation tuningNotation, const double minFrequency )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_fundamentalFrequency	= 440.0;
+	_tuningNotation			= NOTATION_US;
+	_minFrequency			= MIN_FREQUENCY;
+	setTuningParameters( fundamentalFrequency, tuningNotation );
+	setMinFrequency( minFrequency );
+}
+
+
+void QTuningScale::setTuningParameters( const double fundamentalFrequency, const TuningNotation tuningNotation )
+{
+	// ** CHECK LIMITS AND UPDATE PARAMETERS ** //
+	if ( tuningNotation <= NOTATION_GERMAN ) {
+		_tuningNotation = tuningNotation;
+	}
+
+	if ( (fundamentalFrequency >= 400.0) && (fundamentalFrequency <= 480.0) ) {
+		_fundamentalFrequency = fundamentalFrequency;
+	}
+}
+
+
+void QTuningScale::getTuningParameters( double& fundamentalFrequency, TuningNotation& tuningNotation ) const
+{
+	fundamentalFrequency	= _fundamentalFrequency;
+	tuningNotation			= _tuningNotation;
+}
+
+
+void QTuningScale::setMinFrequency( const double minFrequency )
+{
+	// ** CHECK LIMITS AND UPDATE THE RANGE ** //
+	if ( (minFrequency >= LOWEST_FREQUENCY) && (minFrequency <= MIN_FREQUENCY) ) {
+		_minFrequency = minFrequency;
+	}
+}
+
+
+bool QTuningScale::findNote( const double frequency, int& note, int& octave, double& deviation ) const
+{
+	// process only notes within the range [minFrequency, 2000] Hz
+	if ( (frequency < _minFrequency) || (frequency > MAX_FREQUENCY) ) {
+		return false;
+	}
+
+	/*
+	 * in the equal-tempered scale the distance between two notes is
+	 * constant in the logarithmic scale, so the closest note is found
+	 * rounding the number of semitones from the fundamental frequency
+	 */
+	const double	semitones	= 12.0 * log( frequency / _fundamentalFrequency ) / log( 2.0 );
+	const int		closest		= (int) floor( semitones + 0.5 );
+
+	note		= ( (closest % 12) + 12 ) % 12;
+	octave		= 4 + (int) floor( closest / 12.0 ) + ( (note >= 3) ? 1 : 0 );		// the octave starts from C
+	deviation	= semitones - closest;
+
+	return true;
+}
+
+
+double QTuningScale::noteFrequency( const int note, const int octave ) const
+{
+	// ** COUNT THE SEMITONES FROM A4 ** //
+	const int semitones = note + 12 * ( octave - 4 - ( (note >= 3) ? 1 : 0 ) );
+	return _fundamentalFrequency * pow( 2.0, semitones / 12.0 );
+}
+
+
+QString QTuningScale::noteLabel( const int note, const bool alternate ) const
+{
+	// ** ENSURE THAT THE NOTE IS VALID ** //
+	Q_ASSERT( (note >= 0) && (note < 12) );
+
+	return NoteLabel[2 * _tuningNotation + ( alternate ? 1 : 0 )][note];
+}
@@ -0,0 +1,131 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QTUNINGSCALE_H_
+#define __QTUNINGSCALE_H_
+
+#include <QString>
+
+
+//! Equal-tempered note scale used to identify the pitch.
+/*!
+ * This class maps a frequency to the closest note of the equal-tempered
+ * scale built on the fundamental frequency of A4, and gives the deviation
+ * from the note and its label in the chosen musical notation.
+ * The notes are indexed from A (0) to G sharp (11), while the octaves
+ * follow the scientific pitch notation (A4 is the fundamental and C5 is
+ * the first note above B4).
+ * Only the frequencies in the range [minFrequency, MAX_FREQUENCY] are
+ * identified, which is the range of the notes displayed by the tuner: the
+ * lower bound is MIN_FREQUENCY by default, and can be lowered down to
+ * LOWEST_FREQUENCY for the instruments that go below the low E of the
+ * bass guitar.
+ */
+
+class QTuningScale {
+
+public: /* enumerations */
+	//! Enumeration of the available tuning scales
+	enum TuningNotation {
+		NOTATION_US,
+		NOTATION_FRENCH,
+		NOTATION_GERMAN
+	};
+
+
+public: /* static constants */
+	static const double	LOWEST_FREQUENCY;				//!< Lowest frequency that can be identified as a note
+	static const double	MIN_FREQUENCY;					//!< Lowest frequency identified as a note by default
+	static const double	MAX_FREQUENCY;					//!< Highest frequency identified as a note
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] fundamentalFrequency fundamental frequency of the note A4 (default 440.0)
+	 * \param[in] tuningNotation tuning notation used to select the labels (default NOTATION_US)
+	 * \param[in] minFrequency lowest frequency identified as a note (default MIN_FREQUENCY)
+	 */
+	QTuningScale( const double fundamentalFrequency = 440.0, const TuningNotation tuningNotation = NOTATION_US,
+		const double minFrequency = MIN_FREQUENCY );
+
+	//! Set the parameters of the scale.
+	/*!
+	 * \param[in] fundamentalFrequency fundamental frequency of the note A4 (ignored if outside the range [400, 480] Hz)
+	 * \param[in] tuningNotation tuning notation used to select the labels
+	 */
+	void setTuningParameters( const double fundamentalFrequency, const TuningNotation tuningNotation );
+
+	//! Get the parameters of the scale.
+	/*!
+	 * \param[out] fundamentalFrequency fundamental frequency of the note A4
+	 * \param[out] tuningNotation tuning notation used to select the labels
+	 */
+	void getTuningParameters( double& fundamentalFrequency, TuningNotation& tuningNotation ) const;
+
+	//! Set the lower bound of the range of the scale.
+	/*!
+	 * \param[in] minFrequency lowest frequency identified as a note (ignored if outside the range [LOWEST_FREQUENCY, MIN_FREQUENCY])
+	 */
+	void setMinFrequency( const double minFrequency );
+
+	//! Retrieve the lower bound of the range of the scale.
+	double minFrequency( ) const { return _minFrequency; };
+
+	//! Find the note closest to a given frequency.
+	/*!
+	 * \param[in] frequency the frequency to identify
+	 * \param[out] note the index of the closest note in the range [0, 11] (0 is A)
+	 * \param[out] octave the octave of the closest note in scientific pitch notation
+	 * \param[out] deviation the deviation from the closest note in semitones, in the range [-0.5, 0.5]
+	 * \return false if the frequency is outside the range of the scale
+	 */
+	bool findNote( const double frequency, int& note, int& octave, double& deviation ) const;
+
+	//! Retrieve the frequency of a note.
+	/*!
+	 * \param[in] note the index of the note in the range [0, 11] (0 is A)
+	 * \param[in] octave the octave of the note in scientific pitch notation
+	 * \return the frequency of the note
+	 */
+	double noteFrequency( const int note, const int octave ) const;
+
+	//! Retrieve the label of a note.
+	/*!
+	 * \param[in] note the index of the note in the range [0, 11] (0 is A)
+	 * \param[in] alternate true to use the alternate label (flat instead of sharp)
+	 * \return the label of the note in the current notation
+	 */
+	QString noteLabel( const int note, const bool alternate = false ) const;
+
+
+private: /* members */
+	// ** TUNING NOTATIONS ** //
+	static const QString NoteLabel[6][12];				//!< Labels of the note in different tuning scales
+
+	// ** SCALE PARAMETERS ** //
+	double				_fundamentalFrequency;			//!< Fundamental frequency used as a reference to build the pitch scale
+	TuningNotation		_tuningNotation;				//!< Musical notation used to select the labels
+	double				_minFrequency;					//!< Lowest frequency identified as a note
+};
+
+#endif /* __QTUNINGSCALE_H_ */
@@ -0,0 +1,130 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qwakeup.h"
+
+#ifdef Q_OS_LINUX
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <QMutex>
+#include <QWaitCondition>
+#endif
+
+
+#ifdef Q_OS_LINUX
+//! Address of the integer stored by an atomic counter, used by the futex system calls.
+static int* futexAddress( QAtomicInt& counter )
+{
+	// QAtomicInt stores a plain int, as required by the futex
+	return reinterpret_cast<int*>( &counter );
+}
+#endif
+
+
+QWakeup::QWakeup( )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_count.storeRelaxed( 0 );
+	_sleepers.storeRelaxed( 0 );
+#ifndef Q_OS_LINUX
+	_mutex		= new QMutex( );
+	_waitCond	= new QWaitCondition( );
+#endif
+}
+
+
+QWakeup::~QWakeup( )
+{
+	// ** ENSURE THAT NO THREAD IS WAITING ** //
+	Q_ASSERT( _sleepers.loadAcquire( ) == 0 );
+
+#ifndef Q_OS_LINUX
+	// ** RELEASE RESOURCES ** //
+	delete _mutex;
+	delete _waitCond;
+#endif
+}
+
+
+void QWakeup::wait( const int count )
+{
+	// ** SLEEP WHILE THE COUNTER IS UNCHANGED ** //
+	/*
+	 * the sleeper is counted before checking the counter, while wakeAll
+	 * increments the counter before checking the sleepers: so either the
+	 * sleeper sees the new count or wakeAll sees the sleeper
+	 */
+	_sleepers.fetchAndAddOrdered( 1 );
+#ifdef Q_OS_LINUX
+	// the kernel checks the counter again before sleeping, so a wake up cannot be lost
+	while ( _count.fetchAndAddOrdered( 0 ) == count ) {
+		syscall( SYS_futex, futexAddress( _count ), FUTEX_WAIT_PRIVATE, count, NULL, NULL, 0 );
+	}
+#else
+	_mutex->lock( );
+	while ( _count.fetchAndAddOrdered( 0 ) == count ) {
+		_waitCond->wait( _mutex );
+	}
+	_mutex->unlock( );
+#endif
+	_sleepers.fetchAndAddOrdered( -1 );
+}
+
+
+void QWakeup::wakeAll( )
+{
+	// ** COUNT THE WAKE UP ** //
+	_count.fetchAndAddOrdered( 1 );
+
+	// ** WAKE UP THE SLEEPING THREADS, IF ANY ** //
+	if ( _sleepers.fetchAndAddOrdered( 0 ) > 0 ) {
+#ifdef Q_OS_LINUX
+		syscall( SYS_futex, futexAddress( _count ), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0 );
+#else
+		_mutex->lock( );
+		_waitCond->wakeAll( );
+		_mutex->unlock( );
+#endif
+	}
+}
+
+
+void QWakeup::wakeOne( )
+{
+	// ** COUNT THE WAKE UP ** //
+	_count.fetchAndAddOrdered( 1 );
+
+	// ** WAKE UP ONE OF THE SLEEPING THREADS, IF ANY ** //
+	// the threads that are about to sleep see the new count and return as well
+	if ( _sleepers.fetchAndAddOrdered( 0 ) > 0 ) {
+#ifdef Q_OS_LINUX
+		syscall( SYS_futex, futexAddress( _count ), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+#else
+		_mutex->lock( );
+		_waitCond->wakeOne( );
+		_mutex->unlock( );
+#endif
+	}
+}
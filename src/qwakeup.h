@@ -0,0 +1,94 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QWAKEUP_H_
+#define __QWAKEUP_H_
+
+#include <QAtomicInt>
+
+class QMutex;
+class QWaitCondition;
+
+
+//! Lock-free wake up of the threads waiting for new work.
+/*!
+ * This class lets a real-time thread (e.g. the audio callback) wake up
+ * the threads that process its data without taking any lock.
+ * The object counts the wake ups: a waiting thread reads the counter
+ * with count( ), then checks whether there is any work to do and, if
+ * there is none, calls wait( ) with the value read, which returns as
+ * soon as the counter changes. So a wake up that happens between the
+ * check and the wait is never lost.
+ * On Linux the waiting threads sleep on a futex, thus a wake up is an
+ * atomic increment followed, only when a thread is sleeping, by the
+ * futex system call, which never blocks. On the other systems the
+ * sleeping threads are woken up through a wait condition, whose mutex
+ * is locked only when a thread is actually sleeping.
+ * wakeOne( ) wakes up a single sleeping thread, for the work that any
+ * one of the threads can pick up.
+ */
+
+class QWakeup {
+
+public: /* methods */
+	//! Default constructor.
+	QWakeup( );
+
+	//! Default destructor (no thread may be waiting).
+	~QWakeup( );
+
+	//! Retrieve the number of wake ups, to be read before checking for new work.
+	int count( ) const {
+		return _count.loadAcquire( );
+	};
+
+	//! Sleep till the next wake up.
+	/*!
+	 * \param[in] count the number of wake ups read before checking for new work (the function returns immediately if it has changed)
+	 */
+	void wait( const int count );
+
+	//! Wake up all the waiting threads (it never blocks, so it can be called by a real-time thread on Linux).
+	void wakeAll( );
+
+	//! Wake up one of the waiting threads (it never blocks, so it can be called by a real-time thread on Linux).
+	void wakeOne( );
+
+
+private: /* members */
+	QAtomicInt			_count;									//!< Number of wake ups (it wraps around)
+	QAtomicInt			_sleepers;								//!< Number of threads in wait
+#ifndef Q_OS_LINUX
+	QMutex*				_mutex;									//!< Mutex used by the wait condition
+	QWaitCondition*		_waitCond;								//!< Wait condition used to put the threads to sleep
+#endif
+
+
+private: /* methods */
+	//! Disabled copy constructor.
+	QWakeup( const QWakeup& );
+
+	//! Disabled assignment operator.
+	QWakeup& operator=( const QWakeup& );
+};
+
+#endif /* __QWAKEUP_H_ */
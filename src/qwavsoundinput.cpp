@@ -0,0 +1,205 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qwavsoundinput.h"
+
+#include <cstring>
+
+#include <QtDebug>
+#include <QtEndian>
+
+
+QWavSoundInput::QWavSoundInput( const QString& fileName, const bool loop, QObject* parent ) : QStreamSoundInput( parent )
+{
+	// ** INITIALIZE PRIVATE VARIABLES ** //
+	_file.setFileName( fileName );
+	_loop				= loop;
+	_sampleFormat		= FORMAT_PCM;
+	_fileChannelCount	= 0;
+	_bytesPerSample		= 0;
+	_dataOffset			= 0;
+	_dataSize			= 0;
+	_dataPosition		= 0;
+}
+
+
+QWavSoundInput::~QWavSoundInput( )
+{
+	// ** ENSURE THAT THE FILE IS CLOSED ** //
+	Q_ASSERT( ! _file.isOpen( ) );
+}
+
+
+QString QWavSoundInput::description( ) const
+{
+	return QString( "File: %1" ).arg( _file.fileName( ) );
+}
+
+
+unsigned int QWavSoundInput::openSource( const unsigned int /* sampleFrequency */ )
+{
+	// ** OPEN THE FILE ** //
+	if ( ! _file.open( QIODevice::ReadOnly ) ) {
+		throw QSoundInputException( QString( "Cannot open %1: %2" ).arg( _file.fileName( ), _file.errorString( ) ).toLocal8Bit( ).constData( ) );
+	}
+
+	// ** CHECK THE RIFF HEADER ** //
+	QByteArray header = _file.read( 12 );
+	if ( (header.size( ) != 12) || (memcmp( header.constData( ), "RIFF", 4 ) != 0) || (memcmp( header.constData( ) + 8, "WAVE", 4 ) != 0) ) {
+		_file.close( );
+		throw QSoundInputException( QString( "%1 is not a WAV file" ).arg( _file.fileName( ) ).toLocal8Bit( ).constData( ) );
+	}
+
+	// ** PARSE THE CHUNKS TILL THE SAMPLES ** //
+	unsigned int sampleFrequency = 0;
+	unsigned int bitsPerSample = 0;
+	_dataSize = 0;
+	forever {
+		QByteArray chunkHeader = _file.read( 8 );
+		if ( chunkHeader.size( ) != 8 ) {
+			break;
+		}
+		const quint32 chunkSize = qFromLittleEndian<quint32>( (const uchar*) chunkHeader.constData( ) + 4 );
+
+		if ( memcmp( chunkHeader.constData( ), "fmt ", 4 ) == 0 ) {
+			// format of the samples
+			QByteArray format = _file.read( chunkSize + (chunkSize & 1) );
+			if ( (chunkSize < 16) || ((quint32) format.size( ) < chunkSize) ) {
+				break;
+			}
+			const uchar* data	= (const uchar*) format.constData( );
+			_sampleFormat		= qFromLittleEndian<quint16>( data );
+			_fileChannelCount	= qFromLittleEndian<quint16>( data + 2 );
+			sampleFrequency		= qFromLittleEndian<quint32>( data + 4 );
+			bitsPerSample		= qFromLittleEndian<quint16>( data + 14 );
+			if ( (_sampleFormat == FORMAT_EXTENSIBLE) && (chunkSize >= 26) ) {
+				// the first two bytes of the subformat GUID are the actual format
+				_sampleFormat = qFromLittleEndian<quint16>( data + 24 );
+			}
+		} else if ( memcmp( chunkHeader.constData( ), "data", 4 ) == 0 ) {
+			// samples (a truncated file is accepted)
+			_dataOffset	= _file.pos( );
+			_dataSize	= qMin( (qint64) chunkSize, _file.size( ) - _dataOffset );
+			break;
+		} else {
+			// skip the unknown chunks (the chunks are word aligned)
+			_file.seek( _file.pos( ) + chunkSize + (chunkSize & 1) );
+		}
+	}
+
+	// ** CHECK THE FORMAT ** //
+	_bytesPerSample = bitsPerSample / 8;
+	const bool validPcm		= (_sampleFormat == FORMAT_PCM) && (bitsPerSample % 8 == 0) && (_bytesPerSample >= 1) && (_bytesPerSample <= 4);
+	const bool validFloat	= (_sampleFormat == FORMAT_IEEE_FLOAT) && (bitsPerSample == 32);
+	if ( (! validPcm && ! validFloat) || (_fileChannelCount == 0) || (sampleFrequency == 0) || (_dataSize == 0) ) {
+		_file.close( );
+		throw QSoundInputException( QString( "Unsupported WAV format in %1" ).arg( _file.fileName( ) ).toLocal8Bit( ).constData( ) );
+	}
+
+	// ** DELIVER AT MOST THE CHANNELS OF THE FILE ** //
+	_channelCount = qMin( _channelCount, _fileChannelCount );
+
+	// ** MOVE TO THE FIRST SAMPLE ** //
+	_file.seek( _dataOffset );
+	_dataPosition = 0;
+
+	qDebug( ) << "QWavSoundInput::openSource";
+	qDebug( ) << " - fileName                = " << _file.fileName( );
+	qDebug( ) << " - sampleFrequency         = " << sampleFrequency;
+	qDebug( ) << " - channelCount            = " << _fileChannelCount << " (" << _channelCount << " delivered)";
+	qDebug( ) << " - bitsPerSample           = " << bitsPerSample << "\n";
+
+	return sampleFrequency;
+}
+
+
+void QWavSoundInput::closeSource( )
+{
+	_file.close( );
+}
+
+
+unsigned int QWavSoundInput::readSource( short int* buffer, const unsigned int frameCount )
+{
+	const qint64 blockSize = _fileChannelCount * _bytesPerSample;
+
+	// ** RESTART THE FILE AT ITS END IF REQUIRED ** //
+	if ( _loop && ((_dataSize - _dataPosition) < blockSize) ) {
+		_file.seek( _dataOffset );
+		_dataPosition = 0;
+	}
+
+	// ** READ THE INTERLEAVED SAMPLES ** //
+	const qint64 blockCount = qMin( (qint64) frameCount, (_dataSize - _dataPosition) / blockSize );
+	_readBuffer.resize( (int)( blockCount * blockSize ) );
+	const qint64 readSize = _file.read( _readBuffer.data( ), blockCount * blockSize );
+	if ( readSize <= 0 ) {
+		return 0;
+	}
+	_dataPosition += readSize;
+
+	const unsigned int readFrames = (unsigned int)( readSize / blockSize );
+	const uchar* data = (const uchar*) _readBuffer.constData( );
+	if ( _channelCount == 1 ) {
+		// ** DOWNMIX TO MONO ** //
+		for ( unsigned int k = 0 ; k < readFrames ; ++k ) {
+			int sample = 0;
+			for ( unsigned int c = 0 ; c < _fileChannelCount ; ++c, data += _bytesPerSample ) {
+				sample += convertSample( data );
+			}
+			buffer[k] = (short int)( sample / (int) _fileChannelCount );
+		}
+	} else {
+		// ** KEEP THE FIRST CHANNELS ** //
+		for ( unsigned int k = 0 ; k < readFrames ; ++k, data += blockSize ) {
+			for ( unsigned int c = 0 ; c < _channelCount ; ++c ) {
+				buffer[k * _channelCount + c] = (short int) convertSample( data + c * _bytesPerSample );
+			}
+		}
+	}
+
+	return readFrames;
+}
+
+
+int QWavSoundInput::convertSample( const uchar* data ) const
+{
+	// ** FLOATING POINT SAMPLES ** //
+	if ( _sampleFormat == FORMAT_IEEE_FLOAT ) {
+		quint32 bits = qFromLittleEndian<quint32>( data );
+		float value;
+		memcpy( &value, &bits, sizeof( value ) );
+		return (int)( qBound( -1.0f, value, 1.0f ) * 32767.0f );
+	}
+
+	// ** INTEGER SAMPLES (8 BIT SAMPLES ARE UNSIGNED) ** //
+	switch ( _bytesPerSample ) {
+		case 1:
+			return ( (int) data[0] - 128 ) << 8;
+		case 2:
+			return qFromLittleEndian<qint16>( data );
+		case 3:
+			return (qint16)( data[1] | (data[2] << 8) );
+		default:
+			return qFromLittleEndian<qint32>( data ) >> 16;
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QWAVSOUNDINPUT_H_
+#define __QWAVSOUNDINPUT_H_
+
+#include "qstreamsoundinput.h"
+
+#include <QFile>
+
+
+//! Sound input read from a WAV file.
+/*!
+ * This class reads the audio stream from a RIFF/WAVE file with integer
+ * PCM samples (8, 16, 24 or 32 bit) or IEEE float samples (32 bit).
+ * Multichannel files are downmixed to mono unless several channels are
+ * requested, in which case the first channels of the file are delivered
+ * unchanged; the sample rate of the stream is the one of the file. At the end of the file the stream is
+ * either terminated or restarted from the beginning.
+ */
+
+class QWavSoundInput : public QStreamSoundInput {
+	Q_OBJECT
+
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] fileName the name of the WAV file
+	 * \param[in] loop true to restart the file when its end is reached
+	 * \param[in] parent a QObject* with the handle of the parent
+	 */
+	QWavSoundInput( const QString& fileName, const bool loop = false, QObject* parent = 0 );
+
+	//! Default destructor.
+	~QWavSoundInput( );
+
+	//! Retrieve the name of the file.
+	virtual QString description( ) const;
+
+
+protected: /* methods */
+	//! Open the file and parse its header.
+	/*!
+	 * \param[in] sampleFrequency the requested sample rate (ignored)
+	 * \return the sample rate of the file
+	 */
+	virtual unsigned int openSource( const unsigned int sampleFrequency );
+
+	//! Close the file.
+	virtual void closeSource( );
+
+	//! Read the next samples from the file, converting them to mono 16 bit.
+	/*!
+	 * \param[out] buffer the array used to store the samples
+	 * \param[in] frameCount the size of the array
+	 * \return the number of samples read (0 at the end of the file)
+	 */
+	virtual unsigned int readSource( short int* buffer, const unsigned int frameCount );
+
+
+private: /* enumerations */
+	//! Format of the samples stored in the file.
+	enum SampleFormat {
+		FORMAT_PCM			= 1,								//!< Integer PCM samples
+		FORMAT_IEEE_FLOAT	= 3,								//!< IEEE floating point samples
+		FORMAT_EXTENSIBLE	= 0xFFFE							//!< Format given by the subformat of the extended header
+	};
+
+
+private: /* members */
+	QFile				_file;									//!< The WAV file
+	bool				_loop;									//!< True when the file is restarted at its end
+	unsigned int		_sampleFormat;							//!< Format of the samples (PCM or float)
+	unsigned int		_fileChannelCount;						//!< Number of interleaved channels in the file
+	unsigned int		_bytesPerSample;						//!< Number of bytes of each sample of a channel
+	qint64				_dataOffset;							//!< Position of the first sample in the file
+	qint64				_dataSize;								//!< Size of the samples in bytes
+	qint64				_dataPosition;							//!< Position of the next sample relative to the first one
+	QByteArray			_readBuffer;							//!< Buffer used to read the interleaved samples
+
+
+private: /* methods */
+	//! Convert one sample of a channel to a 16 bit integer.
+	/*!
+	 * \param[in] data the pointer to the little endian sample
+	 * \return the sample scaled to the range of a 16 bit integer
+	 */
+	int convertSample( const uchar* data ) const;
+};
+
+#endif /* __QWAVSOUNDINPUT_H_ */
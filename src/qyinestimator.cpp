@@ -0,0 +1,98 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "qyinestimator.h"
+
+#include <cstring>
+
+
+// ** INITIALIZATION OF STATIC VARIABLES ** //
+const double QYinEstimator::ABSOLUTE_THRESHOLD	= 0.15;
+
+
+QYinEstimator::QYinEstimator( const unsigned int frameSize, const double sampleFrequency ) :
+	QDifferenceEstimator( frameSize, sampleFrequency )
+{
+	return;
+}
+
+
+double QYinEstimator::estimate( const qfftw_real* frame )
+{
+	// ** COMPUTE THE TERMS OF THE DIFFERENCE FUNCTION ** //
+	fftw_differenceTerms( frame );
+
+	QPITCH_STAGE_BEGIN( );
+
+	// ** COMPUTE THE CUMULATIVE MEAN NORMALIZED DIFFERENCE FUNCTION ** //
+	// the IFFT is not normalized, so the correlation is scaled by the size of the frame
+	// (the function is stored as 1 - d'[t] in the external buffer)
+	const double scale = 2.0 / _fftw_in_time_size;
+	double differenceSum = 0.0;
+
+	_fftw_in_time[0] = 0.0;
+	for ( unsigned int t = 1 ; t < _window_size ; ++t ) {
+		const double difference = qMax( _energy[t] - scale * _fftw_in_time[t], 0.0 );
+		differenceSum += difference;
+		_fftw_in_time[t] = (differenceSum > 0.0) ? 1.0 - difference * t / differenceSum : 0.0;
+	}
+	memset( _fftw_in_time + _window_size, 0, (_fftw_in_time_size - _window_size) * sizeof( qfftw_real ) );
+	QPITCH_STAGE_END( STAGE_MINIMUM_SEARCH );
+
+	// ** FIND THE FIRST DIP BELOW THE THRESHOLD ** //
+	// the lags 0 and 1 are rejected since d'[1] is always 1
+	const double	peakThreshold	= 1.0 - ABSOLUTE_THRESHOLD;
+	const unsigned int lastLag		= _window_size - 1;
+	unsigned int	t;
+	for ( t = 2 ; (t < lastLag) && (_fftw_in_time[t] <= peakThreshold) ; ++t ) {};
+
+	if ( t < lastLag ) {
+		// follow the dip to its bottom
+		for (  ; (t < lastLag) && (_fftw_in_time[t+1] > _fftw_in_time[t]) ; ++t ) {};
+	} else {
+		/*
+		 * no dip crosses the threshold (e.g. a noisy signal): the deepest
+		 * dip may be at a multiple of the period, so take the first dip
+		 * whose depth is within the threshold from the deepest one
+		 */
+		double maxPeak = _fftw_in_time[2];
+		for ( unsigned int k = 3 ; k < lastLag ; ++k ) {
+			maxPeak = qMax( maxPeak, (double) _fftw_in_time[k] );
+		}
+
+		for ( t = 2 ; (t < lastLag) && (_fftw_in_time[t] < maxPeak - ABSOLUTE_THRESHOLD) ; ++t ) {};
+		for (  ; (t < lastLag) && (_fftw_in_time[t+1] > _fftw_in_time[t]) ; ++t ) {};
+	}
+
+	// refine the position of the dip
+	double height;
+	const double lag = (t < lastLag) ? parabolicPeak( _fftw_in_time, t, height ) : 0.0;
+	QPITCH_STAGE_END( STAGE_MAXIMUM_SEARCH );
+
+	// no dip within the window means no periodicity
+	if ( lag <= 0.0 ) {
+		return 0.0;
+	}
+
+	// compute the frequency of the period
+	return ( _sampleFrequency / lag );
+}
@@ -0,0 +1,67 @@
+/*
+ * QPitch 1.0.1 - Simple chromatic tuner
+ * Copyright (C) 1999-2009 William Spinelli <wylliam@tiscali.it>
+ *                         Florian Berger <harpin_floh@yahoo.de>
+ *                         Reinier Lamers <tux_rocker@planet.nl>
+ *                         Pierre Dumuid
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __QYINESTIMATOR_H_
+#define __QYINESTIMATOR_H_
+
+#include "qdifferenceestimator.h"
+
+
+//! Pitch detection based on the YIN algorithm.
+/*!
+ * The difference function is normalized by its cumulative mean
+ *
+ * d'[t] = d[t] * t / sum( d[j] ), j = 1 .. t        (d'[0] = 1)
+ *
+ * which removes the dip at the lag 0 and the bias toward short lags,
+ * and the period is the first dip of d'[t] below an absolute threshold
+ * (or the deepest one when no dip crosses it), refined with a parabolic
+ * interpolation. Unlike the autocorrelation the first dip is preferred
+ * to deeper ones at multiples of the period, which avoids most of the
+ * sub-harmonic errors.
+ * The function of the lag exposed for the visualization is 1 - d'[t],
+ * so that the period is a peak as for the autocorrelation.
+ */
+
+class QYinEstimator : public QDifferenceEstimator {
+
+public: /* methods */
+	//! Default constructor.
+	/*!
+	 * \param[in] frameSize the size of the frame used to compute the FFT
+	 * \param[in] sampleFrequency the sample rate of the input stream
+	 */
+	QYinEstimator( const unsigned int frameSize, const double sampleFrequency );
+
+	//! Estimate the pitch of the frame finding the first dip of the normalized difference function.
+	/*!
+	 * \param[in] frame the frameSize samples to analyse (read in place)
+	 * \return the frequency value corresponding to the period
+	 */
+	virtual double estimate( const qfftw_real* frame );
+
+
+private: /* static constants */
+	static const double	ABSOLUTE_THRESHOLD;						//!< Threshold of the normalized difference function below which a dip is the period
+};
+
+#endif /* __QYINESTIMATOR_H_ */